@@ -9,6 +9,8 @@
 #include "EmulationSettings.h"
 #include "SoundMixer.h"
 #include "MemoryManager.h"
+#include "BaseMapper.h"
+#include "FrameProfiler.h"
 
 APU::APU(shared_ptr<Console> console)
 {
@@ -144,6 +146,7 @@ void APU::Run()
 	//-At the end of a frame
 	//-Before APU registers are read/written to
 	//-When a DMC or FrameCounter interrupt needs to be fired
+	PROFILE_SCOPE(_console->GetFrameProfiler(), Apu);
 	int32_t cyclesToRun = _currentCycle - _previousCycle;
 
 	while(cyclesToRun > 0) {
@@ -184,7 +187,14 @@ bool APU::NeedToRun(uint32_t currentCycle)
 
 void APU::Exec()
 {
+	if(_expansionAudioReferenceMode) {
+		//Clocks the expansion audio chip on every cycle, before the cycle is counted - like the mappers did before the chips could catch up (used to validate the catch-up logic)
+		_console->GetMapper()->ClockExpansionAudio();
+	}
+
 	_currentCycle++;
+	_cycleCount++;
+
 	if(_currentCycle == SoundMixer::CycleLength - 1) {
 		EndFrame();
 	} else if(NeedToRun(_currentCycle)) {
@@ -201,6 +211,9 @@ void APU::EndFrame()
 	_noiseChannel->EndFrame();
 	_deltaModulationChannel->EndFrame();
 
+	//Expansion audio chips run lazily, catch up to the end of the frame before mixing
+	_console->GetMapper()->RunExpansionAudio();
+
 	_mixer->PlayAudioBuffer(_currentCycle);
 
 	_currentCycle = 0;
@@ -247,9 +260,9 @@ void APU::StreamState(bool saving)
 	Stream(_nesModel, squareChannel0, squareChannel1, triangleChannel, noiseChannel, deltaModulationChannel, frameCounter, mixer);
 }
 
-void APU::AddExpansionAudioDelta(AudioChannel channel, int16_t delta)
+void APU::AddExpansionAudioDelta(AudioChannel channel, int16_t delta, uint32_t cycle)
 {
-	_mixer->AddDelta(channel, _currentCycle, delta);
+	_mixer->AddDelta(channel, cycle, delta);
 }
 
 void APU::SetApuStatus(bool enabled)
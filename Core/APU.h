@@ -28,6 +28,12 @@ class APU : public Snapshotable, public IMemoryHandler
 		uint32_t _previousCycle;
 		uint32_t _currentCycle;
 
+		//Number of cycles run since power on (not reset at the end of each frame) - only used to keep the expansion audio chips in sync
+		uint64_t _cycleCount = 0;
+
+		//When set, the expansion audio chip runs on every cycle instead of catching up when needed (benchmark/validation only)
+		bool _expansionAudioReferenceMode = false;
+
 		unique_ptr<SquareChannel> _squareChannel[2];
 		unique_ptr<TriangleChannel> _triangleChannel;
 		unique_ptr<NoiseChannel> _noiseChannel;
@@ -68,10 +74,13 @@ class APU : public Snapshotable, public IMemoryHandler
 		void Run();
 		void EndFrame();
 
-		void AddExpansionAudioDelta(AudioChannel channel, int16_t delta);
+		void AddExpansionAudioDelta(AudioChannel channel, int16_t delta, uint32_t cycle);
+		uint32_t GetCurrentCycle() { return _currentCycle; }
+		uint64_t GetCycleCount() { return _cycleCount; }
 		void SetApuStatus(bool enabled);
 		bool IsApuEnabled();
 		uint16_t GetDmcReadAddress();
 		void SetDmcReadBuffer(uint8_t value);
 		void SetNeedToRun();
+		void SetExpansionAudioReferenceMode(bool enabled) { _expansionAudioReferenceMode = enabled; }
 };
\ No newline at end of file
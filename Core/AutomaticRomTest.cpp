@@ -106,7 +106,7 @@ int32_t AutomaticRomTest::Run(string filename)
 	_console.reset(new Console());
 	EmulationSettings* settings = _console->GetSettings();
 	settings->SetMasterVolume(0);
-	_console->GetNotificationManager()->RegisterNotificationListener(shared_from_this());
+	_console->GetNotificationManager()->RegisterNotificationListener(shared_from_this(), { ConsoleNotificationType::PpuFrameDone });
 	if(_console->Initialize(filename)) {
 		_console->GetControlManager()->RegisterInputProvider(this);
 
@@ -123,15 +123,19 @@ protected:
 
 	void ProcessCpuClock() override
 	{
+		//The counter is only updated when its value is needed (on the cycle the IRQ occurs, before writes to the IRQ registers and when saving a state)
+		uint32_t cycles = TakePendingCpuClocks();
 		if(_irqEnabled) {
 			//Checking counter before decrementing seems to be the only way to get both
 			//Famicom Jump II - Saikyou no 7 Nin (J) and Magical Taruruuto-kun 2 - Mahou Daibouken (J)
 			//to work without glitches with the same code.
-			if(_irqCounter == 0) {
+			if(cycles > _irqCounter) {
 				_console->GetCpu()->SetIrqSource(IRQSource::External);
 			}
-			_irqCounter--;
+			_irqCounter -= cycles;
 		}
+
+		SetCpuClockPeriod(_irqEnabled ? _irqCounter + 1 : 0);
 	}
 
 	uint8_t ReadRegister(uint16_t addr) override
@@ -153,6 +157,12 @@ protected:
 
 	void WriteRegister(uint16_t addr, uint8_t value) override
 	{
+		bool irqRegister = (addr & 0x000F) >= 0x0A && (addr & 0x000F) <= 0x0C;
+		if(irqRegister) {
+			//Catch up to the current cycle before changing the IRQ counter
+			ProcessCpuClock();
+		}
+
 		switch(addr & 0x000F) {
 			case 0x00: case 0x01: case 0x02: case 0x03: case 0x04: case 0x05: case 0x06: case 0x07:
 				_chrRegs[addr & 0x07] = value;
@@ -231,5 +241,10 @@ protected:
 				}
 				break;
 		}
+
+		if(irqRegister) {
+			//Schedule the next IRQ
+			ProcessCpuClock();
+		}
 	}
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "BaseExpansionAudio.h"
 #include "Console.h"
 #include "APU.h"
+#include "FrameProfiler.h"
 
 BaseExpansionAudio::BaseExpansionAudio(shared_ptr<Console> console)
 {
@@ -10,11 +11,60 @@ BaseExpansionAudio::BaseExpansionAudio(shared_ptr<Console> console)
 
 void BaseExpansionAudio::StreamState(bool saving)
 {
+	if(saving) {
+		Run();
+	} else {
+		_lastApuCycleCount = _console->GetApu()->GetCycleCount();
+	}
+}
+
+void BaseExpansionAudio::SetClockEnabled(bool enabled)
+{
+	Run();
+	_clockEnabled = enabled;
+}
+
+void BaseExpansionAudio::Run()
+{
+	//The chip only runs when its state is needed, it runs for as many cycles as the APU did (no cycles elapse while the APU is disabled)
+	uint64_t apuCycleCount = _console->GetApu()->GetCycleCount();
+	_pendingCycles = (uint32_t)(apuCycleCount - _lastApuCycleCount);
+	_lastApuCycleCount = apuCycleCount;
+	if(_pendingCycles == 0 || !_clockEnabled) {
+		_pendingCycles = 0;
+		return;
+	}
+
+	PROFILE_SCOPE(_console->GetFrameProfiler(), ExpansionAudio);
+
+	//Each pending cycle matches one of the APU cycles that elapsed since the last call, the output changes are added at the APU cycle they occurred on
+	uint32_t apuCycle = _console->GetApu()->GetCurrentCycle();
+	_currentCycle = apuCycle > _pendingCycles ? apuCycle - _pendingCycles : 0;
+	RunAudio(_pendingCycles);
+	_pendingCycles = 0;
 }
 
 void BaseExpansionAudio::Clock()
 {
-	if(_console->GetApu()->IsApuEnabled()) {
+	//The APU calls this before counting the current cycle - mark it as run so that Run() doesn't run it a second time
+	_lastApuCycleCount = _console->GetApu()->GetCycleCount() + 1;
+	if(_clockEnabled) {
 		ClockAudio();
 	}
+}
+
+void BaseExpansionAudio::RunAudio(uint32_t cycleCount)
+{
+	for(uint32_t i = 0; i < cycleCount; i++) {
+		ClockAudio();
+		_currentCycle++;
+	}
+}
+
+void BaseExpansionAudio::AddAudioDelta(AudioChannel channel, int16_t delta)
+{
+	//Changes caused by register writes (outside of Run) occur on the current cycle
+	APU* apu = _console->GetApu();
+	uint32_t apuCycle = apu->GetCurrentCycle();
+	apu->AddExpansionAudioDelta(channel, delta, _pendingCycles > 0 ? std::min(_currentCycle, apuCycle) : apuCycle);
 }
\ No newline at end of file
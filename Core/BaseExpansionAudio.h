@@ -7,14 +7,34 @@ class MemoryManager;
 
 class BaseExpansionAudio : public Snapshotable
 {
+private:
+	uint64_t _lastApuCycleCount = 0;
+	uint32_t _pendingCycles = 0;
+	uint32_t _currentCycle = 0;
+	bool _clockEnabled = true;
+
 protected: 
 	shared_ptr<Console> _console = nullptr;
 
 	virtual void ClockAudio() = 0;
 	void StreamState(bool saving) override;
 
+	//Runs the given number of cycles - calls ClockAudio for each cycle, chips that can process several cycles at once override this
+	virtual void RunAudio(uint32_t cycleCount);
+	void AdvanceCycle(uint32_t cycleCount) { _currentCycle += cycleCount; }
+
+	void AddAudioDelta(AudioChannel channel, int16_t delta);
+
 public:
 	BaseExpansionAudio(shared_ptr<Console> console);
 
+	//Runs the APU cycles that elapsed since the last call - must be called before any register read/write and at the end of each audio frame
+	void Run();
+
+	//When disabled (e.g chip not present on the board), the elapsed cycles are skipped instead of being run
+	void SetClockEnabled(bool enabled);
+
+	//Reference implementation, used to validate Run: clocks the chip for the current cycle only, by calling ClockAudio (the way the chips ran before they could catch up)
+	//Called by the APU on every cycle when its expansion audio reference mode is enabled
 	void Clock();
 };
\ No newline at end of file
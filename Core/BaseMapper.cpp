@@ -120,6 +120,10 @@ void BaseMapper::SetCpuMemoryMapping(uint16_t startAddr, uint16_t endAddr, int16
 
 void BaseMapper::SetCpuMemoryMapping(uint16_t startAddr, uint16_t endAddr, PrgMemoryType type, uint32_t sourceOffset, int8_t accessType)
 {
+	if(type == PrgMemoryType::PrgRom && accessType != -1 && (accessType & MemoryAccessType::Write)) {
+		UnsharePrgRom();
+	}
+
 	uint8_t* source = nullptr;
 	switch(type) {
 		default:
@@ -150,6 +154,7 @@ void BaseMapper::SetCpuMemoryMapping(uint16_t startAddr, uint16_t endAddr, uint8
 	for(uint16_t i = startAddr; i <= endAddr; i++) {
 		_prgPages[i] = source;
 		_prgMemoryAccess[i] = accessType != -1 ? (MemoryAccessType)accessType : MemoryAccessType::Read;
+		GetDirtyPageFlags(source, _prgDirtyFlags[i], _prgDirtyOffset[i]);
 
 		source += 0x100;
 	}
@@ -262,6 +267,12 @@ void BaseMapper::SetPpuMemoryMapping(uint16_t startAddr, uint16_t endAddr, ChrMe
 		case ChrMemoryType::ChrRam: sourceMemory = _chrRam; break;
 		case ChrMemoryType::NametableRam: sourceMemory = _nametableRam; break;
 	}
+
+	if(type == ChrMemoryType::ChrRom && (accessType == -1 || (accessType & MemoryAccessType::Write))) {
+		UnshareChrRom();
+		sourceMemory = _chrRom;
+	}
+
 	int firstSlot = startAddr >> 8;
 	int slotCount = (endAddr - startAddr + 1) >> 8;
 	for(int i = 0; i < slotCount; i++) {
@@ -284,6 +295,7 @@ void BaseMapper::SetPpuMemoryMapping(uint16_t startAddr, uint16_t endAddr, uint8
 	for(uint16_t i = startAddr; i <= endAddr; i++) {
 		_chrPages[i] = sourceMemory;
 		_chrMemoryAccess[i] = accessType != -1 ? (MemoryAccessType)accessType : MemoryAccessType::ReadWrite;
+		GetDirtyPageFlags(sourceMemory, _chrDirtyFlags[i], _chrDirtyOffset[i]);
 
 		if(sourceMemory != nullptr) {
 			sourceMemory += 0x100;
@@ -445,6 +457,7 @@ void BaseMapper::InitializeChrRam(int32_t chrRamSize)
 	if(_chrRamSize > 0) {
 		_chrRam = new uint8_t[_chrRamSize];
 		_console->InitializeRam(_chrRam, _chrRamSize);
+		_chrRamPages.Init(_chrRam, _chrRamSize);
 	}
 }
 
@@ -494,13 +507,20 @@ void BaseMapper::RemoveRegisterRange(uint16_t startAddr, uint16_t endAddr, Memor
 
 void BaseMapper::StreamState(bool saving)
 {
+	if(saving && _pendingCpuClocks > 0) {
+		//Mappers that schedule their ProcessCpuClock calls need to catch up to the current cycle before their state is saved
+		ProcessCpuClock();
+	}
+
 	//Need to get the number of nametables in the state first, before we try to stream the nametable ram array
 	Stream(_nametableCount);
 
-	ArrayInfo<uint8_t> chrRam = { _chrRam, _chrRamSize };
-	ArrayInfo<uint8_t> workRam = { _workRam, _workRamSize };
-	ArrayInfo<uint8_t> saveRam = { _saveRam, _saveRamSize };
-	ArrayInfo<uint8_t> nametableRam = { _nametableRam, _nametableCount * BaseMapper::NametableSize };
+	//When the RAM is saved as a PageSnapshot, its arrays are streamed with a size of 0
+	bool excludeRam = _console->IsRamExcludedFromState();
+	ArrayInfo<uint8_t> chrRam = { _chrRam, excludeRam ? 0 : _chrRamSize };
+	ArrayInfo<uint8_t> workRam = { _workRam, excludeRam ? 0 : _workRamSize };
+	ArrayInfo<uint8_t> saveRam = { _saveRam, excludeRam ? 0 : _saveRamSize };
+	ArrayInfo<uint8_t> nametableRam = { _nametableRam, excludeRam ? 0 : _nametableCount * BaseMapper::NametableSize };
 
 	ArrayInfo<int32_t> prgMemoryOffset = { _prgMemoryOffset, 0x100 };
 	ArrayInfo<int32_t> chrMemoryOffset = { _chrMemoryOffset, 0x40 };
@@ -513,6 +533,17 @@ void BaseMapper::StreamState(bool saving)
 
 	if(!saving) {
 		RestorePrgChrState();
+
+		//Let the mapper reschedule its next ProcessCpuClock call on the next cycle
+		_pendingCpuClocks = 0;
+		_cpuClockPeriod = 1;
+
+		if(!excludeRam) {
+			_chrRamPages.MarkAllDirty();
+			_workRamPages.MarkAllDirty();
+			_saveRamPages.MarkAllDirty();
+			_nametableRamPages.MarkAllDirty();
+		}
 	}
 }
 
@@ -561,17 +592,16 @@ void BaseMapper::Initialize(RomData &romData)
 	memset(_isWriteRegisterAddr, 0, sizeof(_isWriteRegisterAddr));
 	AddRegisterRange(RegisterStartAddress(), RegisterEndAddress(), MemoryOperation::Any);
 
-	_prgSize = (uint32_t)romData.PrgRom.size();
-	_chrRomSize = (uint32_t)romData.ChrRom.size();
-	_originalPrgRom = romData.PrgRom;
-	_originalChrRom = romData.ChrRom;
+	RomImageCache::ShareRomData(romData);
+	_prgRomImage = romData.PrgRomImage;
+	_chrRomImage = romData.ChrRomImage;
+	_prgSize = _prgRomImage ? (uint32_t)_prgRomImage->Data.size() : 0;
+	_chrRomSize = _chrRomImage ? (uint32_t)_chrRomImage->Data.size() : 0;
 
-	_prgRom = new uint8_t[_prgSize];
-	_chrRom = new uint8_t[_chrRomSize];
-	memcpy(_prgRom, romData.PrgRom.data(), _prgSize);
-	if(_chrRomSize > 0) {
-		memcpy(_chrRom, romData.ChrRom.data(), _chrRomSize);
-	}
+	_prgRomShared = _prgRomImage != nullptr;
+	_prgRom = _prgRomShared ? const_cast<uint8_t*>(_prgRomImage->Data.data()) : new uint8_t[0];
+	_chrRomShared = _chrRomImage != nullptr;
+	_chrRom = _chrRomShared ? const_cast<uint8_t*>(_chrRomImage->Data.data()) : new uint8_t[0];
 
 	_hasChrBattery = romData.SaveChrRamSize > 0 || ForceChrBattery();
 
@@ -595,17 +625,25 @@ void BaseMapper::Initialize(RomData &romData)
 	_nametableRam = new uint8_t[BaseMapper::NametableSize*BaseMapper::NametableCount];
 	_console->InitializeRam(_nametableRam, BaseMapper::NametableSize*BaseMapper::NametableCount);
 
+	_saveRamPages.Init(_saveRam, _saveRamSize);
+	_workRamPages.Init(_workRam, _workRamSize);
+	_nametableRamPages.Init(_nametableRam, BaseMapper::NametableSize*BaseMapper::NametableCount);
+
 	for(int i = 0; i < 0x100; i++) {
 		//Allow us to map a different page every 256 bytes
 		_prgPages[i] = nullptr;
 		_prgMemoryOffset[i] = -1;
 		_prgMemoryType[i] = PrgMemoryType::PrgRom;
 		_prgMemoryAccess[i] = MemoryAccessType::NoAccess;
+		_prgDirtyFlags[i] = &_untrackedPageFlag;
+		_prgDirtyOffset[i] = 0;
 
 		_chrPages[i] = nullptr;
 		_chrMemoryOffset[i] = -1;
 		_chrMemoryType[i] = ChrMemoryType::Default;
 		_chrMemoryAccess[i] = MemoryAccessType::NoAccess;
+		_chrDirtyFlags[i] = &_untrackedPageFlag;
+		_chrDirtyOffset[i] = 0;
 	}
 
 	if(_chrRomSize == 0) {
@@ -646,8 +684,12 @@ void BaseMapper::Initialize(RomData &romData)
 BaseMapper::~BaseMapper()
 {
 	delete[] _chrRam;
-	delete[] _chrRom;
-	delete[] _prgRom;
+	if(!_chrRomShared) {
+		delete[] _chrRom;
+	}
+	if(!_prgRomShared) {
+		delete[] _prgRom;
+	}
 	delete[] _saveRam;
 	delete[] _workRam;
 	delete[] _nametableRam;
@@ -805,15 +847,18 @@ void BaseMapper::DebugWriteRAM(uint16_t addr, uint8_t value)
 
 void BaseMapper::WritePrgRam(uint16_t addr, uint8_t value)
 {
-	if(_prgMemoryAccess[addr >> 8] & MemoryAccessType::Write) {
-		_prgPages[addr >> 8][(uint8_t)addr] = value;
+	uint8_t page = addr >> 8;
+	if(_prgMemoryAccess[page] & MemoryAccessType::Write) {
+		_prgPages[page][(uint8_t)addr] = value;
+		_prgDirtyFlags[page][(_prgDirtyOffset[page] + (uint8_t)addr) >> DirtyPageTracker::PageShift] = 1;
 	}
 }
 
 void BaseMapper::NotifyVRAMAddressChange(uint16_t addr)
 {
 	//This is called when the VRAM addr on the PPU memory bus changes
-	//Used by MMC3/MMC5/etc
+	//Used by MMC3/MMC5/etc - the PPU stops calling this for mappers that don't override it
+	_vramAddressListener = false;
 }
 
 uint8_t BaseMapper::InternalReadVRAM(uint16_t addr)
@@ -843,15 +888,22 @@ uint8_t BaseMapper::MapperReadVRAM(uint16_t addr, MemoryOperationType operationT
 void BaseMapper::DebugWriteVRAM(uint16_t addr, uint8_t value, bool disableSideEffects)
 {
 	addr &= 0x3FFF;
+	uint8_t page = addr >> 8;
 	if(disableSideEffects) {
-		if(_chrPages[addr >> 8]) {
+		if(_chrPages[page]) {
+			if(_chrRomShared && _chrPages[page] >= _chrRom && _chrPages[page] < _chrRom + _chrRomSize) {
+				UnshareChrRom();
+			}
+
 			//Always allow writes when side-effects are disabled
-			_chrPages[addr >> 8][(uint8_t)addr] = value;
+			_chrPages[page][(uint8_t)addr] = value;
+			_chrDirtyFlags[page][(_chrDirtyOffset[page] + (uint8_t)addr) >> DirtyPageTracker::PageShift] = 1;
 		}
 	} else {
 		NotifyVRAMAddressChange(addr);
-		if(_chrMemoryAccess[addr >> 8] & MemoryAccessType::Write) {
-			_chrPages[addr >> 8][(uint8_t)addr] = value;
+		if(_chrMemoryAccess[page] & MemoryAccessType::Write) {
+			_chrPages[page][(uint8_t)addr] = value;
+			_chrDirtyFlags[page][(_chrDirtyOffset[page] + (uint8_t)addr) >> DirtyPageTracker::PageShift] = 1;
 		}
 	}
 }
@@ -860,8 +912,10 @@ void BaseMapper::WriteVRAM(uint16_t addr, uint8_t value)
 {
 	_console->DebugProcessVramWriteOperation(addr, value);
 
-	if(_chrMemoryAccess[addr >> 8] & MemoryAccessType::Write) {
-		_chrPages[addr >> 8][(uint8_t)addr] = value;
+	uint8_t page = addr >> 8;
+	if(_chrMemoryAccess[page] & MemoryAccessType::Write) {
+		_chrPages[page][(uint8_t)addr] = value;
+		_chrDirtyFlags[page][(_chrDirtyOffset[page] + (uint8_t)addr) >> DirtyPageTracker::PageShift] = 1;
 	}
 }
 
@@ -906,10 +960,10 @@ void BaseMapper::WriteMemory(DebugMemoryType type, uint8_t* buffer, int32_t leng
 	int32_t size = std::min(length, (int32_t)GetMemorySize(type));
 	switch(type) {
 		default: break;
-		case DebugMemoryType::ChrRam: memcpy(_chrRam, buffer, size); break;
-		case DebugMemoryType::SaveRam: memcpy(_saveRam, buffer, size); break;
-		case DebugMemoryType::WorkRam: memcpy(_workRam, buffer, size); break;
-		case DebugMemoryType::NametableRam: memcpy(_nametableRam, buffer, size); break;
+		case DebugMemoryType::ChrRam: memcpy(_chrRam, buffer, size); _chrRamPages.MarkDirty(0, size); break;
+		case DebugMemoryType::SaveRam: memcpy(_saveRam, buffer, size); _saveRamPages.MarkDirty(0, size); break;
+		case DebugMemoryType::WorkRam: memcpy(_workRam, buffer, size); _workRamPages.MarkDirty(0, size); break;
+		case DebugMemoryType::NametableRam: memcpy(_nametableRam, buffer, size); _nametableRamPages.MarkDirty(0, size); break;
 	}
 }
 
@@ -926,6 +980,46 @@ uint32_t BaseMapper::GetMemorySize(DebugMemoryType type)
 	}
 }
 
+DirtyPageTracker* BaseMapper::FindDirtyPageTracker(uint8_t* ptr)
+{
+	DirtyPageTracker* trackers[4] = { &_saveRamPages, &_workRamPages, &_chrRamPages, &_nametableRamPages };
+	for(DirtyPageTracker* tracker : trackers) {
+		if(tracker->Contains(ptr)) {
+			return tracker;
+		}
+	}
+	return nullptr;
+}
+
+void BaseMapper::GetDirtyPageFlags(uint8_t* source, uint8_t* &flags, uint32_t &offset)
+{
+	DirtyPageTracker* tracker = source ? FindDirtyPageTracker(source) : nullptr;
+	if(!tracker && source) {
+		//VS DualSystem games map the master's work/save ram in the slave's CPU memory
+		shared_ptr<Console> dualConsole = _console->GetDualConsole();
+		if(dualConsole && dualConsole->GetMapper()) {
+			tracker = dualConsole->GetMapper()->FindDirtyPageTracker(source);
+		}
+	}
+
+	if(tracker) {
+		flags = tracker->GetDirtyFlags();
+		offset = (uint32_t)(source - tracker->GetMemory());
+	} else {
+		//ROM, or RAM that is saved as part of the mapper's own state
+		flags = &_untrackedPageFlag;
+		offset = 0;
+	}
+}
+
+void BaseMapper::GetDirtyPageTrackers(vector<DirtyPageTracker*> &trackers)
+{
+	trackers.push_back(&_saveRamPages);
+	trackers.push_back(&_workRamPages);
+	trackers.push_back(&_chrRamPages);
+	trackers.push_back(&_nametableRamPages);
+}
+
 void BaseMapper::CopyChrTile(uint32_t address, uint8_t *dest)
 {
 	if(_chrRamSize > 0 && address <= _chrRamSize - 16) {
@@ -966,12 +1060,12 @@ void BaseMapper::SetMemoryValue(DebugMemoryType memoryType, uint32_t address, ui
 
 		switch(memoryType) {
 			default: break;
-			case DebugMemoryType::ChrRom: _chrRom[address] = value; break;
-			case DebugMemoryType::ChrRam: _chrRam[address] = value; break;
-			case DebugMemoryType::SaveRam: _saveRam[address] = value; break;
-			case DebugMemoryType::PrgRom: _prgRom[address] = value; break;
-			case DebugMemoryType::WorkRam: _workRam[address] = value; break;
-			case DebugMemoryType::NametableRam: _nametableRam[address] = value; break;
+			case DebugMemoryType::ChrRom: UnshareChrRom(); _chrRom[address] = value; break;
+			case DebugMemoryType::ChrRam: _chrRam[address] = value; _chrRamPages.MarkDirty(address); break;
+			case DebugMemoryType::SaveRam: _saveRam[address] = value; _saveRamPages.MarkDirty(address); break;
+			case DebugMemoryType::PrgRom: UnsharePrgRom(); _prgRom[address] = value; break;
+			case DebugMemoryType::WorkRam: _workRam[address] = value; _workRamPages.MarkDirty(address); break;
+			case DebugMemoryType::NametableRam: _nametableRam[address] = value; _nametableRamPages.MarkDirty(address); break;
 		}
 	}
 }
@@ -1232,29 +1326,34 @@ vector<uint8_t> BaseMapper::GetPrgChrCopy()
 
 void BaseMapper::RestorePrgChrBackup(vector<uint8_t> &backupData)
 {
-	memcpy(_prgRom, backupData.data(), _prgSize);
-	if(!_onlyChrRam) {
+	if(_prgSize > 0 && (!_prgRomShared || memcmp(_prgRom, backupData.data(), _prgSize) != 0)) {
+		UnsharePrgRom();
+		memcpy(_prgRom, backupData.data(), _prgSize);
+	}
+	if(!_onlyChrRam && _chrRomSize > 0 && (!_chrRomShared || memcmp(_chrRom, backupData.data() + _prgSize, _chrRomSize) != 0)) {
+		UnshareChrRom();
 		memcpy(_chrRom, backupData.data() + _prgSize, _chrRomSize);
 	}
 }
 
 void BaseMapper::RevertPrgChrChanges()
 {
-	memcpy(_prgRom, _originalPrgRom.data(), _originalPrgRom.size());
-	if(_chrRom) {
-		memcpy(_chrRom, _originalChrRom.data(), _originalChrRom.size());
+	//The private copies are kept (rather than mapping the shared images again), some mappers keep a pointer to the PRG ROM
+	if(!_prgRomShared && _prgRomImage) {
+		memcpy(_prgRom, _prgRomImage->Data.data(), _prgRomImage->Data.size());
+	}
+	if(!_chrRomShared && _chrRomImage) {
+		memcpy(_chrRom, _chrRomImage->Data.data(), _chrRomImage->Data.size());
 	}
 }
 
 bool BaseMapper::HasPrgChrChanges()
 {
-	if(memcmp(_prgRom, _originalPrgRom.data(), _originalPrgRom.size()) != 0) {
+	if(!_prgRomShared && _prgRomImage && memcmp(_prgRom, _prgRomImage->Data.data(), _prgRomImage->Data.size()) != 0) {
 		return true;
 	}
-	if(_chrRom) {
-		if(memcmp(_chrRom, _originalChrRom.data(), _originalChrRom.size()) != 0) {
-			return true;
-		}
+	if(!_chrRomShared && _chrRomImage && memcmp(_chrRom, _chrRomImage->Data.data(), _chrRomImage->Data.size()) != 0) {
+		return true;
 	}
 	return false;
 }
@@ -1262,9 +1361,46 @@ bool BaseMapper::HasPrgChrChanges()
 void BaseMapper::CopyPrgChrRom(shared_ptr<BaseMapper> mapper)
 {
 	if(_prgSize == mapper->_prgSize && _chrRomSize == mapper->_chrRomSize) {
-		memcpy(_prgRom, mapper->_prgRom, _prgSize);
-		if(!_onlyChrRam) {
+		//Only copy the ROM when either mapper has its own copy, otherwise they already share the same image
+		if(!mapper->_prgRomShared || !_prgRomShared || mapper->_prgRomImage != _prgRomImage) {
+			UnsharePrgRom();
+			memcpy(_prgRom, mapper->_prgRom, _prgSize);
+		}
+		if(!_onlyChrRam && (!mapper->_chrRomShared || !_chrRomShared || mapper->_chrRomImage != _chrRomImage)) {
+			UnshareChrRom();
 			memcpy(_chrRom, mapper->_chrRom, _chrRomSize);
 		}
 	}
+}
+
+void BaseMapper::RelocatePages(uint8_t** pages, uint8_t* oldSource, uint8_t* newSource, uint32_t size)
+{
+	for(int i = 0; i < 0x100; i++) {
+		if(pages[i] >= oldSource && pages[i] < oldSource + size) {
+			pages[i] = newSource + (pages[i] - oldSource);
+		}
+	}
+}
+
+void BaseMapper::UnsharePrgRom()
+{
+	if(_prgRomShared) {
+		uint8_t* prgRom = new uint8_t[_prgSize];
+		memcpy(prgRom, _prgRom, _prgSize);
+		RelocatePages(_prgPages, _prgRom, prgRom, _prgSize);
+		_prgRom = prgRom;
+		_prgRomShared = false;
+	}
+}
+
+void BaseMapper::UnshareChrRom()
+{
+	if(_chrRomShared) {
+		uint32_t size = (uint32_t)_chrRomImage->Data.size();
+		uint8_t* chrRom = new uint8_t[size];
+		memcpy(chrRom, _chrRom, size);
+		RelocatePages(_chrPages, _chrRom, chrRom, size);
+		_chrRom = chrRom;
+		_chrRomShared = false;
+	}
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include "IBattery.h"
 #include "RomData.h"
 #include "Console.h"
+#include "DirtyPageTracker.h"
+#include "RomImageCache.h"
 
 class BaseControlDevice;
 
@@ -47,8 +49,31 @@ private:
 	int32_t _chrMemoryOffset[0x100];
 	ChrMemoryType _chrMemoryType[0x100];
 
-	vector<uint8_t> _originalPrgRom;
-	vector<uint8_t> _originalChrRom;
+	//Dirty page flags for each CPU/PPU page - a write to [addr] sets flags[(offset + (addr & 0xFF)) >> 8]
+	//Pages that are not mapped to tracked RAM point to _untrackedPageFlag
+	uint8_t* _prgDirtyFlags[0x100];
+	uint32_t _prgDirtyOffset[0x100];
+	uint8_t* _chrDirtyFlags[0x100];
+	uint32_t _chrDirtyOffset[0x100];
+	uint8_t _untrackedPageFlag = 0;
+
+	void GetDirtyPageFlags(uint8_t* source, uint8_t* &flags, uint32_t &offset);
+
+	//PRG/CHR ROM images shared with the other consoles running the same game
+	//_prgRom/_chrRom point to the image's data until something writes to the ROM (see UnsharePrgRom/UnshareChrRom)
+	shared_ptr<const RomImage> _prgRomImage;
+	shared_ptr<const RomImage> _chrRomImage;
+	bool _prgRomShared = false;
+	bool _chrRomShared = false;
+
+	void RelocatePages(uint8_t** pages, uint8_t* oldSource, uint8_t* newSource, uint32_t size);
+
+	//ProcessCpuClock is called once every _cpuClockPeriod CPU cycles (see SetCpuClockPeriod)
+	uint32_t _cpuClockPeriod = 1;
+	uint32_t _pendingCpuClocks = 0;
+
+	//Cleared by the default NotifyVRAMAddressChange, the PPU only notifies the mappers that need the VRAM address changes
+	bool _vramAddressListener = true;
 
 protected:
 	RomInfo _romInfo;
@@ -70,6 +95,11 @@ protected:
 	bool _hasChrBattery = false;
 	int16_t _vramOpenBusValue = -1;
 
+	DirtyPageTracker _saveRamPages;
+	DirtyPageTracker _workRamPages;
+	DirtyPageTracker _chrRamPages;
+	DirtyPageTracker _nametableRamPages;
+
 	virtual void InitMapper() = 0;
 	virtual void InitMapper(RomData &romData);
 	virtual uint16_t GetPRGPageSize() = 0;
@@ -137,6 +167,10 @@ protected:
 
 	void InitializeChrRam(int32_t chrRamSize = -1);
 
+	//Gives this console its own copy of the PRG/CHR ROM - must be called before writing to the ROM (e.g flash memory)
+	void UnsharePrgRom();
+	void UnshareChrRom();
+
 	void AddRegisterRange(uint16_t startAddr, uint16_t endAddr, MemoryOperation operation = MemoryOperation::Any);
 	void RemoveRegisterRange(uint16_t startAddr, uint16_t endAddr, MemoryOperation operation = MemoryOperation::Any);
 
@@ -164,8 +198,41 @@ public:
 	virtual ConsoleFeatures GetAvailableFeatures();
 
 	virtual void SetNesModel(NesModel model) { }
-	virtual void ProcessCpuClock() { }
+	virtual void ProcessCpuClock() { SetCpuClockPeriod(0); }
+	virtual void RunExpansionAudio() { }
+	//Only used by the APU's expansion audio reference mode (see BaseExpansionAudio::Clock)
+	virtual void ClockExpansionAudio() { }
 	virtual void NotifyVRAMAddressChange(uint16_t addr);
+
+	//Called by the console on every CPU cycle
+	__forceinline void ClockCpu()
+	{
+		if(++_pendingCpuClocks >= _cpuClockPeriod) {
+			ProcessCpuClock();
+			_pendingCpuClocks = 0;
+		}
+	}
+
+	__forceinline void ProcessVramAddressChange(uint16_t addr)
+	{
+		if(_vramAddressListener) {
+			NotifyVRAMAddressChange(addr);
+		}
+	}
+
+	//By default, ProcessCpuClock is called on every CPU cycle
+	//Mappers that only need it for an event (e.g an IRQ counter reaching 0) can set the number of cycles until the next call instead (0 = never)
+	//The event must be rescheduled whenever a register write changes when it occurs
+	void SetCpuClockPeriod(uint32_t cycles) { _cpuClockPeriod = cycles ? cycles : UINT32_MAX; }
+
+	//Returns the number of CPU cycles that elapsed since the last call to ProcessCpuClock (or to this function)
+	uint32_t TakePendingCpuClocks()
+	{
+		uint32_t cycles = _pendingCpuClocks;
+		_pendingCpuClocks = 0;
+		return cycles;
+	}
+
 	virtual void GetMemoryRanges(MemoryRanges &ranges) override;
 	
 	virtual void SaveBattery() override;
@@ -201,6 +268,9 @@ public:
 
 	void CopyChrTile(uint32_t address, uint8_t *dest);
 
+	DirtyPageTracker* FindDirtyPageTracker(uint8_t* ptr);
+	void GetDirtyPageTrackers(vector<DirtyPageTracker*> &trackers);
+
 	//Debugger Helper Functions
 	bool HasChrRam();
 	bool HasChrRom();
@@ -196,7 +196,7 @@ bool BizhawkMovie::Play(VirtualFile &file)
 
 	reader.LoadArchive(ss);
 	
-	_console->GetNotificationManager()->RegisterNotificationListener(shared_from_this());
+	_console->GetNotificationManager()->RegisterNotificationListener(shared_from_this(), { ConsoleNotificationType::GameLoaded });
 	_console->GetSettings()->SetRamPowerOnState(RamPowerOnState::AllOnes);
 	_console->GetBatteryManager()->SetBatteryProvider(shared_from_this());
 	if(InitializeInputData(reader) && InitializeGameData(reader)) {
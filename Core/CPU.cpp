@@ -8,6 +8,7 @@
 #include "Debugger.h"
 #include "NsfMapper.h"
 #include "Console.h"
+#include "FrameProfiler.h"
 
 CPU::CPU(shared_ptr<Console> console)
 {
@@ -164,6 +165,7 @@ void CPU::Exec()
 	_instAddrMode = _addrMode[opCode];
 	_operand = FetchOperand();
 	(this->*_opTable[opCode])();
+	_instructionCount++;
 	
 	if(_prevRunIrq || _prevNeedNmi) {
 		IRQ();
@@ -319,7 +321,10 @@ uint16_t CPU::FetchOperand()
 void CPU::EndCpuCycle(bool forRead)
 {
 	_masterClock += forRead ? (_endClockCount + 1) : (_endClockCount - 1);
-	_console->GetPpu()->Run(_masterClock - _ppuOffset);
+	{
+		PROFILE_SAMPLED_SCOPE(_console->GetFrameProfiler(), PpuRun);
+		_console->GetPpu()->Run(_masterClock - _ppuOffset);
+	}
 
 	//"The internal signal goes high during φ1 of the cycle that follows the one where the edge is detected,
 	//and stays high until the NMI has been handled. "
@@ -343,7 +348,10 @@ void CPU::StartCpuCycle(bool forRead)
 {
 	_masterClock += forRead ? (_startClockCount - 1) : (_startClockCount + 1);
 	_cycleCount++;
-	_console->GetPpu()->Run(_masterClock - _ppuOffset);
+	{
+		PROFILE_SAMPLED_SCOPE(_console->GetFrameProfiler(), PpuRun);
+		_console->GetPpu()->Run(_masterClock - _ppuOffset);
+	}
 	_console->ProcessCpuClock();
 }
 
@@ -32,6 +32,7 @@ private:
 	typedef void(CPU::*Func)();
 
 	uint64_t _cycleCount;
+	uint64_t _instructionCount = 0;
 	uint64_t _masterClock;
 	uint8_t _ppuOffset;
 	uint8_t _startClockCount;
@@ -788,6 +789,10 @@ public:
 	CPU(shared_ptr<Console> console);
 	
 	uint64_t GetCycleCount() { return _cycleCount; }
+
+	//Number of instructions executed so far (not saved in save states, only used to measure performance)
+	uint64_t GetInstructionCount() { return _instructionCount; }
+
 	void SetMasterClockDivider(NesModel region);
 	void SetNmiFlag() { _state.NMIFlag = true; }
 	void ClearNmiFlag() { _state.NMIFlag = false; }
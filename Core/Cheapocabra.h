@@ -25,6 +25,8 @@ protected:
 	{
 		AddRegisterRange(0x7000, 0x7FFF, MemoryOperation::Write);
 
+		//The flash memory writes directly to the PRG ROM
+		UnsharePrgRom();
 		_flash.reset(new FlashSST39SF040(_prgRom, _prgSize));
 		AddRegisterRange(0x8000, 0xFFFF, MemoryOperation::Any);
 		RemoveRegisterRange(0x5000, 0x5FFF, MemoryOperation::Read);
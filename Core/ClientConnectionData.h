@@ -11,6 +11,14 @@ public:
 	string PlayerName;
 	bool Spectator;
 
+	//0 = delay-based netplay, otherwise max number of frames that can be predicted/rolled back
+	uint32_t RollbackFrames = 0;
+
+	//Used to test netplay over loopback - delays received messages by the specified amount of time (ms),
+	//and simulates packet loss (retransmission delays) for the specified % of messages
+	uint32_t SimulatedLatency = 0;
+	uint32_t SimulatedPacketLoss = 0;
+
 	ClientConnectionData() {}
 
 	ClientConnectionData(string host, uint16_t port, string password, string playerName, bool spectator) :
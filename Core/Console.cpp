@@ -40,12 +40,20 @@
 #include "BatteryManager.h"
 #include "DebugHud.h"
 #include "RomLoader.h"
+#include "RomHashIndex.h"
 #include "CheatManager.h"
 #include "VideoDecoder.h"
 #include "VideoRenderer.h"
 #include "DebugHud.h"
 #include "NotificationManager.h"
 #include "HistoryViewer.h"
+#include "RollbackManager.h"
+#include "StateChecksumLog.h"
+#include "FrameProfiler.h"
+#include "HeadlessInputProvider.h"
+#include "PageSnapshotManager.h"
+#include "GameServer.h"
+#include "GameClient.h"
 #include "ConsolePauseHelper.h"
 #include "EventManager.h"
 #include "PgoUtilities.h"
@@ -77,7 +85,11 @@ Console::~Console()
 
 void Console::Init()
 {
-	_notificationManager.reset(new NotificationManager());
+#ifdef HOTPATH_PROFILER
+	//The profiler is only created in profiling builds (the PROFILE_* macros are empty otherwise)
+	_frameProfiler.reset(new FrameProfiler());
+#endif
+	_notificationManager.reset(new NotificationManager(_frameProfiler));
 	_batteryManager.reset(new BatteryManager());
 	
 	_videoRenderer.reset(new VideoRenderer(shared_from_this()));
@@ -90,6 +102,9 @@ void Console::Init()
 	_soundMixer.reset(new SoundMixer(shared_from_this()));
 	_soundMixer->SetNesModel(_model);
 
+	_headlessInput.reset(new HeadlessInputProvider());
+	_pageSnapshotManager.reset(new PageSnapshotManager(this));
+
 	if(_master) {
 		_emulationThreadId = _master->_emulationThreadId;
 	}
@@ -123,6 +138,7 @@ void Console::Release(bool forShutdown)
 
 	_rewindManager.reset();
 	_autoSaveManager.reset();
+	_checksumLog.reset();
 
 	_hdPackBuilder.reset();
 	_hdData.reset();
@@ -216,9 +232,13 @@ string Console::FindMatchingRom(string romName, HashInfo hashInfo)
 		}
 	}
 
-	string lcRomname = romName;
-	std::transform(lcRomname.begin(), lcRomname.end(), lcRomname.begin(), ::tolower);
-	std::unordered_set<string> validExtensions = { { ".nes", ".fds", "*.unif", "*.unif", "*.nsf", "*.nsfe", "*.7z", "*.zip" } };
+	//Check the index first, this avoids scanning the game folders when the rom was already indexed
+	string match = RomHashIndex::FindMatchingRom(hashInfo);
+	if(!match.empty()) {
+		return match;
+	}
+
+	std::unordered_set<string> validExtensions = { { ".nes", ".fds", ".unf", ".unif", ".nsf", ".nsfe", ".studybox", ".7z", ".zip" } };
 	vector<string> romFiles;
 	for(string folder : FolderUtilities::GetKnownGameFolders()) {
 		vector<string> files = FolderUtilities::GetFilesInFolder(folder, validExtensions, true);
@@ -227,19 +247,15 @@ string Console::FindMatchingRom(string romName, HashInfo hashInfo)
 
 	if(!romName.empty()) {
 		//Perform quick search based on file name
-		string match = RomLoader::FindMatchingRom(romFiles, romName, hashInfo, true);
+		match = RomLoader::FindMatchingRom(romFiles, romName, hashInfo);
 		if(!match.empty()) {
 			return match;
 		}
 	}
 
-	//Perform slow CRC32 search for ROM
-	string match = RomLoader::FindMatchingRom(romFiles, romName, hashInfo, false);
-	if(!match.empty()) {
-		return match;
-	}
-
-	return "";
+	//Hash all files that were added/modified since the last search and look for the rom in the updated index
+	RomHashIndex::Update(romFiles);
+	return RomHashIndex::FindMatchingRom(hashInfo);
 }
 
 bool Console::Initialize(string romFile, string patchFile)
@@ -316,6 +332,9 @@ bool Console::Initialize(VirtualFile &romFile, VirtualFile &patchFile, bool forP
 				_mapper->CopyPrgChrRom(previousMapper);
 			}
 
+			//Keep the rom's data to be able to clone the console (the PRG/CHR ROM data is in the mapper's shared images at this point)
+			_romData = std::make_shared<RomData>(std::move(romData));
+
 			if(_slave) {
 				_slave->Release(false);
 				_slave.reset();
@@ -328,66 +347,13 @@ bool Console::Initialize(VirtualFile &romFile, VirtualFile &patchFile, bool forP
 				_slave->Initialize(romFile, patchFile);
 			}
 
-			switch(romInfo.System) {
-				case GameSystem::FDS:
-					_settings->SetPpuModel(PpuModel::Ppu2C02);
-					_systemActionManager.reset(new FdsSystemActionManager(shared_from_this(), _mapper));
-					break;
-				
-				case GameSystem::VsSystem:
-					_settings->SetPpuModel(romInfo.VsPpuModel);
-					_systemActionManager.reset(new VsSystemActionManager(shared_from_this()));
-					break;
-				
-				default: 
-					_settings->SetPpuModel(PpuModel::Ppu2C02);
-					_systemActionManager.reset(new SystemActionManager(shared_from_this())); break;
-			}
-
-			//Temporarely disable battery saves to prevent battery files from being created for the wrong game (for Battle Box & Turbo File)
-			_batteryManager->SetSaveEnabled(false);
-
 			uint32_t pollCounter = 0;
 			if(_controlManager && !isDifferentGame) {
 				//When power cycling, poll counter must be preserved to allow movies to playback properly
 				pollCounter = _controlManager->GetPollCounter();
 			}
 
-			if(romInfo.System == GameSystem::VsSystem) {
-				_controlManager.reset(new VsControlManager(shared_from_this(), _systemActionManager, _mapper->GetMapperControlDevice()));
-			} else {
-				_controlManager.reset(new ControlManager(shared_from_this(), _systemActionManager, _mapper->GetMapperControlDevice()));
-			}
-			_controlManager->SetPollCounter(pollCounter);
-			_controlManager->UpdateControlDevices();
-			
-			//Re-enable battery saves
-			_batteryManager->SetSaveEnabled(true);
-			
-			if(_hdData && (!_hdData->Tiles.empty() || !_hdData->Backgrounds.empty())) {
-				_ppu.reset(new HdPpu(shared_from_this(), _hdData.get()));
-			} else if(std::dynamic_pointer_cast<NsfMapper>(_mapper)) {
-				//Disable most of the PPU for NSFs
-				_ppu.reset(new NsfPpu(shared_from_this()));
-			} else {
-				_ppu.reset(new PPU(shared_from_this()));
-			}
-
-			_memoryManager->SetMapper(_mapper);
-			_memoryManager->RegisterIODevice(_ppu.get());
-			_memoryManager->RegisterIODevice(_apu.get());
-			_memoryManager->RegisterIODevice(_controlManager.get());
-			_memoryManager->RegisterIODevice(_mapper.get());
-
-			if(_hdData && (!_hdData->BgmFilesById.empty() || !_hdData->SfxFilesById.empty())) {
-				_hdAudioDevice.reset(new HdAudioDevice(shared_from_this(), _hdData.get()));
-				_memoryManager->RegisterIODevice(_hdAudioDevice.get());
-			} else {
-				_hdAudioDevice.reset();
-			}
-
-			_model = NesModel::Auto;
-			UpdateNesModel(false);
+			InitializeComponents(romInfo, pollCounter);
 
 			_initialized = true;
 
@@ -404,7 +370,7 @@ bool Console::Initialize(VirtualFile &romFile, VirtualFile &patchFile, bool forP
 			if(!forPowerCycle) {
 				KeyManager::UpdateDevices();
 				_rewindManager.reset(new RewindManager(shared_from_this()));
-				_notificationManager->RegisterNotificationListener(_rewindManager);
+				_notificationManager->RegisterNotificationListener(_rewindManager, { ConsoleNotificationType::PpuFrameDone, ConsoleNotificationType::StateLoaded });
 			} else {
 				_rewindManager->Initialize();
 			}
@@ -463,9 +429,179 @@ bool Console::Initialize(VirtualFile &romFile, VirtualFile &patchFile, bool forP
 	return false;
 }
 
+void Console::InitializeComponents(RomInfo &romInfo, uint32_t pollCounter)
+{
+	switch(romInfo.System) {
+		case GameSystem::FDS:
+			_settings->SetPpuModel(PpuModel::Ppu2C02);
+			_systemActionManager.reset(new FdsSystemActionManager(shared_from_this(), _mapper));
+			break;
+		
+		case GameSystem::VsSystem:
+			_settings->SetPpuModel(romInfo.VsPpuModel);
+			_systemActionManager.reset(new VsSystemActionManager(shared_from_this()));
+			break;
+		
+		default: 
+			_settings->SetPpuModel(PpuModel::Ppu2C02);
+			_systemActionManager.reset(new SystemActionManager(shared_from_this())); break;
+	}
+
+	//Temporarely disable battery saves to prevent battery files from being created for the wrong game (for Battle Box & Turbo File)
+	_batteryManager->SetSaveEnabled(false);
+
+	if(romInfo.System == GameSystem::VsSystem) {
+		_controlManager.reset(new VsControlManager(shared_from_this(), _systemActionManager, _mapper->GetMapperControlDevice()));
+	} else {
+		_controlManager.reset(new ControlManager(shared_from_this(), _systemActionManager, _mapper->GetMapperControlDevice()));
+	}
+	_controlManager->SetPollCounter(pollCounter);
+	_controlManager->UpdateControlDevices();
+	
+	//Re-enable battery saves
+	_batteryManager->SetSaveEnabled(true);
+	
+	if(_hdData && (!_hdData->Tiles.empty() || !_hdData->Backgrounds.empty())) {
+		_ppu.reset(new HdPpu(shared_from_this(), _hdData.get()));
+	} else if(std::dynamic_pointer_cast<NsfMapper>(_mapper)) {
+		//Disable most of the PPU for NSFs
+		_ppu.reset(new NsfPpu(shared_from_this()));
+	} else {
+		_ppu.reset(new PPU(shared_from_this()));
+	}
+
+	_memoryManager->SetMapper(_mapper);
+	_memoryManager->RegisterIODevice(_ppu.get());
+	_memoryManager->RegisterIODevice(_apu.get());
+	_memoryManager->RegisterIODevice(_controlManager.get());
+	_memoryManager->RegisterIODevice(_mapper.get());
+
+	if(_hdData && (!_hdData->BgmFilesById.empty() || !_hdData->SfxFilesById.empty())) {
+		_hdAudioDevice.reset(new HdAudioDevice(shared_from_this(), _hdData.get()));
+		_memoryManager->RegisterIODevice(_hdAudioDevice.get());
+	} else {
+		_hdAudioDevice.reset();
+	}
+
+	_model = NesModel::Auto;
+	UpdateNesModel(false);
+}
+
+shared_ptr<Console> Console::Clone(shared_ptr<Console> reuse)
+{
+	if(!_initialized || !_romData || _master) {
+		return nullptr;
+	}
+
+	if(reuse && reuse.get() != this && reuse->_romData == _romData && !reuse->IsRunning()) {
+		//Same game & components, only the ROM (if it was modified) and the state need to be copied
+		reuse->_mapper->CopyPrgChrRom(_mapper);
+		if(reuse->_slave) {
+			reuse->_slave->_mapper->CopyPrgChrRom(_slave->_mapper);
+		}
+		reuse->CopyState(this);
+		return reuse;
+	}
+
+	//Creating a console changes the settings used by the KeyManager, keep the current ones
+	EmulationSettings* keyManagerSettings = KeyManager::GetSettings();
+	shared_ptr<Console> clone(new Console(nullptr, _settings.get()));
+	KeyManager::SetSettings(keyManagerSettings);
+
+	clone->Init();
+	clone->InitializeClone(this);
+	clone->CopyState(this);
+
+	//Created after copying the state, the first rewind state must match the clone's state
+	clone->_rewindManager.reset(new RewindManager(clone));
+	clone->_notificationManager->RegisterNotificationListener(clone->_rewindManager, { ConsoleNotificationType::PpuFrameDone, ConsoleNotificationType::StateLoaded });
+	return clone;
+}
+
+void Console::InitializeClone(Console* source)
+{
+	_romFilepath = source->_romFilepath;
+	_patchFilename = source->_patchFilename;
+	_romData = source->_romData;
+	_hdData = source->_hdData;
+
+	VirtualFile romFile = _romFilepath;
+	_batteryManager->Initialize(FolderUtilities::GetFilename(romFile.GetFileName(), false));
+
+	_mapper = MapperFactory::InitializeFromRomData(*_romData);
+	_memoryManager.reset(new MemoryManager(shared_from_this()));
+	_cpu.reset(new CPU(shared_from_this()));
+	_apu.reset(new APU(shared_from_this()));
+
+	_mapper->SetConsole(shared_from_this());
+	_mapper->Initialize(*_romData);
+
+	//Share the ROM unless it was modified (e.g by the debugger)
+	_mapper->CopyPrgChrRom(source->_mapper);
+
+	if(source->_slave) {
+		_slave.reset(new Console(shared_from_this()));
+		_slave->Init();
+		_slave->InitializeClone(source->_slave.get());
+	}
+
+	RomInfo romInfo = _mapper->GetRomInfo();
+	InitializeComponents(romInfo, source->_controlManager->GetPollCounter());
+
+	//Clones never write battery files
+	_batteryManager->SetSaveEnabled(false);
+
+	_initialized = true;
+	ResetComponents(false);
+
+	if(_master) {
+		_rewindManager.reset(new RewindManager(shared_from_this()));
+		_notificationManager->RegisterNotificationListener(_rewindManager, { ConsoleNotificationType::PpuFrameDone, ConsoleNotificationType::StateLoaded });
+	}
+}
+
+void Console::CopyState(Console* source)
+{
+	//The RAM is copied directly from the source console's buffers, the rest of the state goes through a save state that excludes the RAM
+	vector<DirtyPageTracker*> sourceTrackers;
+	vector<DirtyPageTracker*> trackers;
+	source->GetDirtyPageTrackers(sourceTrackers);
+	GetDirtyPageTrackers(trackers);
+
+	bool copyRam = sourceTrackers.size() == trackers.size();
+	for(size_t i = 0; copyRam && i < trackers.size(); i++) {
+		copyRam = sourceTrackers[i]->GetSize() == trackers[i]->GetSize();
+	}
+
+	stringstream state;
+	source->_excludeRamFromState = copyRam;
+	source->SaveState(state);
+	source->_excludeRamFromState = false;
+
+	if(copyRam) {
+		for(size_t i = 0; i < trackers.size(); i++) {
+			memcpy(trackers[i]->GetMemory(), sourceTrackers[i]->GetMemory(), trackers[i]->GetSize());
+			trackers[i]->MarkAllDirty();
+		}
+	}
+
+	_excludeRamFromState = copyRam;
+	LoadState(state);
+	_excludeRamFromState = false;
+
+	_controlManager->SetLagging(source->_controlManager->IsLagging());
+	if(_slave) {
+		_slave->_controlManager->SetLagging(source->_slave->_controlManager->IsLagging());
+	}
+	*_headlessInput = *source->_headlessInput;
+}
+
 void Console::ProcessCpuClock()
 {
-	_mapper->ProcessCpuClock();
+	{
+		PROFILE_SAMPLED_SCOPE(_frameProfiler.get(), MapperClock);
+		_mapper->ClockCpu();
+	}
 	_apu->ProcessCpuClock();
 }
 
@@ -542,11 +678,21 @@ shared_ptr<RewindManager> Console::GetRewindManager()
 	return _rewindManager;
 }
 
+FrameProfiler* Console::GetFrameProfiler()
+{
+	return _frameProfiler.get();
+}
+
 HistoryViewer* Console::GetHistoryViewer()
 {
 	return _historyViewer.get();
 }
 
+void Console::SetRollbackManager(shared_ptr<RollbackManager> rollbackManager)
+{
+	_rollbackManager = rollbackManager;
+}
+
 VirtualFile Console::GetRomPath()
 {
 	return static_cast<VirtualFile>(_romFilepath);
@@ -628,6 +774,11 @@ void Console::ResetComponents(bool softReset)
 
 	_resetRunTimers = true;
 
+	shared_ptr<StateChecksumLog> checksumLog = _checksumLog;
+	if(checksumLog && !_master) {
+		checksumLog->ProcessReset();
+	}
+
 	//This notification MUST be sent before the UpdateInputState() below to allow MovieRecorder to grab the first frame's worth of inputs
 	if(!_master) {
 		_notificationManager->SendNotification(softReset ? ConsoleNotificationType::GameReset : ConsoleNotificationType::GameLoaded);
@@ -697,6 +848,59 @@ void Console::RunSingleFrame()
 	_emulationThreadId = std::this_thread::get_id();
 	UpdateNesModel(true);
 
+	{
+		PROFILE_SCOPE(_frameProfiler.get(), CpuExec);
+		while(_ppu->GetFrameCount() == lastFrameNumber) {
+			_cpu->Exec();
+			if(_slave) {
+				RunSlaveCpu();
+			}
+		}
+	}
+
+	_settings->DisableOverclocking(_disableOcNextFrame || IsNsf());
+	_disableOcNextFrame = false;
+
+	_systemActionManager->ProcessSystemActions();
+	_apu->EndFrame();
+	ProcessStateChecksums();
+	MovieManager::ProcessEndOfFrame(this);
+#ifdef HOTPATH_PROFILER
+	ProcessProfilerEndOfFrame();
+#endif
+}
+
+bool Console::RunHeadlessFrames(uint32_t frameCount)
+{
+	//Used for bulk simulation: runs frames on the caller's thread as fast as possible
+	//No frame timing, video decoding, audio output or rewind history - only the emulation's state is updated
+	if(IsRunning() || !_mapper) {
+		return false;
+	}
+
+	_settings->SetHeadlessMode(true);
+
+	_emulationThreadId = std::this_thread::get_id();
+
+	//Keep a reference to the control manager, a power cycle (e.g from a system action) replaces it
+	shared_ptr<ControlManager> controlManager = _controlManager;
+	controlManager->RegisterInputProvider(_headlessInput.get());
+	for(uint32_t i = 0; i < frameCount; i++) {
+		RunHeadlessFrame();
+	}
+	controlManager->UnregisterInputProvider(_headlessInput.get());
+
+	_settings->SetHeadlessMode(false);
+	return true;
+}
+
+void Console::RunHeadlessFrame()
+{
+	//Same as RunSingleFrame, without the end of frame processing for movies, state checksum logs and the profiler
+	//The PPU also skips the PpuFrameDone notification in headless mode
+	uint32_t lastFrameNumber = _ppu->GetFrameCount();
+	UpdateNesModel(true);
+
 	while(_ppu->GetFrameCount() == lastFrameNumber) {
 		_cpu->Exec();
 		if(_slave) {
@@ -711,6 +915,11 @@ void Console::RunSingleFrame()
 	_apu->EndFrame();
 }
 
+void Console::SetHeadlessInput(uint8_t port, ControlDeviceState state)
+{
+	_headlessInput->SetDeviceState(port, state);
+}
+
 void Console::RunSlaveCpu()
 {
 	int64_t cycleGap;
@@ -727,6 +936,7 @@ void Console::RunSlaveCpu()
 
 void Console::RunFrame()
 {
+	PROFILE_SCOPE(_frameProfiler.get(), CpuExec);
 	uint32_t frameCount = _ppu->GetFrameCount();
 	while(_ppu->GetFrameCount() == frameCount) {
 		_cpu->Exec();
@@ -769,11 +979,16 @@ void Console::Run()
 	try {
 		while(true) {
 			stringstream runAheadState;
-			bool useRunAhead = _settings->GetRunAheadFrames() > 0 && !_debugger && !IsNsf() && !_rewindManager->IsRewinding() && _settings->GetEmulationSpeed() > 0 && _settings->GetEmulationSpeed() <= 100;
-			if(useRunAhead) {
-				RunFrameWithRunAhead(runAheadState);
+			PageSnapshot runAheadPages;
+			shared_ptr<RollbackManager> rollbackManager = _rollbackManager;
+			bool useRunAhead = !rollbackManager && _settings->GetRunAheadFrames() > 0 && !_debugger && !IsNsf() && !_rewindManager->IsRewinding() && _settings->GetEmulationSpeed() > 0 && _settings->GetEmulationSpeed() <= 100;
+			if(rollbackManager) {
+				rollbackManager->RunFrame();
+			} else if(useRunAhead) {
+				RunFrameWithRunAhead(runAheadState, runAheadPages);
 			} else {
 				RunFrame();
+				ProcessStateChecksums();
 			}
 
 			_soundMixer->ProcessEndOfFrame();
@@ -785,6 +1000,10 @@ void Console::Run()
 				_historyViewer->ProcessEndOfFrame();
 			}
 			_rewindManager->ProcessEndOfFrame();
+			MovieManager::ProcessEndOfFrame(this);
+#ifdef HOTPATH_PROFILER
+			ProcessProfilerEndOfFrame();
+#endif
 			_settings->DisableOverclocking(_disableOcNextFrame || IsNsf());
 			_disableOcNextFrame = false;
 
@@ -834,7 +1053,7 @@ void Console::Run()
 
 			if(useRunAhead) {
 				_settings->SetRunAheadFrameFlag(true);
-				LoadState(runAheadState);
+				LoadState(runAheadState, runAheadPages);
 				_settings->SetRunAheadFrameFlag(false);
 			}
 
@@ -873,6 +1092,11 @@ void Console::Run()
 					std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(30));
 					pausedRequired = _settings->NeedsPause();
 					_paused = true;
+
+					//Movie seeks are also processed while paused
+					_runLock.Acquire();
+					MovieManager::ProcessSeek();
+					_runLock.Release();
 				}
 				_paused = false;
 					
@@ -892,6 +1116,7 @@ void Console::Run()
 			}
 
 			_systemActionManager->ProcessSystemActions();
+			MovieManager::ProcessSeek();
 
 			if(_stop) {
 				_stop = false;
@@ -945,13 +1170,14 @@ void Console::Run()
 	_notificationManager->SendNotification(ConsoleNotificationType::EmulationStopped);
 }
 
-void Console::RunFrameWithRunAhead(std::stringstream& runAheadState)
+void Console::RunFrameWithRunAhead(std::stringstream& runAheadState, PageSnapshot& runAheadPages)
 {
 	uint32_t runAheadFrames = _settings->GetRunAheadFrames();
 	_settings->SetRunAheadFrameFlag(true);
 	//Run a single frame and save the state (no audio/video)
 	RunFrame();
-	SaveState(runAheadState);
+	ProcessStateChecksums();
+	SaveState(runAheadState, runAheadPages);
 	while(runAheadFrames > 1) {
 		//Run extra frames if the requested run ahead frame count is higher than 1
 		runAheadFrames--;
@@ -1140,6 +1366,47 @@ void Console::LoadState(uint8_t *buffer, uint32_t bufferSize)
 	LoadState(stream);
 }
 
+void Console::SaveState(ostream &saveStream, PageSnapshot &ramPages)
+{
+	if(_initialized) {
+		std::streampos start = saveStream.tellp();
+		_excludeRamFromState = true;
+		SaveState(saveStream);
+		_excludeRamFromState = false;
+		_pageSnapshotManager->TakeSnapshot(ramPages, (uint32_t)(saveStream.tellp() - start));
+	}
+}
+
+void Console::LoadState(istream &loadStream, PageSnapshot &ramPages)
+{
+	//The RAM is restored first, to make sure it is up to date by the time the StateLoaded notification is sent
+	if(_initialized && _pageSnapshotManager->RestoreSnapshot(ramPages)) {
+		_excludeRamFromState = true;
+		LoadState(loadStream);
+		_excludeRamFromState = false;
+	}
+}
+
+bool Console::IsRamExcludedFromState()
+{
+	//The slave console's state is saved/loaded as part of the master's state
+	return _master ? _master->_excludeRamFromState : _excludeRamFromState;
+}
+
+void Console::GetDirtyPageTrackers(vector<DirtyPageTracker*> &trackers)
+{
+	trackers.push_back(_memoryManager->GetDirtyPageTracker());
+	_mapper->GetDirtyPageTrackers(trackers);
+	if(_slave) {
+		_slave->GetDirtyPageTrackers(trackers);
+	}
+}
+
+PageSnapshotStatistics Console::GetPageSnapshotStatistics()
+{
+	return _pageSnapshotManager->GetStatistics();
+}
+
 std::shared_ptr<Debugger> Console::GetDebugger(bool autoStart)
 {
 	shared_ptr<Debugger> debugger = _debugger;
@@ -1444,6 +1711,76 @@ bool Console::IsRecordingTapeFile()
 	return false;
 }
 
+bool Console::StartStateChecksumLog(string filepath)
+{
+	shared_ptr<StateChecksumLog> checksumLog(new StateChecksumLog());
+	if(!checksumLog->Start(filepath, _slave != nullptr)) {
+		return false;
+	}
+
+	Pause();
+	_checksumLog = checksumLog;
+	Resume();
+
+	MessageManager::Log("[Determinism] Logging state checksums to: " + filepath);
+	return true;
+}
+
+void Console::StopStateChecksumLog()
+{
+	Pause();
+	_checksumLog.reset();
+	Resume();
+}
+
+bool Console::IsStateChecksumLogRunning()
+{
+	return _checksumLog != nullptr;
+}
+
+void Console::ProcessStateChecksums()
+{
+	//Called once the frame's state is final (i.e not for run ahead frames)
+	shared_ptr<StateChecksumLog> checksumLog = _checksumLog;
+	if(checksumLog) {
+		checksumLog->ProcessEndOfFrame(this);
+	}
+}
+
+void Console::ProcessProfilerEndOfFrame()
+{
+	_frameProfiler->ProcessEndOfFrame(_ppu->GetFrameCount());
+	if(_slave) {
+		_slave->_frameProfiler->ProcessEndOfFrame(_slave->_ppu->GetFrameCount());
+	}
+}
+
+bool Console::StartProfilerTrace(string filepath)
+{
+#ifdef HOTPATH_PROFILER
+	if(!_frameProfiler->StartTrace(filepath)) {
+		return false;
+	}
+	MessageManager::Log("[Profiler] Writing trace to: " + filepath);
+	return true;
+#else
+	MessageManager::Log("[Profiler] Profiling is not available in this build (HOTPATH_PROFILER is not defined)");
+	return false;
+#endif
+}
+
+void Console::StopProfilerTrace()
+{
+	if(_frameProfiler) {
+		_frameProfiler->StopTrace();
+	}
+}
+
+bool Console::IsProfilerTraceRunning()
+{
+	return _frameProfiler && _frameProfiler->IsTracing();
+}
+
 bool Console::IsNsf()
 {
 	return std::dynamic_pointer_cast<NsfMapper>(_mapper) != nullptr;
@@ -1618,11 +1955,91 @@ void Console::DisplayDebugInformation(double lastFrame, double &lastFrameMin, do
 	ss = std::stringstream();
 	ss << "Max Delay: " << std::fixed << std::setprecision(2) << lastFrameMax << " ms";
 	_debugHud->DrawString(134, 48, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+	shared_ptr<RollbackManager> rollbackManager = _rollbackManager;
+	if(rollbackManager) {
+		RollbackStatistics rollbackStats = rollbackManager->GetStatistics();
+
+		_debugHud->DrawRectangle(8, 64, 115, 40, 0x40000000, true, 1, startFrame);
+		_debugHud->DrawRectangle(8, 64, 115, 40, 0xFFFFFF, false, 1, startFrame);
+		_debugHud->DrawString(10, 66, "Netplay Rollback", 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+		ss = std::stringstream();
+		ss << "Rollbacks/s: " << std::fixed << std::setprecision(1) << rollbackStats.RollbacksPerSecond;
+		_debugHud->DrawString(10, 77, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+		ss = std::stringstream();
+		ss << "Frames/s: " << std::fixed << std::setprecision(1) << rollbackStats.ResimulatedFramesPerSecond;
+		_debugHud->DrawString(10, 86, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+		ss = std::stringstream();
+		ss << "Cost: " << std::fixed << std::setprecision(2) << rollbackStats.AverageResimulationTime << " ms";
+		_debugHud->DrawString(10, 95, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+	}
+
+	if(GameServer::Started() || GameClient::Connected()) {
+		NetPlayStatistics netStats = GameServer::Started() ? GameServer::GetStatistics() : GameClient::GetStatistics();
+
+		_debugHud->DrawRectangle(132, 64, 115, 40, 0x40000000, true, 1, startFrame);
+		_debugHud->DrawRectangle(132, 64, 115, 40, 0xFFFFFF, false, 1, startFrame);
+		_debugHud->DrawString(134, 66, "Netplay Traffic", 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+		ss = std::stringstream();
+		ss << "Sent: " << (netStats.BytesSent / 1024) << " KB";
+		_debugHud->DrawString(134, 77, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+		ss = std::stringstream();
+		ss << "Received: " << (netStats.BytesReceived / 1024) << " KB";
+		_debugHud->DrawString(134, 86, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+		ss = std::stringstream();
+		ss << "State: " << (netStats.LastStateCompressedSize / 1024) << "/" << (netStats.LastStateSize / 1024) << " KB";
+		_debugHud->DrawString(134, 95, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+	}
+
+	PageSnapshotStatistics snapshotStats = _pageSnapshotManager->GetStatistics();
+	if(snapshotStats.SnapshotCount > 0) {
+		_debugHud->DrawRectangle(8, 110, 115, 40, 0x40000000, true, 1, startFrame);
+		_debugHud->DrawRectangle(8, 110, 115, 40, 0xFFFFFF, false, 1, startFrame);
+		_debugHud->DrawString(10, 112, "RAM Snapshots", 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+		ss = std::stringstream();
+		ss << "RAM/snap: " << (snapshotStats.StoredBytes / snapshotStats.SnapshotCount) << " B";
+		_debugHud->DrawString(10, 123, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+		ss = std::stringstream();
+		ss << "State/snap: " << (snapshotStats.StateBytes / snapshotStats.SnapshotCount) << " B";
+		_debugHud->DrawString(10, 132, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+		ss = std::stringstream();
+		ss << "Full RAM: " << (snapshotStats.TrackedBytes / 1024) << " KB";
+		_debugHud->DrawString(10, 141, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+	}
+
+#ifdef HOTPATH_PROFILER
+	ProfilerFrameStats profilerStats = _frameProfiler->GetStatistics();
+	int sectionCount = (int)ProfilerSection::Count;
+	_debugHud->DrawRectangle(132, 110, 115, 24 + sectionCount * 9, 0x40000000, true, 1, startFrame);
+	_debugHud->DrawRectangle(132, 110, 115, 24 + sectionCount * 9, 0xFFFFFF, false, 1, startFrame);
+	_debugHud->DrawString(134, 112, "Frame Profile (ms)", 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+	double totalMs = 0;
+	for(int i = 0; i < sectionCount; i++) {
+		totalMs += profilerStats.SectionMs[i];
+		ss = std::stringstream();
+		ss << FrameProfiler::SectionNames[i] << ": " << std::fixed << std::setprecision(3) << profilerStats.SectionMs[i];
+		_debugHud->DrawString(134, 123 + i * 9, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+	}
+
+	ss = std::stringstream();
+	ss << "Total: " << std::fixed << std::setprecision(3) << totalMs;
+	_debugHud->DrawString(134, 123 + sectionCount * 9, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+#endif
 }
 
 void Console::ExportStub()
 {
-	//Force the compiler to export the PgoRunTest function - otherwise it seems to be ignored since it is unused
+	//Force the compiler to export the PgoRunBenchmark function - otherwise it seems to be ignored since it is unused
 	vector<string> testRoms;
-	PgoRunTest(testRoms, true);
+	PgoRunBenchmark(testRoms, {}, 0, "");
 }
\ No newline at end of file
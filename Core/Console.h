@@ -28,10 +28,20 @@ class NotificationManager;
 class Debugger;
 class EmulationSettings;
 class BatteryManager;
+class RollbackManager;
+class StateChecksumLog;
+class HeadlessInputProvider;
+class PageSnapshotManager;
+class FrameProfiler;
+class DirtyPageTracker;
 
 struct HdPackData;
 struct HashInfo;
+struct ControlDeviceState;
 struct RomInfo;
+struct RomData;
+struct PageSnapshot;
+struct PageSnapshotStatistics;
 
 enum class MemoryOperationType;
 enum class NesModel;
@@ -52,6 +62,11 @@ private:
 
 	shared_ptr<RewindManager> _rewindManager;
 	shared_ptr<HistoryViewer> _historyViewer;
+	shared_ptr<RollbackManager> _rollbackManager;
+	shared_ptr<StateChecksumLog> _checksumLog;
+	shared_ptr<HeadlessInputProvider> _headlessInput;
+	shared_ptr<PageSnapshotManager> _pageSnapshotManager;
+	shared_ptr<FrameProfiler> _frameProfiler;
 
 	shared_ptr<CPU> _cpu;
 	shared_ptr<PPU> _ppu;
@@ -78,6 +93,9 @@ private:
 	shared_ptr<NotificationManager> _notificationManager;
 	shared_ptr<EmulationSettings> _settings;
 
+	//Parsed rom (without the PRG/CHR ROM data, which is shared by the mappers), shared with the console's clones
+	shared_ptr<RomData> _romData;
+
 	shared_ptr<HdPackBuilder> _hdPackBuilder;
 	shared_ptr<HdPackData> _hdData;
 	unique_ptr<HdAudioDevice> _hdAudioDevice;
@@ -98,12 +116,16 @@ private:
 	bool _disableOcNextFrame = false;
 
 	bool _initialized = false;
+	bool _excludeRamFromState = false;
 	std::thread::id _emulationThreadId;
 
-	void RunFrameWithRunAhead(std::stringstream& runAheadState);
-
 	void LoadHdPack(VirtualFile &romFile, VirtualFile &patchFile);
 
+	void InitializeComponents(RomInfo &romInfo, uint32_t pollCounter);
+	void InitializeClone(Console* source);
+	void CopyState(Console* source);
+
+	void RunHeadlessFrame();
 	void UpdateNesModel(bool sendNotification);
 	double GetFrameDelay();
 	void DisplayDebugInformation(double lastFrame, double &lastFrameMin, double &lastFrameMax, double frameDurations[60]);
@@ -139,7 +161,10 @@ public:
 	MemoryManager* GetMemoryManager();
 	CheatManager* GetCheatManager();
 	shared_ptr<RewindManager> GetRewindManager();
+	//Null unless HOTPATH_PROFILER is defined
+	FrameProfiler* GetFrameProfiler();
 	HistoryViewer* GetHistoryViewer();
+	void SetRollbackManager(shared_ptr<RollbackManager> rollbackManager);
 
 	bool LoadMatchingRom(string romName, HashInfo hashInfo);
 	string FindMatchingRom(string romName, HashInfo hashInfo);
@@ -148,6 +173,12 @@ public:
 	bool Initialize(VirtualFile &romFile);
 	bool Initialize(VirtualFile &romFile, VirtualFile &patchFile, bool forPowerCycle = false);
 
+	//Forks the emulation: returns a new console that runs the same game from the current state, with its own copy of the settings
+	//The ROM is shared with this console. Debugger, HD pack recording, movies, rewind history and battery saves are not carried over.
+	//When "reuse" is a previous clone of this game that is no longer needed, only the state is copied into it (much faster than creating a console)
+	//Must be called from the thread that runs this console (e.g between RunHeadlessFrames calls), or while it is paused
+	shared_ptr<Console> Clone(shared_ptr<Console> reuse = nullptr);
+
 	void SaveBatteries();
 
 	void Run();
@@ -157,8 +188,11 @@ public:
 	int32_t GetStopCode();
 		
 	void RunSingleFrame();
+	bool RunHeadlessFrames(uint32_t frameCount);
+	void SetHeadlessInput(uint8_t port, ControlDeviceState state);
 	void RunSlaveCpu();
 	void RunFrame();
+	void RunFrameWithRunAhead(std::stringstream& runAheadState, PageSnapshot& runAheadPages);
 	bool UpdateHdPackMode();
 
 	shared_ptr<SystemActionManager> GetSystemActionManager();
@@ -177,6 +211,17 @@ public:
 	void StartRecordingTapeFile(string filepath);
 	void StopRecordingTapeFile();
 	bool IsRecordingTapeFile();
+
+	bool StartStateChecksumLog(string filepath);
+	void StopStateChecksumLog();
+	bool IsStateChecksumLogRunning();
+	void ProcessStateChecksums();
+	void ProcessProfilerEndOfFrame();
+
+	//Writes the per-frame profiling data to a Chrome trace (JSON) file - requires a build with HOTPATH_PROFILER defined
+	bool StartProfilerTrace(string filepath);
+	void StopProfilerTrace();
+	bool IsProfilerTraceRunning();
 	bool IsNsf();
 		
 	std::thread::id GetEmulationThreadId();
@@ -200,6 +245,13 @@ public:
 	void LoadState(istream &loadStream, uint32_t stateVersion);
 	void LoadState(uint8_t *buffer, uint32_t bufferSize);
 
+	//Save/load a state where the RAM is stored as a PageSnapshot instead of being part of the stream (for run-ahead and rollback)
+	void SaveState(ostream &saveStream, PageSnapshot &ramPages);
+	void LoadState(istream &loadStream, PageSnapshot &ramPages);
+	bool IsRamExcludedFromState();
+	void GetDirtyPageTrackers(vector<DirtyPageTracker*> &trackers);
+	PageSnapshotStatistics GetPageSnapshotStatistics();
+
 	VirtualFile GetRomPath();
 	VirtualFile GetPatchFile();
 	RomInfo GetRomInfo();
@@ -319,6 +319,16 @@ void ControlManager::ResetLagCounter()
 	_lagCounter = 0;
 }
 
+bool ControlManager::IsLagging()
+{
+	return _isLagging;
+}
+
+void ControlManager::SetLagging(bool lagging)
+{
+	_isLagging = lagging;
+}
+
 uint32_t ControlManager::GetPollCounter()
 {
 	return ControlManager::_pollCounter;
@@ -52,6 +52,10 @@ public:
 	uint32_t GetLagCounter();
 	void ResetLagCounter();
 
+	//The lag flag is not part of save states (used when cloning a console)
+	bool IsLagging();
+	void SetLagging(bool lagging);
+
 	uint32_t GetPollCounter();
 	void SetPollCounter(uint32_t value);
 
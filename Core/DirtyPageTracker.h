@@ -0,0 +1,71 @@
+#pragma once
+#include "stdafx.h"
+
+//Keeps one flag per 256-byte page of a RAM buffer, set by the write paths (mapper/memory manager) when the page is modified
+//PageSnapshotManager uses (and clears) these flags to only copy the pages that changed since the last RAM page snapshot
+class DirtyPageTracker
+{
+public:
+	static constexpr uint32_t PageShift = 8;
+	static constexpr uint32_t PageSize = 1 << PageShift;
+
+private:
+	uint8_t* _memory = nullptr;
+	uint32_t _size = 0;
+	uint32_t _pageCount = 0;
+	vector<uint8_t> _dirtyPages;
+
+public:
+	void Init(uint8_t* memory, uint32_t size)
+	{
+		_memory = memory;
+		_size = memory ? size : 0;
+
+		//Every page is dirty until the first snapshot is taken
+		//The extra flag is for CPU/PPU pages mapped at an unaligned offset near the end of the buffer
+		_pageCount = (_size + PageSize - 1) >> PageShift;
+		_dirtyPages.assign(_pageCount + 1, 1);
+	}
+
+	uint8_t* GetMemory() { return _memory; }
+	uint32_t GetSize() { return _size; }
+	uint32_t GetPageCount() { return _pageCount; }
+	uint8_t* GetDirtyFlags() { return _dirtyPages.data(); }
+
+	bool Contains(uint8_t* ptr)
+	{
+		return _size > 0 && ptr >= _memory && ptr < _memory + _size;
+	}
+
+	__forceinline void MarkDirty(uint32_t offset)
+	{
+		_dirtyPages[offset >> PageShift] = 1;
+	}
+
+	void MarkDirty(uint32_t offset, uint32_t length)
+	{
+		if(length == 0 || offset >= _size) {
+			return;
+		}
+
+		uint32_t lastPage = (std::min(offset + length, _size) - 1) >> PageShift;
+		for(uint32_t i = offset >> PageShift; i <= lastPage; i++) {
+			_dirtyPages[i] = 1;
+		}
+	}
+
+	void MarkAllDirty()
+	{
+		std::fill(_dirtyPages.begin(), _dirtyPages.end(), 1);
+	}
+
+	bool IsDirty(uint32_t page)
+	{
+		return _dirtyPages[page] != 0;
+	}
+
+	void ClearDirty(uint32_t page)
+	{
+		_dirtyPages[page] = 0;
+	}
+};
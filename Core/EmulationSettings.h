@@ -668,6 +668,7 @@ private:
 
 	uint32_t _runAheadFrames = 0;
 	bool _isRunAheadFrame = false;
+	bool _headlessMode = false;
 
 	NesModel _model = NesModel::Auto;
 	PpuModel _ppuModel = PpuModel::Ppu2C02;
@@ -1026,6 +1027,17 @@ public:
 		return _isRunAheadFrame;
 	}
 
+	//Headless mode: only the CPU/PPU/APU state is emulated (no video decoding, audio output or rewind history)
+	void SetHeadlessMode(bool enabled)
+	{
+		_headlessMode = enabled;
+	}
+
+	bool IsHeadlessMode()
+	{
+		return _headlessMode;
+	}
+
 	//0: No limit, Number: % of default speed (50/60fps)
 	void SetEmulationSpeed(uint32_t emulationSpeed, bool displaySpeed = false)
 	{
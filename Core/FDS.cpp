@@ -220,6 +220,16 @@ void FDS::ProcessAutoDiskInsert()
 	}
 }
 
+void FDS::RunExpansionAudio()
+{
+	_audio->Run();
+}
+
+void FDS::ClockExpansionAudio()
+{
+	_audio->Clock();
+}
+
 void FDS::ProcessCpuClock()
 {
 	if(_settings->CheckFlag(EmulationFlags::FdsFastForwardOnLoad)) {
@@ -231,7 +241,6 @@ void FDS::ProcessCpuClock()
 	ProcessAutoDiskInsert();
 
 	ClockIrq();
-	_audio->Clock();
 
 	if(_diskNumber == FDS::NoDiskInserted || !_motorOn) {
 		//Disk has been ejected
@@ -99,6 +99,8 @@ protected:
 
 	void ClockIrq();
 	
+	void RunExpansionAudio() override;
+	void ClockExpansionAudio() override;
 	void ProcessCpuClock() override;
 	void UpdateCrc(uint8_t value);
 
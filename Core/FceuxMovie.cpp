@@ -67,7 +67,7 @@ bool FceuxMovie::Play(VirtualFile &file)
 	
 	std::stringstream ss;
 	file.ReadFile(ss);
-	_console->GetNotificationManager()->RegisterNotificationListener(shared_from_this());
+	_console->GetNotificationManager()->RegisterNotificationListener(shared_from_this(), { ConsoleNotificationType::GameLoaded });
 	_console->GetBatteryManager()->SetBatteryProvider(shared_from_this());
 	if(InitializeData(ss)) {
 		_console->Reset(false);
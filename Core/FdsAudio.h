@@ -83,7 +83,7 @@ protected:
 
 
 		if(_lastOutput != outputLevel) {
-			_console->GetApu()->AddExpansionAudioDelta(AudioChannel::FDS, outputLevel - _lastOutput);
+			AddAudioDelta(AudioChannel::FDS, outputLevel - _lastOutput);
 			_lastOutput = outputLevel;
 		}
 	}
@@ -95,6 +95,7 @@ public:
 
 	uint8_t ReadRegister(uint16_t addr)
 	{
+		Run();
 		uint8_t value = _console->GetMemoryManager()->GetOpenBus();
 		if(addr <= 0x407F) {
 			value &= 0xC0;
@@ -112,6 +113,7 @@ public:
 
 	void WriteRegister(uint16_t addr, uint8_t value)
 	{
+		Run();
 		if(addr <= 0x407F) {
 			if(_waveWriteEnabled) {
 				_waveTable[addr & 0x3F] = value & 0x3F;
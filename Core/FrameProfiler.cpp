@@ -0,0 +1,171 @@
+#include "stdafx.h"
+#include "FrameProfiler.h"
+
+using namespace std::chrono;
+
+thread_local ProfilerScope* ProfilerScope::_currentScope = nullptr;
+uint64_t FrameProfiler::TimerOverhead = 0;
+
+const char* FrameProfiler::SectionNames[(int)ProfilerSection::Count] = {
+	"CpuExec", "PpuRun", "MapperClock", "Apu", "ExpansionAudio", "Notification", "PlayAudioBuffer", "DecodeFrame", "Rewind"
+};
+
+static uint32_t GetTraceThreadId()
+{
+	return (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+FrameProfiler::FrameProfiler()
+{
+	_tracing = false;
+
+	if(TimerOverhead == 0) {
+		//Smallest difference between 2 consecutive reads (reading the timestamp counter can be slow, e.g in virtual machines)
+		uint64_t overhead = UINT64_MAX;
+		for(int i = 0; i < 100; i++) {
+			uint64_t start = GetTicks();
+			overhead = std::min(overhead, GetTicks() - start);
+		}
+		TimerOverhead = overhead;
+	}
+
+	_startTicks = GetTicks();
+	_startTime = steady_clock::now();
+}
+
+FrameProfiler::~FrameProfiler()
+{
+	StopTrace();
+}
+
+double FrameProfiler::ToUs(uint64_t ticks)
+{
+	return _ticksPerUs > 0 ? ticks / _ticksPerUs : 0;
+}
+
+void FrameProfiler::AddTraceSpan(ProfilerSection section, uint64_t start, uint64_t end)
+{
+	//May be called from other threads (e.g video decoder), spans are written to the file at the end of the frame
+	auto lock = _traceLock.AcquireSafe();
+	if(_spans.size() < 10000) {
+		_spans.push_back({ section, start, end, GetTraceThreadId() });
+	}
+}
+
+void FrameProfiler::ProcessEndOfFrame(uint32_t frameNumber)
+{
+	uint64_t now = GetTicks();
+
+	//The tick counter's frequency is unknown (TSC), it is measured against the system clock over the profiler's lifetime
+	double elapsedUs = duration<double, std::micro>(steady_clock::now() - _startTime).count();
+	if(elapsedUs > 0) {
+		_ticksPerUs = (now - _startTicks) / elapsedUs;
+	}
+
+	double sectionUs[(int)ProfilerSection::Count];
+	for(int i = 0; i < (int)ProfilerSection::Count; i++) {
+		sectionUs[i] = ToUs(_sectionTicks[i].exchange(0, std::memory_order_relaxed));
+	}
+	double frameUs = _frameStartTicks ? ToUs(now - _frameStartTicks) : 0;
+
+	{
+		auto lock = _historyLock.AcquireSafe();
+		for(int i = 0; i < (int)ProfilerSection::Count; i++) {
+			_history[_historyPos][i] = sectionUs[i] / 1000;
+		}
+		_frameHistory[_historyPos] = frameUs / 1000;
+		_historyPos = (_historyPos + 1) % HistorySize;
+		_historyCount = std::min<uint32_t>(_historyCount + 1, HistorySize);
+	}
+
+	if(_tracing) {
+		auto lock = _traceLock.AcquireSafe();
+		if(_traceFile) {
+			for(TraceSpan &span : _spans) {
+				WriteTraceEvent(SectionNames[(int)span.Section], 'X', span.Start, span.End, span.ThreadId);
+			}
+			_spans.clear();
+
+			if(_frameStartTicks) {
+				WriteTraceEvent("Frame", 'X', _frameStartTicks, now, GetTraceThreadId(), "\"frame\":" + std::to_string(frameNumber));
+			}
+
+			//Counter event with the frame's totals, shown as a stacked chart by the trace viewers
+			std::stringstream args;
+			args << std::fixed << std::setprecision(3);
+			for(int i = 0; i < (int)ProfilerSection::Count; i++) {
+				args << (i > 0 ? "," : "") << "\"" << SectionNames[i] << "\":" << sectionUs[i];
+			}
+			WriteTraceEvent("Sections (us)", 'C', now, now, 0, args.str());
+		}
+	}
+
+	_frameStartTicks = now;
+}
+
+void FrameProfiler::WriteTraceEvent(string name, char phase, uint64_t start, uint64_t end, uint32_t threadId, string args)
+{
+	_traceFile << (_firstTraceEvent ? "" : ",\n") << std::fixed << std::setprecision(3);
+	_traceFile << "{\"name\":\"" << name << "\",\"ph\":\"" << phase << "\",\"ts\":" << ToUs(start - _startTicks);
+	if(phase == 'X') {
+		_traceFile << ",\"dur\":" << ToUs(end - start);
+	}
+	_traceFile << ",\"pid\":1,\"tid\":" << threadId;
+	if(!args.empty()) {
+		_traceFile << ",\"args\":{" << args << "}";
+	}
+	_traceFile << "}";
+	_firstTraceEvent = false;
+}
+
+ProfilerFrameStats FrameProfiler::GetStatistics()
+{
+	ProfilerFrameStats stats = {};
+
+	auto lock = _historyLock.AcquireSafe();
+	if(_historyCount > 0) {
+		for(uint32_t i = 0; i < _historyCount; i++) {
+			for(int j = 0; j < (int)ProfilerSection::Count; j++) {
+				stats.SectionMs[j] += _history[i][j];
+			}
+			stats.FrameMs += _frameHistory[i];
+		}
+		for(int j = 0; j < (int)ProfilerSection::Count; j++) {
+			stats.SectionMs[j] /= _historyCount;
+		}
+		stats.FrameMs /= _historyCount;
+	}
+	return stats;
+}
+
+bool FrameProfiler::StartTrace(string filename)
+{
+	StopTrace();
+
+	auto lock = _traceLock.AcquireSafe();
+	_traceFile.open(filename, ios::out | ios::trunc);
+	if(!_traceFile) {
+		return false;
+	}
+
+	_traceFile << "{\"traceEvents\":[\n";
+	_firstTraceEvent = true;
+	_spans.clear();
+	_tracing = true;
+	return true;
+}
+
+void FrameProfiler::StopTrace()
+{
+	auto lock = _traceLock.AcquireSafe();
+	if(_traceFile.is_open()) {
+		_tracing = false;
+		_traceFile << "\n]}\n";
+		_traceFile.close();
+	}
+}
+
+bool FrameProfiler::IsTracing()
+{
+	return _tracing;
+}
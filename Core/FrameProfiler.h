@@ -0,0 +1,180 @@
+#pragma once
+#include "stdafx.h"
+#include <chrono>
+#include <thread>
+#include "../Utilities/SimpleLock.h"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+	#include <x86intrin.h>
+#endif
+
+//The scoped timers are only compiled in when HOTPATH_PROFILER is defined (e.g "HOTPATHPROFILER=true make")
+//Otherwise PROFILE_SCOPE expands to nothing and the emulation loop is unchanged
+//PROFILE_SAMPLED_SCOPE is for code that runs on every CPU cycle: only 1 call out of SampleInterval is timed (and counted SampleInterval times)
+#ifdef HOTPATH_PROFILER
+	#define PROFILE_SCOPE(profiler, section) ProfilerScope _profilerScope(profiler, ProfilerSection::section, 1)
+	#define PROFILE_SAMPLED_SCOPE(profiler, section) ProfilerScope _profilerScope(profiler, ProfilerSection::section, FrameProfiler::SampleInterval)
+#else
+	#define PROFILE_SCOPE(profiler, section)
+	#define PROFILE_SAMPLED_SCOPE(profiler, section)
+#endif
+
+enum class ProfilerSection
+{
+	//Called many times per frame - only the time spent in them is aggregated for each frame
+	CpuExec = 0,
+	PpuRun,
+	MapperClock,
+	Apu,
+	ExpansionAudio,
+	Notification,
+
+	//Called a few times per frame - each call is also written to the trace file as a separate event
+	PlayAudioBuffer,
+	DecodeFrame,
+	Rewind,
+
+	Count
+};
+
+struct ProfilerFrameStats
+{
+	//Average time spent in each section (excluding the time spent in the sections it called), over the last 60 frames
+	double SectionMs[(int)ProfilerSection::Count];
+
+	//Time between the end of 2 frames (includes the time spent waiting for the next frame when running at normal speed)
+	double FrameMs;
+};
+
+//Per-frame breakdown of the time spent in the emulation's hot paths (CPU, PPU, mapper, audio, video decoding, rewind, notifications)
+//The totals are shown by the debug HUD and can be written to a Chrome trace file (chrome://tracing, Perfetto) for offline analysis
+class FrameProfiler
+{
+private:
+	static constexpr int HistorySize = 60;
+
+	struct TraceSpan
+	{
+		ProfilerSection Section;
+		uint64_t Start;
+		uint64_t End;
+		uint32_t ThreadId;
+	};
+
+	std::atomic<uint64_t> _sectionTicks[(int)ProfilerSection::Count] = {};
+	uint32_t _sampleCounters[(int)ProfilerSection::Count] = {};
+
+	uint64_t _startTicks = 0;
+	std::chrono::steady_clock::time_point _startTime;
+	uint64_t _frameStartTicks = 0;
+	double _ticksPerUs = 0;
+
+	double _history[HistorySize][(int)ProfilerSection::Count] = {};
+	double _frameHistory[HistorySize] = {};
+	uint32_t _historyPos = 0;
+	uint32_t _historyCount = 0;
+	SimpleLock _historyLock;
+
+	SimpleLock _traceLock;
+	ofstream _traceFile;
+	std::atomic<bool> _tracing;
+	bool _firstTraceEvent = true;
+	vector<TraceSpan> _spans;
+
+	double ToUs(uint64_t ticks);
+	void WriteTraceEvent(string name, char phase, uint64_t start, uint64_t end, uint32_t threadId, string args = "");
+
+public:
+	static constexpr uint32_t SampleInterval = 16;
+
+	//Number of ticks taken by the timer itself (2 GetTicks calls), removed from every measurement
+	static uint64_t TimerOverhead;
+	static const char* SectionNames[(int)ProfilerSection::Count];
+
+	FrameProfiler();
+	~FrameProfiler();
+
+	static __forceinline uint64_t GetTicks()
+	{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	__forceinline bool IsSampled(ProfilerSection section, uint32_t sampleInterval)
+	{
+		return sampleInterval == 1 || (++_sampleCounters[(int)section] & (sampleInterval - 1)) == 0;
+	}
+
+	__forceinline void AddTime(ProfilerSection section, uint64_t selfTicks, uint64_t start, uint64_t end)
+	{
+		_sectionTicks[(int)section].fetch_add(selfTicks, std::memory_order_relaxed);
+		if(section >= ProfilerSection::PlayAudioBuffer && _tracing.load(std::memory_order_relaxed)) {
+			AddTraceSpan(section, start, end);
+		}
+	}
+
+	void AddTraceSpan(ProfilerSection section, uint64_t start, uint64_t end);
+
+	//Called by the emulation thread at the end of each frame, moves the totals to the history and writes them to the trace file
+	void ProcessEndOfFrame(uint32_t frameNumber);
+	ProfilerFrameStats GetStatistics();
+
+	bool StartTrace(string filename);
+	void StopTrace();
+	bool IsTracing();
+};
+
+//Times the enclosing block - the time spent in nested scopes is only counted in their own section
+class ProfilerScope
+{
+private:
+	static thread_local ProfilerScope* _currentScope;
+
+	FrameProfiler* _profiler;
+	ProfilerScope* _parent;
+	ProfilerSection _section;
+	uint32_t _sampleInterval;
+	uint64_t _start;
+	uint64_t _childTicks = 0;
+
+public:
+	__forceinline ProfilerScope(FrameProfiler* profiler, ProfilerSection section, uint32_t sampleInterval)
+	{
+		if(!profiler->IsSampled(section, sampleInterval)) {
+			_profiler = nullptr;
+			return;
+		}
+
+		_profiler = profiler;
+		_section = section;
+		_sampleInterval = sampleInterval;
+		_parent = _currentScope;
+		_currentScope = this;
+		_start = FrameProfiler::GetTicks();
+	}
+
+	__forceinline ~ProfilerScope()
+	{
+		if(!_profiler) {
+			return;
+		}
+
+		uint64_t end = FrameProfiler::GetTicks();
+		uint64_t elapsed = end - _start;
+		elapsed -= std::min(elapsed, FrameProfiler::TimerOverhead);
+
+		//Sampled nested scopes are an estimate, their total can exceed the actual time
+		uint64_t selfTicks = (elapsed > _childTicks ? elapsed - _childTicks : 0) * _sampleInterval;
+		if(_parent) {
+			//Only this scope's own time is scaled, nested scopes were timed (or sampled) on their own
+			_parent->_childTicks += selfTicks + _childTicks;
+		}
+		_currentScope = _parent;
+		_profiler->AddTime(_section, selfTicks, _start, end);
+	}
+};
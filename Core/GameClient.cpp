@@ -35,7 +35,7 @@ bool GameClient::Connected()
 void GameClient::Connect(shared_ptr<Console> console, ClientConnectionData &connectionData)
 {
 	_instance.reset(new GameClient(console));
-	console->GetNotificationManager()->RegisterNotificationListener(_instance);
+	console->GetNotificationManager()->RegisterNotificationListener(_instance, { ConsoleNotificationType::GameLoaded });
 	
 	shared_ptr<GameClient> instance = _instance;
 	if(instance) {
@@ -61,7 +61,7 @@ void GameClient::PrivateConnect(ClientConnectionData &connectionData)
 	shared_ptr<Socket> socket(new Socket());
 	if(socket->Connect(connectionData.Host.c_str(), connectionData.Port)) {
 		_connection.reset(new GameClientConnection(_console, socket, connectionData));
-		_console->GetNotificationManager()->RegisterNotificationListener(_connection);
+		_console->GetNotificationManager()->RegisterNotificationListener(_connection, { ConsoleNotificationType::GameLoaded, ConsoleNotificationType::ConfigChanged });
 		_connected = true;
 	} else {
 		MessageManager::DisplayMessage("NetPlay", "CouldNotConnect");
@@ -117,4 +117,10 @@ uint8_t GameClient::GetControllerPort()
 {
 	shared_ptr<GameClientConnection> connection = GetConnection();
 	return connection ? connection->GetControllerPort() : GameConnection::SpectatorPort;
+}
+
+NetPlayStatistics GameClient::GetStatistics()
+{
+	shared_ptr<GameClientConnection> connection = GetConnection();
+	return connection ? connection->GetStatistics() : NetPlayStatistics {};
 }
\ No newline at end of file
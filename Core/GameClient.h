@@ -2,6 +2,7 @@
 #include "stdafx.h"
 #include <thread>
 #include "INotificationListener.h"
+#include "GameConnection.h"
 
 using std::thread;
 class Socket;
@@ -37,6 +38,7 @@ public:
 	static void SelectController(uint8_t port);
 	static uint8_t GetControllerPort();
 	static uint8_t GetAvailableControllers();
+	static NetPlayStatistics GetStatistics();
 
 	void ProcessNotification(ConsoleNotificationType type, void* parameter) override;
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "MovieDataMessage.h"
 #include "GameInformationMessage.h"
 #include "SaveStateMessage.h"
+#include "SaveStateAckMessage.h"
 #include "Console.h"
 #include "EmulationSettings.h"
 #include "ControlManager.h"
@@ -18,6 +19,7 @@
 #include "ForceDisconnectMessage.h"
 #include "ServerInformationMessage.h"
 #include "NotificationManager.h"
+#include "RollbackManager.h"
 
 GameClientConnection::GameClientConnection(shared_ptr<Console> console, shared_ptr<Socket> socket, ClientConnectionData &connectionData) : GameConnection(console, socket)
 {
@@ -25,6 +27,13 @@ GameClientConnection::GameClientConnection(shared_ptr<Console> console, shared_p
 	_shutdown = false;
 	_enableControllers = false;
 	_minimumQueueSize = 3;
+	_joinTime = 0;
+
+	SetNetworkSimulation(connectionData.SimulatedLatency, connectionData.SimulatedPacketLoss);
+	if(connectionData.RollbackFrames > 0) {
+		_rollbackManager.reset(new RollbackManager(console, connectionData.RollbackFrames));
+		_console->SetRollbackManager(_rollbackManager);
+	}
 
 	MessageManager::DisplayMessage("NetPlay", "ConnectedToServer");
 }
@@ -40,6 +49,13 @@ void GameClientConnection::Shutdown()
 		_shutdown = true;
 		DisableControllers();
 
+		if(_rollbackManager) {
+			_console->SetRollbackManager(nullptr);
+
+			RollbackStatistics stats = _rollbackManager->GetStatistics();
+			MessageManager::Log("[Netplay] Rollbacks: " + std::to_string(stats.RollbackCount) + ", re-simulated frames: " + std::to_string(stats.ResimulatedFrames) + ", max depth: " + std::to_string(stats.MaxRollbackDepth) + ", re-simulation time: " + std::to_string((int)stats.ResimulationTime) + " ms");
+		}
+
 		ControlManager* controlManager = _console->GetControlManager();
 		if(controlManager) {
 			controlManager->UnregisterInputProvider(this);
@@ -71,6 +87,64 @@ void GameClientConnection::ClearInputData()
 	}
 }
 
+void GameClientConnection::ProcessSaveState(SaveStateMessage* message)
+{
+	DisableControllers();
+	_console->Pause();
+	ClearInputData();
+
+	uint32_t baseStateId = 0;
+	vector<uint8_t> noBaseState;
+	vector<uint8_t>* baseState = &noBaseState;
+	for(std::pair<uint32_t, vector<uint8_t>> &state : _baseStates) {
+		if(state.first == message->GetBaseStateId()) {
+			baseStateId = state.first;
+			baseState = &state.second;
+			break;
+		}
+	}
+
+	if(message->LoadState(_console, baseStateId, *baseState)) {
+		RecordStateTransfer(*message);
+		uint32_t stateId = message->GetStateId();
+		_baseStates.push_back({ stateId, std::move(message->GetRawState()) });
+		while(_baseStates.size() > MaxBaseStates) {
+			_baseStates.pop_front();
+		}
+
+		_enableControllers = true;
+		if(_rollbackManager) {
+			_rollbackManager->Enable();
+		}
+		InitControlDevice();
+		_console->Resume();
+
+		if(!_joined) {
+			_joined = true;
+			_joinTime = _joinTimer.GetElapsedMS();
+			MessageManager::Log("[Netplay] Joined game in " + std::to_string((int)_joinTime) + " ms (state: " + std::to_string(message->GetOriginalSize()) + " bytes, " + std::to_string(message->GetCompressedSize()) + " bytes compressed)");
+		}
+
+		SaveStateAckMessage ack(stateId);
+		SendNetMessage(ack);
+	} else {
+		//The delta could not be applied, ask the server for a full state
+		_console->Resume();
+		_baseStates.clear();
+		MessageManager::Log("[Netplay] Could not load state received from server, requesting full state.");
+
+		SaveStateAckMessage ack(0);
+		SendNetMessage(ack);
+	}
+}
+
+NetPlayStatistics GameClientConnection::GetStatistics()
+{
+	NetPlayStatistics stats = GameConnection::GetStatistics();
+	stats.JoinTime = _joinTime;
+	return stats;
+}
+
 void GameClientConnection::ProcessMessage(NetMessage* message)
 {
 	GameInformationMessage* gameInfo;
@@ -83,13 +157,7 @@ void GameClientConnection::ProcessMessage(NetMessage* message)
 
 		case MessageType::SaveState:
 			if(_gameLoaded) {
-				DisableControllers();
-				_console->Pause();
-				ClearInputData();
-				((SaveStateMessage*)message)->LoadState(_console);
-				_enableControllers = true;
-				InitControlDevice();
-				_console->Resume();
+				ProcessSaveState((SaveStateMessage*)message);
 			}
 			break;
 
@@ -153,6 +221,11 @@ bool GameClientConnection::AttemptLoadGame(string filename, uint32_t crc32Hash)
 
 void GameClientConnection::PushControllerState(uint8_t port, ControlDeviceState state)
 {
+	if(_rollbackManager) {
+		_rollbackManager->AddConfirmedInput(port, state);
+		return;
+	}
+
 	LockHandler lock = _writeLock.AcquireSafe();
 	_inputData[port].push_back(state);
 	_inputSize[port]++;
@@ -167,6 +240,9 @@ void GameClientConnection::DisableControllers()
 	//Used to prevent deadlocks when client is trying to fill its buffer while the host changes the current game/settings/etc. (i.e situations where we need to call Console::Pause())
 	ClearInputData();
 	_enableControllers = false;
+	if(_rollbackManager) {
+		_rollbackManager->Disable();
+	}
 	for(int i = 0; i < BaseControlDevice::PortCount; i++) {
 		_waitForInput[i].Signal();
 	}
@@ -174,7 +250,16 @@ void GameClientConnection::DisableControllers()
 
 bool GameClientConnection::SetInput(BaseControlDevice *device)
 {
-	if(_enableControllers) {
+	if(_enableControllers && _rollbackManager) {
+		_rollbackManager->SetInput(device);
+
+		if(_rollbackManager->GetPendingInputCount() > 2) {
+			//Emulation is behind the server, catch up
+			_console->GetSettings()->SetFlags(EmulationFlags::ForceMaxSpeed);
+		} else {
+			_console->GetSettings()->ClearFlags(EmulationFlags::ForceMaxSpeed);
+		}
+	} else if(_enableControllers) {
 		uint8_t port = device->GetPort();
 		while(_inputSize[port] == 0) {
 			_waitForInput[port].Wait();
@@ -240,6 +325,11 @@ void GameClientConnection::SendInput()
 			inputState = _controlDevice->GetRawState();
 		}
 		
+		if(_rollbackManager) {
+			//Used to predict our own input until the server sends it back
+			_rollbackManager->SetLocalInput(_controllerPort, inputState);
+		}
+
 		if(_lastInputSent != inputState) {
 			InputDataMessage message(inputState);
 			SendNetMessage(message);
@@ -267,4 +357,13 @@ uint8_t GameClientConnection::GetAvailableControllers()
 uint8_t GameClientConnection::GetControllerPort()
 {
 	return _controllerPort;
+}
+
+bool GameClientConnection::GetRollbackStatistics(RollbackStatistics &stats)
+{
+	if(_rollbackManager) {
+		stats = _rollbackManager->GetStatistics();
+		return true;
+	}
+	return false;
 }
\ No newline at end of file
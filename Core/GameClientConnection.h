@@ -4,12 +4,16 @@
 #include "GameConnection.h"
 #include "../Utilities/AutoResetEvent.h"
 #include "../Utilities/SimpleLock.h"
+#include "../Utilities/Timer.h"
 #include "BaseControlDevice.h"
 #include "IInputProvider.h"
 #include "ControlDeviceState.h"
 #include "ClientConnectionData.h"
 
 class Console;
+class RollbackManager;
+class SaveStateMessage;
+struct RollbackStatistics;
 
 class GameClientConnection : public GameConnection, public INotificationListener, public IInputProvider
 {
@@ -23,6 +27,7 @@ private:
 	atomic<uint32_t> _minimumQueueSize;
 
 	vector<PlayerInfo> _playerList;
+	shared_ptr<RollbackManager> _rollbackManager;
 
 	shared_ptr<BaseControlDevice> _controlDevice;
 	shared_ptr<BaseControlDevice> _newControlDevice;
@@ -32,6 +37,15 @@ private:
 	ClientConnectionData _connectionData;
 	string _serverSalt;
 
+	//Most recent states loaded from the server (and acknowledged), keyed by state ID - used as the base of delta-compressed states
+	//The server uses the last state it got an acknowledgement for, which can be older than the last state loaded when the ack is still in transit
+	static constexpr size_t MaxBaseStates = 4;
+	std::deque<std::pair<uint32_t, vector<uint8_t>>> _baseStates;
+
+	Timer _joinTimer;
+	bool _joined = false;
+	atomic<double> _joinTime;
+
 private:
 	void SendHandshake();
 	void SendControllerSelection(uint8_t port);
@@ -39,6 +53,7 @@ private:
 	void PushControllerState(uint8_t port, ControlDeviceState state);
 	void DisableControllers();
 	bool AttemptLoadGame(string filename, uint32_t crc32Hash);
+	void ProcessSaveState(SaveStateMessage* message);
 
 protected:
 	void ProcessMessage(NetMessage* message) override;
@@ -58,4 +73,7 @@ public:
 	void SelectController(uint8_t port);
 	uint8_t GetAvailableControllers();
 	uint8_t GetControllerPort();
+
+	bool GetRollbackStatistics(RollbackStatistics &stats);
+	NetPlayStatistics GetStatistics() override;
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "stdafx.h"
+#include <random>
 #include "GameConnection.h"
 #include "HandShakeMessage.h"
 #include "InputDataMessage.h"
@@ -10,6 +11,7 @@
 #include "ClientConnectionData.h"
 #include "ForceDisconnectMessage.h"
 #include "ServerInformationMessage.h"
+#include "SaveStateAckMessage.h"
 
 GameConnection::GameConnection(shared_ptr<Console> console, shared_ptr<Socket> socket)
 {
@@ -17,16 +19,72 @@ GameConnection::GameConnection(shared_ptr<Console> console, shared_ptr<Socket> s
 	_socket = socket;
 }
 
+GameConnection::~GameConnection()
+{
+	for(std::pair<double, NetMessage*> &msg : _delayedMessages) {
+		delete msg.second;
+	}
+}
+
+void GameConnection::SetLatencyHistogram(MessageLatencyHistogram* histogram)
+{
+	_latencyHistogram = histogram;
+}
+
+Socket* GameConnection::GetSocket()
+{
+	return _socket.get();
+}
+
+void GameConnection::SetNetworkSimulation(uint32_t latency, uint32_t packetLoss)
+{
+	_simulatedLatency = latency;
+	_simulatedPacketLoss = packetLoss;
+}
+
+NetMessage* GameConnection::ReadDelayedMessage(double &receiveTime)
+{
+	//Simulates a slow/unreliable connection: messages are kept in a queue until their delivery time is reached
+	//Since netplay runs over TCP, lost packets are simulated as retransmission delays (messages are never reordered)
+	static std::mt19937 random(std::random_device{}());
+
+	NetMessage* message;
+	double messageReceiveTime;
+	while((message = ReadMessage(messageReceiveTime)) != nullptr) {
+		double deliveryTime = messageReceiveTime + _simulatedLatency;
+		if(_simulatedPacketLoss > 0 && random() % 100 < _simulatedPacketLoss) {
+			deliveryTime += std::max<uint32_t>(_simulatedLatency * 2, 200);
+		}
+		if(!_delayedMessages.empty()) {
+			deliveryTime = std::max(deliveryTime, _delayedMessages.back().first);
+		}
+		_delayedMessages.push_back({ deliveryTime, message });
+	}
+
+	if(!_delayedMessages.empty() && _delayedMessages.front().first <= _networkTimer.GetElapsedMS()) {
+		//The message is considered as received at the end of its simulated delay
+		receiveTime = _delayedMessages.front().first;
+		message = _delayedMessages.front().second;
+		_delayedMessages.pop_front();
+		return message;
+	}
+	return nullptr;
+}
+
 void GameConnection::ReadSocket()
 {
 	auto lock = _socketLock.AcquireSafe();
 	int bytesReceived = _socket->Recv((char*)_readBuffer + _readPosition, 0x40000 - _readPosition, 0);
 	if(bytesReceived > 0) {
 		_readPosition += bytesReceived;
+		_receiveTimes.push_back({ _readPosition, _networkTimer.GetElapsedMS() });
+
+		auto statsLock = _statsLock.AcquireSafe();
+		_netStats.BytesReceived += bytesReceived;
 	}
 }
 
-bool GameConnection::ExtractMessage(void *buffer, uint32_t &messageLength)
+bool GameConnection::ExtractMessage(void *buffer, uint32_t &messageLength, double &receiveTime)
 {
 	messageLength = _readBuffer[0] | (_readBuffer[1] << 8) | (_readBuffer[2] << 16) | (_readBuffer[3] << 24);
 
@@ -42,18 +100,33 @@ bool GameConnection::ExtractMessage(void *buffer, uint32_t &messageLength)
 		memcpy(buffer, _readBuffer+sizeof(messageLength), messageLength);
 		memmove(_readBuffer, _readBuffer + packetLength, _readPosition - packetLength);
 		_readPosition -= packetLength;
+
+		//The message was received when its last byte was
+		receiveTime = 0;
+		for(std::pair<int, double> &block : _receiveTimes) {
+			if(block.first >= packetLength) {
+				receiveTime = block.second;
+				break;
+			}
+		}
+		for(std::pair<int, double> &block : _receiveTimes) {
+			block.first -= packetLength;
+		}
+		while(!_receiveTimes.empty() && _receiveTimes.front().first <= 0) {
+			_receiveTimes.pop_front();
+		}
 		return true;
 	}
 	return false;
 }
 
-NetMessage* GameConnection::ReadMessage()
+NetMessage* GameConnection::ReadMessage(double &receiveTime)
 {
 	ReadSocket();
 
 	if(_readPosition > 4) {
 		uint32_t messageLength;
-		if(ExtractMessage(_messageBuffer, messageLength)) {
+		if(ExtractMessage(_messageBuffer, messageLength, receiveTime)) {
 			switch((MessageType)_messageBuffer[0]) {
 				case MessageType::HandShake: return new HandShakeMessage(_messageBuffer, messageLength);
 				case MessageType::SaveState: return new SaveStateMessage(_messageBuffer, messageLength);
@@ -64,6 +137,7 @@ NetMessage* GameConnection::ReadMessage()
 				case MessageType::SelectController: return new SelectControllerMessage(_messageBuffer, messageLength);
 				case MessageType::ForceDisconnect: return new ForceDisconnectMessage(_messageBuffer, messageLength);
 				case MessageType::ServerInformation: return new ServerInformationMessage(_messageBuffer, messageLength);
+				case MessageType::SaveStateAck: return new SaveStateAckMessage(_messageBuffer, messageLength);
 			}
 		}
 	}
@@ -73,7 +147,43 @@ NetMessage* GameConnection::ReadMessage()
 void GameConnection::SendNetMessage(NetMessage &message)
 {
 	auto lock = _socketLock.AcquireSafe();
-	message.Send(*_socket.get());
+	uint32_t bytesSent = message.Send(*_socket.get());
+
+	auto statsLock = _statsLock.AcquireSafe();
+	_netStats.BytesSent += bytesSent;
+}
+
+void GameConnection::SendSerializedMessages(vector<shared_ptr<vector<uint8_t>>> &buffers)
+{
+	vector<SocketBuffer> socketBuffers;
+	socketBuffers.reserve(buffers.size());
+	for(shared_ptr<vector<uint8_t>> &buffer : buffers) {
+		socketBuffers.push_back({ (char*)buffer->data(), (int)buffer->size() });
+	}
+
+	auto lock = _socketLock.AcquireSafe();
+	uint32_t bytesSent = _socket->GatherSend(socketBuffers);
+
+	auto statsLock = _statsLock.AcquireSafe();
+	_netStats.BytesSent += bytesSent;
+}
+
+void GameConnection::RecordStateTransfer(SaveStateMessage &message)
+{
+	auto lock = _statsLock.AcquireSafe();
+	_netStats.StateCount++;
+	if(message.GetBaseStateId() != 0) {
+		_netStats.DeltaStateCount++;
+	}
+	_netStats.StateBytes += message.GetCompressedSize();
+	_netStats.LastStateSize = message.GetOriginalSize();
+	_netStats.LastStateCompressedSize = message.GetCompressedSize();
+}
+
+NetPlayStatistics GameConnection::GetStatistics()
+{
+	auto lock = _statsLock.AcquireSafe();
+	return _netStats;
 }
 
 void GameConnection::Disconnect()
@@ -90,10 +200,16 @@ bool GameConnection::ConnectionError()
 void GameConnection::ProcessMessages()
 {
 	NetMessage* message;
-	while((message = ReadMessage()) != nullptr) {
+	double receiveTime;
+	while((message = (_simulatedLatency || _simulatedPacketLoss) ? ReadDelayedMessage(receiveTime) : ReadMessage(receiveTime)) != nullptr) {
 		//Loop until all messages have been processed
+		//Latency is measured separately for each message, from the moment its bytes were received until it has been handled
+		//(includes the time spent waiting in the read buffer while the previous messages were processed)
 		message->Initialize();
 		ProcessMessage(message);
+		if(_latencyHistogram) {
+			_latencyHistogram->AddValue((uint8_t)message->GetType(), _networkTimer.GetElapsedMS() - receiveTime);
+		}
 		delete message;
 	}		
 }
\ No newline at end of file
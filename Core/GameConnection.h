@@ -1,10 +1,57 @@
 #pragma once
 #include "stdafx.h"
+#include <deque>
 #include "../Utilities/SimpleLock.h"
+#include "../Utilities/Timer.h"
 
 class Socket;
 class NetMessage;
 class Console;
+class SaveStateMessage;
+
+struct MessageLatencyHistogram
+{
+	//Upper bound (in microseconds) of each bucket - the last bucket contains everything above 10ms
+	static constexpr uint32_t BucketLimits[8] = { 50, 100, 250, 500, 1000, 2000, 5000, 10000 };
+	static constexpr int BucketCount = 9;
+	static constexpr int MessageTypeCount = 10;
+
+	uint32_t Counts[MessageTypeCount][BucketCount] = {};
+	double MaxLatency[MessageTypeCount] = {};
+	double TotalLatency[MessageTypeCount] = {};
+
+	void AddValue(uint8_t messageType, double latencyMs)
+	{
+		if(messageType >= MessageTypeCount) {
+			return;
+		}
+
+		uint32_t latencyUs = (uint32_t)(latencyMs * 1000);
+		int bucket = 0;
+		while(bucket < BucketCount - 1 && latencyUs > BucketLimits[bucket]) {
+			bucket++;
+		}
+		Counts[messageType][bucket]++;
+		TotalLatency[messageType] += latencyMs;
+		MaxLatency[messageType] = std::max(MaxLatency[messageType], latencyMs);
+	}
+};
+
+struct NetPlayStatistics
+{
+	uint64_t BytesSent;
+	uint64_t BytesReceived;
+
+	//Save states sent/received on connection and on every resync (game reset, state loaded, etc.)
+	uint32_t StateCount;
+	uint32_t DeltaStateCount;
+	uint64_t StateBytes;
+	uint32_t LastStateSize;
+	uint32_t LastStateCompressedSize;
+
+	//Time between the connection and the first state being loaded (client-side only)
+	double JoinTime;
+};
 
 struct PlayerInfo
 {
@@ -24,22 +71,44 @@ protected:
 	int _readPosition = 0;
 	SimpleLock _socketLock;
 
+	//End position (in _readBuffer) and time of each block of data received, used to know when each message's bytes arrived
+	std::deque<std::pair<int, double>> _receiveTimes;
+
+	uint32_t _simulatedLatency = 0;
+	uint32_t _simulatedPacketLoss = 0;
+	std::deque<std::pair<double, NetMessage*>> _delayedMessages;
+	Timer _networkTimer;
+
+	MessageLatencyHistogram* _latencyHistogram = nullptr;
+
+	NetPlayStatistics _netStats = {};
+	SimpleLock _statsLock;
+
 private:
 	void ReadSocket();
 
-	bool ExtractMessage(void *buffer, uint32_t &messageLength);
-	NetMessage* ReadMessage();
+	bool ExtractMessage(void *buffer, uint32_t &messageLength, double &receiveTime);
+	NetMessage* ReadMessage(double &receiveTime);
+	NetMessage* ReadDelayedMessage(double &receiveTime);
 
 	virtual void ProcessMessage(NetMessage* message) = 0;
 
 protected:
 	void Disconnect();
+	void RecordStateTransfer(SaveStateMessage &message);
 
 public:
 	static constexpr uint8_t SpectatorPort = 0xFF;
 	GameConnection(shared_ptr<Console> console, shared_ptr<Socket> socket);
+	virtual ~GameConnection();
+
+	void SetNetworkSimulation(uint32_t latency, uint32_t packetLoss);
+	void SetLatencyHistogram(MessageLatencyHistogram* histogram);
+	Socket* GetSocket();
+	virtual NetPlayStatistics GetStatistics();
 
 	bool ConnectionError();
 	void ProcessMessages();
 	void SendNetMessage(NetMessage &message);
+	void SendSerializedMessages(vector<shared_ptr<vector<uint8_t>>> &buffers);
 };
\ No newline at end of file
@@ -8,11 +8,12 @@ using std::thread;
 #include "ControlManager.h"
 #include "../Utilities/Socket.h"
 #include "PlayerListMessage.h"
+#include "MovieDataMessage.h"
 #include "NotificationManager.h"
 
 shared_ptr<GameServer> GameServer::Instance;
 
-GameServer::GameServer(shared_ptr<Console> console, uint16_t listenPort, string password, string hostPlayerName)
+GameServer::GameServer(shared_ptr<Console> console, uint16_t listenPort, string password, string hostPlayerName, uint32_t spectatorBufferSize)
 {
 	_console = console;
 	_stop = false;
@@ -20,6 +21,7 @@ GameServer::GameServer(shared_ptr<Console> console, uint16_t listenPort, string
 	_password = password;
 	_hostPlayerName = hostPlayerName;
 	_hostControllerPort = 0;
+	_spectatorBufferSize = std::max<uint32_t>(spectatorBufferSize, 1);
 
 	//If a game is already running, register ourselves as an input recorder/provider right away
 	RegisterServerInput();
@@ -54,7 +56,11 @@ void GameServer::AcceptConnections()
 		shared_ptr<Socket> socket = _listener->Accept();
 		if(!socket->ConnectionError()) {
 			auto connection = shared_ptr<GameServerConnection>(new GameServerConnection(_console, socket, _password));
-			_console->GetNotificationManager()->RegisterNotificationListener(connection);
+			connection->SetLatencyHistogram(&_latencyHistogram);
+			_console->GetNotificationManager()->RegisterNotificationListener(connection, {
+				ConsoleNotificationType::GamePaused, ConsoleNotificationType::GameResumed, ConsoleNotificationType::GameReset, ConsoleNotificationType::StateLoaded,
+				ConsoleNotificationType::CheatAdded, ConsoleNotificationType::ConfigChanged, ConsoleNotificationType::GameInitCompleted
+			});
 			_openConnections.push_back(connection);
 		} else {
 			break;
@@ -63,15 +69,18 @@ void GameServer::AcceptConnections()
 	_listener->Listen(10);
 }
 
-void GameServer::UpdateConnections()
+void GameServer::UpdateConnections(vector<bool> &readable)
 {
+	//readable[0] is the listener, readable[1..n] match the order of _openConnections
 	vector<shared_ptr<GameServerConnection>> connectionsToRemove;
+	size_t i = 1;
 	for(shared_ptr<GameServerConnection> connection : _openConnections) {
 		if(connection->ConnectionError()) {
 			connectionsToRemove.push_back(connection);
-		} else {
+		} else if(i < readable.size() && readable[i]) {
 			connection->ProcessMessages();
 		}
+		i++;
 	}
 
 	for(shared_ptr<GameServerConnection> gameConnection : connectionsToRemove) {
@@ -105,12 +114,49 @@ bool GameServer::SetInput(BaseControlDevice *device)
 
 void GameServer::RecordInput(vector<shared_ptr<BaseControlDevice>> devices)
 {
+	//Serialize this frame's input once - the same buffer is sent as-is to every client
+	shared_ptr<vector<uint8_t>> frameData(new vector<uint8_t>());
 	for(shared_ptr<BaseControlDevice> &device : devices) {
-		for(shared_ptr<GameServerConnection> connection : _openConnections) {
-			if(!connection->ConnectionError()) {
-				//Send movie stream
-				connection->SendMovieData(device->GetPort(), device->GetRawState());
-			}
+		MovieDataMessage message(device->GetRawState(), device->GetPort());
+		message.Serialize(*frameData);
+	}
+
+	if(frameData->empty()) {
+		return;
+	}
+
+	//Players get the input right away, to keep their input lag as low as possible
+	vector<shared_ptr<vector<uint8_t>>> frames = { frameData };
+	for(shared_ptr<GameServerConnection> connection : _openConnections) {
+		if(!connection->ConnectionError() && !connection->IsSpectator()) {
+			connection->SendInputStream(frames);
+		}
+	}
+
+	auto lock = _spectatorLock.AcquireSafe();
+	_spectatorFrames.push_back(frameData);
+	if(_spectatorFrames.size() >= _spectatorBufferSize) {
+		SendSpectatorFrames();
+	}
+}
+
+void GameServer::SendSpectatorFrames()
+{
+	//Sends all buffered frames to each spectator in a single write
+	for(shared_ptr<GameServerConnection> connection : _openConnections) {
+		if(!connection->ConnectionError() && connection->IsSpectator()) {
+			connection->SendInputStream(_spectatorFrames);
+		}
+	}
+	_spectatorFrames.clear();
+}
+
+void GameServer::FlushSpectatorInput()
+{
+	if(GameServer::Started()) {
+		auto lock = Instance->_spectatorLock.AcquireSafe();
+		if(!Instance->_spectatorFrames.empty()) {
+			Instance->SendSpectatorFrames();
 		}
 	}
 }
@@ -132,11 +178,57 @@ void GameServer::Exec()
 	_initialized = true;
 	MessageManager::DisplayMessage("NetPlay" , "ServerStarted", std::to_string(_port));
 
+	vector<Socket*> sockets;
+	vector<bool> readable;
 	while(!_stop) {
-		AcceptConnections();
-		UpdateConnections();
+		if(_listener->ConnectionError()) {
+			//Could not bind/listen on the port, there is nothing to wait for
+			std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(50));
+			continue;
+		}
+
+		sockets.clear();
+		sockets.push_back(_listener.get());
+		for(shared_ptr<GameServerConnection> &connection : _openConnections) {
+			sockets.push_back(connection->GetSocket());
+		}
 
-		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(1));
+		//Sleep until a client sends data or connects - input is sent to the clients by the emulation thread, so
+		//the only reason to wake up without network activity is to check whether the server needs to stop
+		Socket::Poll(sockets, readable, 50);
+
+		if(readable[0]) {
+			AcceptConnections();
+		}
+		UpdateConnections(readable);
+	}
+
+	LogLatencyStatistics();
+}
+
+void GameServer::LogLatencyStatistics()
+{
+	static const char* messageTypeNames[MessageLatencyHistogram::MessageTypeCount] = { "HandShake", "SaveState", "InputData", "MovieData", "GameInformation", "PlayerList", "SelectController", "ForceDisconnect", "ServerInformation", "SaveStateAck" };
+
+	for(int i = 0; i < MessageLatencyHistogram::MessageTypeCount; i++) {
+		uint32_t total = 0;
+		for(int j = 0; j < MessageLatencyHistogram::BucketCount; j++) {
+			total += _latencyHistogram.Counts[i][j];
+		}
+
+		if(total > 0) {
+			std::stringstream ss;
+			ss << "[Netplay] " << messageTypeNames[i] << ": " << total << " messages, avg: " << std::fixed << std::setprecision(3) << (_latencyHistogram.TotalLatency[i] / total) << " ms, max: " << _latencyHistogram.MaxLatency[i] << " ms |";
+			for(int j = 0; j < MessageLatencyHistogram::BucketCount; j++) {
+				if(j < MessageLatencyHistogram::BucketCount - 1) {
+					ss << " <=" << MessageLatencyHistogram::BucketLimits[j] << "us: ";
+				} else {
+					ss << " >" << MessageLatencyHistogram::BucketLimits[j - 1] << "us: ";
+				}
+				ss << _latencyHistogram.Counts[i][j];
+			}
+			MessageManager::Log(ss.str());
+		}
 	}
 }
 
@@ -147,10 +239,10 @@ void GameServer::Stop()
 	MessageManager::DisplayMessage("NetPlay", "ServerStopped");
 }
 
-void GameServer::StartServer(shared_ptr<Console> console, uint16_t port, string password, string hostPlayerName)
+void GameServer::StartServer(shared_ptr<Console> console, uint16_t port, string password, string hostPlayerName, uint32_t spectatorBufferSize)
 {
-	Instance.reset(new GameServer(console, port, password, hostPlayerName));
-	console->GetNotificationManager()->RegisterNotificationListener(Instance);
+	Instance.reset(new GameServer(console, port, password, hostPlayerName, spectatorBufferSize));
+	console->GetNotificationManager()->RegisterNotificationListener(Instance, { ConsoleNotificationType::GameLoaded });
 	Instance->_serverThread.reset(new thread(&GameServer::Exec, Instance.get()));
 }
 
@@ -230,6 +322,25 @@ vector<PlayerInfo> GameServer::GetPlayerList()
 	return playerList;
 }
 
+NetPlayStatistics GameServer::GetStatistics()
+{
+	//Totals for all connected clients
+	NetPlayStatistics total = {};
+	for(shared_ptr<GameServerConnection> &connection : GetConnectionList()) {
+		NetPlayStatistics stats = connection->GetStatistics();
+		total.BytesSent += stats.BytesSent;
+		total.BytesReceived += stats.BytesReceived;
+		total.StateCount += stats.StateCount;
+		total.DeltaStateCount += stats.DeltaStateCount;
+		total.StateBytes += stats.StateBytes;
+		if(stats.StateCount > 0) {
+			total.LastStateSize = stats.LastStateSize;
+			total.LastStateCompressedSize = stats.LastStateCompressedSize;
+		}
+	}
+	return total;
+}
+
 void GameServer::SendPlayerList()
 {
 	vector<PlayerInfo> playerList = GetPlayerList();
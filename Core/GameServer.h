@@ -21,23 +21,31 @@ private:
 	string _password;
 	list<shared_ptr<GameServerConnection>> _openConnections;
 	bool _initialized = false;
+	MessageLatencyHistogram _latencyHistogram;
+
+	//Spectators all receive the same input stream - it is serialized once per frame and sent every [_spectatorBufferSize] frames
+	uint32_t _spectatorBufferSize;
+	vector<shared_ptr<vector<uint8_t>>> _spectatorFrames;
+	SimpleLock _spectatorLock;
 
 	string _hostPlayerName;
 	uint8_t _hostControllerPort;
 
 	void AcceptConnections();
-	void UpdateConnections();
+	void UpdateConnections(vector<bool> &readable);
+	void LogLatencyStatistics();
+	void SendSpectatorFrames();
 
 	void Exec();
 	void Stop();
 
 public:
-	GameServer(shared_ptr<Console> console, uint16_t port, string password, string hostPlayerName);
+	GameServer(shared_ptr<Console> console, uint16_t port, string password, string hostPlayerName, uint32_t spectatorBufferSize);
 	virtual ~GameServer();
 
 	void RegisterServerInput();
 
-	static void StartServer(shared_ptr<Console> console, uint16_t port, string password, string hostPlayerName);
+	static void StartServer(shared_ptr<Console> console, uint16_t port, string password, string hostPlayerName, uint32_t spectatorBufferSize = 1);
 	static void StopServer();
 	static bool Started();
 
@@ -47,6 +55,8 @@ public:
 	static uint8_t GetAvailableControllers();
 	static vector<PlayerInfo> GetPlayerList();
 	static void SendPlayerList();
+	static void FlushSpectatorInput();
+	static NetPlayStatistics GetStatistics();
 
 	static list<shared_ptr<GameServerConnection>> GetConnectionList();
 
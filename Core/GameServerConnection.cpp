@@ -7,6 +7,7 @@
 #include "MovieDataMessage.h"
 #include "GameInformationMessage.h"
 #include "SaveStateMessage.h"
+#include "SaveStateAckMessage.h"
 #include "Console.h"
 #include "ControlManager.h"
 #include "ClientConnectionData.h"
@@ -58,19 +59,68 @@ void GameServerConnection::SendServerInformation()
 void GameServerConnection::SendGameInformation()
 {
 	_console->Pause();
+
+	//Input that is still buffered for spectators must reach them before the new state (it is discarded when the state is loaded)
+	GameServer::FlushSpectatorInput();
+
 	RomInfo romInfo = _console->GetRomInfo();
 	GameInformationMessage gameInfo(romInfo.RomName, romInfo.Hash.Crc32, _controllerPort, _console->GetSettings()->CheckFlag(EmulationFlags::Paused));
 	SendNetMessage(gameInfo);
-	SaveStateMessage saveState(_console);
+
+	uint32_t stateId;
+	uint32_t baseStateId;
+	vector<uint8_t> baseState;
+	{
+		auto lock = _stateLock.AcquireSafe();
+		stateId = _nextStateId++;
+		baseStateId = _ackedStateId;
+		baseState = _ackedState;
+	}
+
+	SaveStateMessage saveState(_console, stateId, baseStateId, baseState);
 	SendNetMessage(saveState);
+	RecordStateTransfer(saveState);
+
+	{
+		auto lock = _stateLock.AcquireSafe();
+		_pendingStates.push_back({ stateId, std::move(saveState.GetRawState()) });
+		while(_pendingStates.size() > 4) {
+			//Client is not acknowledging the states (or is very slow to do so), only keep the most recent ones
+			_pendingStates.pop_front();
+		}
+	}
 	_console->Resume();
 }
 
-void GameServerConnection::SendMovieData(uint8_t port, ControlDeviceState state)
+void GameServerConnection::ProcessStateAck(uint32_t stateId)
+{
+	if(stateId == 0) {
+		//Client could not load the last delta (e.g it no longer has the base state), send a full state instead
+		{
+			auto lock = _stateLock.AcquireSafe();
+			_ackedStateId = 0;
+			_ackedState.clear();
+			_pendingStates.clear();
+		}
+		SendGameInformation();
+		return;
+	}
+
+	auto lock = _stateLock.AcquireSafe();
+	while(!_pendingStates.empty() && _pendingStates.front().first <= stateId) {
+		if(_pendingStates.front().first == stateId) {
+			_ackedStateId = stateId;
+			_ackedState = std::move(_pendingStates.front().second);
+		}
+		_pendingStates.pop_front();
+	}
+}
+
+void GameServerConnection::SendInputStream(vector<shared_ptr<vector<uint8_t>>> &frames)
 {
 	if(_handshakeCompleted) {
-		MovieDataMessage message(state, port);
-		SendNetMessage(message);
+		//Each buffer contains the MovieData messages for a frame, serialized once by the server for all clients
+		SendSerializedMessages(frames);
 	}
 }
 
@@ -157,6 +207,14 @@ void GameServerConnection::ProcessMessage(NetMessage* message)
 			SelectControllerPort(((SelectControllerMessage*)message)->GetPortNumber());
 			break;
 
+		case MessageType::SaveStateAck:
+			if(!_handshakeCompleted) {
+				SendForceDisconnectMessage("Handshake has not been completed - invalid packet");
+				return;
+			}
+			ProcessStateAck(((SaveStateAckMessage*)message)->GetStateId());
+			break;
+
 		default:
 			break;
 	}
@@ -245,4 +303,9 @@ string GameServerConnection::GetPlayerName()
 uint8_t GameServerConnection::GetControllerPort()
 {
 	return _controllerPort;
+}
+
+bool GameServerConnection::IsSpectator()
+{
+	return _controllerPort == GameConnection::SpectatorPort;
 }
\ No newline at end of file
@@ -20,9 +20,18 @@ private:
 	string _serverPassword;
 	bool _handshakeCompleted = false;
 
+	//States sent to the client that have not been acknowledged yet, and the last state the client confirmed it loaded
+	//The acknowledged state is used as the base for the next delta-compressed state sent to the client
+	SimpleLock _stateLock;
+	uint32_t _nextStateId = 1;
+	std::deque<std::pair<uint32_t, vector<uint8_t>>> _pendingStates;
+	uint32_t _ackedStateId = 0;
+	vector<uint8_t> _ackedState;
+
 	void PushState(ControlDeviceState state);
 	void SendServerInformation();
 	void SendGameInformation();
+	void ProcessStateAck(uint32_t stateId);
 	void SelectControllerPort(uint8_t port);
 
 	void SendForceDisconnectMessage(string disconnectMessage);
@@ -41,10 +50,11 @@ public:
 	virtual ~GameServerConnection();
 
 	ControlDeviceState GetState();
-	void SendMovieData(uint8_t port, ControlDeviceState state);
+	void SendInputStream(vector<shared_ptr<vector<uint8_t>>> &frames);
 
 	string GetPlayerName();
 	uint8_t GetControllerPort();
+	bool IsSpectator();
 
 	virtual void ProcessNotification(ConsoleNotificationType type, void* parameter) override;
 
@@ -7,7 +7,7 @@
 class HandShakeMessage : public NetMessage
 {
 private:
-	static constexpr int CurrentVersion = 2;
+	static constexpr int CurrentVersion = 3;
 	uint32_t _mesenVersion = 0;
 	uint32_t _protocolVersion = CurrentVersion;
 	char* _playerName = nullptr;
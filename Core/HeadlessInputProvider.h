@@ -0,0 +1,31 @@
+#pragma once
+#include "stdafx.h"
+#include "IInputProvider.h"
+#include "BaseControlDevice.h"
+#include "ControlDeviceState.h"
+
+//Input used by headless mode: the raw state of each port's device (same format as the device's state in movies) is set by the caller and kept until it is changed
+class HeadlessInputProvider : public IInputProvider
+{
+private:
+	ControlDeviceState _states[BaseControlDevice::PortCount];
+
+public:
+	void SetDeviceState(uint8_t port, ControlDeviceState state)
+	{
+		if(port < BaseControlDevice::PortCount) {
+			_states[port] = state;
+		}
+	}
+
+	bool SetInput(BaseControlDevice* device) override
+	{
+		ControlDeviceState &state = _states[device->GetPort()];
+		if(state.State.empty()) {
+			return false;
+		}
+
+		device->SetRawState(state);
+		return true;
+	}
+};
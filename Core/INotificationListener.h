@@ -26,6 +26,7 @@ enum class ConsoleNotificationType
 	VsDualSystemStarted = 20,
 	VsDualSystemStopped = 21,
 	GameInitCompleted = 22,
+	StateSaved = 23,
 };
 
 class INotificationListener
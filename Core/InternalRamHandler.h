@@ -7,11 +7,13 @@ class InternalRamHandler : public IMemoryHandler
 {
 private:
 	uint8_t *_internalRam;
+	uint8_t *_dirtyPages = nullptr;
 
 public:
-	void SetInternalRam(uint8_t* internalRam)
+	void SetInternalRam(uint8_t* internalRam, uint8_t* dirtyPages = nullptr)
 	{
 		_internalRam = internalRam;
+		_dirtyPages = dirtyPages;
 	}
 
 	void GetMemoryRanges(MemoryRanges &ranges) override
@@ -33,5 +35,8 @@ public:
 	void WriteRAM(uint16_t addr, uint8_t value) override
 	{
 		_internalRam[addr & Mask] = value;
+		if(_dirtyPages) {
+			_dirtyPages[(addr & Mask) >> 8] = 1;
+		}
 	}
 };
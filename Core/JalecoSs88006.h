@@ -75,7 +75,15 @@ class JalecoSs88006 : public BaseMapper
 		virtual void ProcessCpuClock() override
 		{
 			//Clock irq counter every memory read/write (each cpu cycle either reads or writes memory)
-			ClockIrqCounter();
+			//The counter is only updated when its value is needed (on the cycle the IRQ occurs, before writes to the IRQ registers and when saving a state)
+			ClockIrqCounter(TakePendingCpuClocks());
+
+			if(_irqEnabled) {
+				uint16_t counter = _irqCounter & _irqMask[_irqCounterSize];
+				SetCpuClockPeriod(counter == 0 ? _irqMask[_irqCounterSize] + 1 : counter);
+			} else {
+				SetCpuClockPeriod(0);
+			}
 		}
 
 		void ReloadIrqCounter()
@@ -83,16 +91,20 @@ class JalecoSs88006 : public BaseMapper
 			_irqCounter = _irqReloadValue[0] | (_irqReloadValue[1] << 4) | (_irqReloadValue[2] << 8) | (_irqReloadValue[3] << 12);
 		}
 
-		void ClockIrqCounter()
+		void ClockIrqCounter(uint32_t cycles)
 		{
 			if(_irqEnabled) {
-				uint16_t counter = _irqCounter & _irqMask[_irqCounterSize];
+				uint16_t mask = _irqMask[_irqCounterSize];
+				uint16_t counter = _irqCounter & mask;
 
-				if(--counter == 0) {
+				//The IRQ occurs when the counter goes from 1 to 0
+				uint32_t cyclesToIrq = counter == 0 ? mask + 1 : counter;
+				if(cycles >= cyclesToIrq) {
 					_console->GetCpu()->SetIrqSource(IRQSource::External);
 				}
 
-				_irqCounter = (_irqCounter & ~_irqMask[_irqCounterSize]) | (counter & _irqMask[_irqCounterSize]);
+				counter -= cycles;
+				_irqCounter = (_irqCounter & ~mask) | (counter & mask);
 			}
 		}
 
@@ -120,11 +132,15 @@ class JalecoSs88006 : public BaseMapper
 					break;
 
 				case 0xF000:
+					//Catch up to the current cycle before the write, and reschedule the next IRQ after it
+					ProcessCpuClock();
 					_console->GetCpu()->ClearIrqSource(IRQSource::External);
 					ReloadIrqCounter();
+					ProcessCpuClock();
 					break;
 
 				case 0xF001:
+					ProcessCpuClock();
 					_console->GetCpu()->ClearIrqSource(IRQSource::External);
 					_irqEnabled = (value & 0x01) & 0x01;
 					if(value & 0x08) {
@@ -136,6 +152,7 @@ class JalecoSs88006 : public BaseMapper
 					} else {
 						_irqCounterSize = 0; //16-bit counter
 					}
+					ProcessCpuClock();
 					break;
 
 				case 0xF002:
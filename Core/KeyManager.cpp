@@ -30,6 +30,11 @@ void KeyManager::SetSettings(EmulationSettings* settings)
 	_settings = settings;
 }
 
+EmulationSettings* KeyManager::GetSettings()
+{
+	return _settings;
+}
+
 bool KeyManager::IsKeyPressed(uint32_t keyCode)
 {
 	if(_keyManager != nullptr) {
@@ -18,6 +18,7 @@ private:
 public:
 	static void RegisterKeyManager(IKeyManager* keyManager);
 	static void SetSettings(EmulationSettings* settings);
+	static EmulationSettings* GetSettings();
 
 	static void RefreshKeyState();
 	static bool IsKeyPressed(uint32_t keyCode);
@@ -73,6 +73,9 @@ int LuaApi::GetLibrary(lua_State *lua)
 		{ "removeMemoryCallback", LuaApi::UnregisterMemoryCallback },
 		{ "addEventCallback", LuaApi::RegisterEventCallback },
 		{ "removeEventCallback", LuaApi::UnregisterEventCallback },
+		{ "addMemoryLog", LuaApi::RegisterMemoryLog },
+		{ "removeMemoryLog", LuaApi::UnregisterMemoryLog },
+		{ "flushMemoryLog", LuaApi::FlushMemoryLog },
 		{ "drawString", LuaApi::DrawString },
 		{ "drawPixel", LuaApi::DrawPixel },
 		{ "drawLine", LuaApi::DrawLine },
@@ -366,6 +369,51 @@ int LuaApi::UnregisterEventCallback(lua_State *lua)
 	return l.ReturnCount();
 }
 
+int LuaApi::RegisterMemoryLog(lua_State *lua)
+{
+	LuaCallHelper l(lua);
+	l.ForceParamCount(5);
+	int32_t bufferSize = l.ReadInteger(0x10000);
+	int32_t endAddr = l.ReadInteger(-1);
+	int32_t startAddr = l.ReadInteger();
+	CallbackType type = (CallbackType)l.ReadInteger();
+	int reference = l.GetReference();
+	checkminparams(3);
+
+	if(endAddr == -1) {
+		endAddr = startAddr;
+	}
+
+	errorCond(startAddr > endAddr, "start address must be <= end address");
+	errorCond(bufferSize <= 0 || bufferSize > 0x1000000, "buffer size must be between 1 and 16777216");
+	errorCond(type < CallbackType::CpuRead || type > CallbackType::PpuWrite, "the specified type is invalid");
+	errorCond(reference == LUA_NOREF, "the specified function could not be found");
+	_context->RegisterMemoryLog(type, startAddr, endAddr, bufferSize, reference);
+	_context->Log("Registered memory log from $" + HexUtilities::ToHex((uint32_t)startAddr) + " to $" + HexUtilities::ToHex((uint32_t)endAddr));
+	l.Return(reference);
+	return l.ReturnCount();
+}
+
+int LuaApi::UnregisterMemoryLog(lua_State *lua)
+{
+	LuaCallHelper l(lua);
+	int reference = l.ReadInteger();
+	checkparams();
+	errorCond(reference == LUA_NOREF, "function reference is invalid");
+	_context->UnregisterMemoryLog(reference);
+	return l.ReturnCount();
+}
+
+int LuaApi::FlushMemoryLog(lua_State *lua)
+{
+	LuaCallHelper l(lua);
+	int reference = l.ReadInteger();
+	checkparams();
+	errorCond(reference == LUA_NOREF, "function reference is invalid");
+	errorCond(!_context->FlushMemoryLog(reference), "memory log not found");
+	return l.ReturnCount();
+}
+
 int LuaApi::DrawString(lua_State *lua)
 {
 	LuaCallHelper l(lua);
@@ -30,6 +30,9 @@ public:
 	static int UnregisterMemoryCallback(lua_State *lua);
 	static int RegisterEventCallback(lua_State *lua);
 	static int UnregisterEventCallback(lua_State *lua);
+	static int RegisterMemoryLog(lua_State *lua);
+	static int UnregisterMemoryLog(lua_State *lua);
+	static int FlushMemoryLog(lua_State *lua);
 	
 	static int DrawString(lua_State *lua);
 	static int DrawLine(lua_State *lua);
@@ -33,6 +33,10 @@ LuaScriptingContext::~LuaScriptingContext()
 			}
 		}
 
+		for(MemoryLog &log : _memoryLogs) {
+			references.emplace(log.Reference);
+		}
+
 		for(const int &ref : references) {
 			luaL_unref(_lua, LUA_REGISTRYINDEX, ref);
 		}
@@ -107,6 +111,12 @@ void LuaScriptingContext::UnregisterEventCallback(EventType type, int reference)
 	luaL_unref(_lua, LUA_REGISTRYINDEX, reference);
 }
 
+void LuaScriptingContext::UnregisterMemoryLog(int reference)
+{
+	ScriptingContext::UnregisterMemoryLog(reference);
+	luaL_unref(_lua, LUA_REGISTRYINDEX, reference);
+}
+
 void LuaScriptingContext::InternalCallMemoryCallback(uint16_t addr, uint8_t &value, CallbackType type)
 {
 	if(_callbacks[(int)type][addr].empty()) {
@@ -154,3 +164,48 @@ int LuaScriptingContext::InternalCallEventCallback(EventType type)
 	}
 	return l.ReturnCount();
 }
+
+void LuaScriptingContext::InternalFlushMemoryLog(int reference, vector<MemoryLogEntry> &entries, uint32_t droppedCount)
+{
+	_timer.Reset();
+	_context = this;
+	lua_sethook(_lua, LuaScriptingContext::ExecutionCountHook, LUA_MASKCOUNT, 1000);
+	LuaApi::SetContext(this);
+
+	int top = lua_gettop(_lua);
+	lua_rawgeti(_lua, LUA_REGISTRYINDEX, reference);
+
+	//The whole log is sent as a single table containing 3 arrays (address, value, cycle)
+	int count = (int)entries.size();
+	lua_createtable(_lua, 0, 5);
+	lua_pushinteger(_lua, count);
+	lua_setfield(_lua, -2, "count");
+	lua_pushinteger(_lua, droppedCount);
+	lua_setfield(_lua, -2, "dropped");
+
+	lua_createtable(_lua, count, 0);
+	for(int i = 0; i < count; i++) {
+		lua_pushinteger(_lua, entries[i].Address);
+		lua_rawseti(_lua, -2, i + 1);
+	}
+	lua_setfield(_lua, -2, "address");
+
+	lua_createtable(_lua, count, 0);
+	for(int i = 0; i < count; i++) {
+		lua_pushinteger(_lua, entries[i].Value);
+		lua_rawseti(_lua, -2, i + 1);
+	}
+	lua_setfield(_lua, -2, "value");
+
+	lua_createtable(_lua, count, 0);
+	for(int i = 0; i < count; i++) {
+		lua_pushinteger(_lua, (lua_Integer)entries[i].CpuCycle);
+		lua_rawseti(_lua, -2, i + 1);
+	}
+	lua_setfield(_lua, -2, "cycle");
+
+	if(lua_pcall(_lua, 1, 0, 0) != 0) {
+		Log(lua_tostring(_lua, -1));
+	}
+	lua_settop(_lua, top);
+}
@@ -20,6 +20,7 @@ private:
 protected:
 	void InternalCallMemoryCallback(uint16_t addr, uint8_t &value, CallbackType type) override;
 	int InternalCallEventCallback(EventType type) override;
+	void InternalFlushMemoryLog(int reference, vector<MemoryLogEntry> &entries, uint32_t droppedCount) override;
 
 public:
 	LuaScriptingContext(Debugger* debugger);
@@ -31,4 +32,5 @@ public:
 	
 	void UnregisterMemoryCallback(CallbackType type, int startAddr, int endAddr, int reference) override;
 	void UnregisterEventCallback(EventType type, int reference) override;
+	void UnregisterMemoryLog(int reference) override;
 };
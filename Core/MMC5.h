@@ -221,10 +221,18 @@ private:
 		}
 	}
 
-	void ProcessCpuClock() override
+	void RunExpansionAudio() override
+	{
+		_audio->Run();
+	}
+
+	void ClockExpansionAudio() override
 	{
 		_audio->Clock();
+	}
 
+	void ProcessCpuClock() override
+	{
 		if(_ppuIdleCounter) {
 			_ppuIdleCounter--;
 			if(_ppuIdleCounter == 0) {
@@ -287,6 +295,7 @@ private:
 	{
 		_fillModeTile = tile;
 		memset(GetNametable(NtFillModeIndex), tile, 32 * 30); //32 tiles per row, 30 rows
+		_nametableRamPages.MarkDirty(NtFillModeIndex * BaseMapper::NametableSize, 32 * 30);
 	}
 
 	void SetFillModeColor(uint8_t color)
@@ -294,6 +303,7 @@ private:
 		_fillModeColor = color;
 		uint8_t attributeByte = color | color << 2 | color << 4 | color << 6;
 		memset(GetNametable(NtFillModeIndex) + 32 * 30, attributeByte, 64); //Attribute table is 64 bytes
+		_nametableRamPages.MarkDirty(NtFillModeIndex * BaseMapper::NametableSize + 32 * 30, 64);
 	}
 
 protected:
@@ -395,6 +405,7 @@ protected:
 		_splitTileNumber = -1;
 
 		memset(GetNametable(NtEmptyIndex), 0, BaseMapper::NametableSize);
+		_nametableRamPages.MarkDirty(NtEmptyIndex * BaseMapper::NametableSize, BaseMapper::NametableSize);
 
 		SetExtendedRamMode(0);
 
@@ -82,7 +82,7 @@ protected:
 		//"The polarity of all MMC5 channels is reversed compared to the APU."
 		int16_t summedOutput = -(_square1.GetOutput() + _square2.GetOutput() + _pcmOutput);
 		if(summedOutput != _lastOutput) {
-			_console->GetApu()->AddExpansionAudioDelta(AudioChannel::MMC5, summedOutput - _lastOutput);
+			AddAudioDelta(AudioChannel::MMC5, summedOutput - _lastOutput);
 			_lastOutput = summedOutput;
 		}
 
@@ -102,6 +102,7 @@ public:
 
 	uint8_t ReadRegister(uint16_t addr)
 	{
+		Run();
 		switch(addr) {
 			case 0x5010:
 				//TODO: PCM IRQ
@@ -119,6 +120,7 @@ public:
 
 	void WriteRegister(uint16_t addr, uint8_t value)
 	{
+		Run();
 		switch(addr) {
 			case 0x5000: case 0x5001: case 0x5002: case 0x5003:
 				_square1.WriteRAM(addr, value);
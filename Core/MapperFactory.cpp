@@ -345,7 +345,7 @@ BaseMapper* MapperFactory::GetMapperFromID(RomData &romData)
 		case 33: return new TaitoTc0190();
 		case 34: 
 			switch(romData.Info.SubMapperID) {
-				case 0: return (romData.ChrRom.size() > 0) ? (BaseMapper*)new Nina01() : (BaseMapper*)new BnRom(); //BnROM uses CHR RAM (so no CHR rom in the .NES file)
+				case 0: return (romData.ChrRom.size() > 0 || romData.ChrRomImage) ? (BaseMapper*)new Nina01() : (BaseMapper*)new BnRom(); //BnROM uses CHR RAM (so no CHR rom in the .NES file)
 				case 1: return new Nina01();
 				case 2: return new BnRom();
 			}
@@ -665,12 +665,17 @@ BaseMapper* MapperFactory::GetMapperFromID(RomData &romData)
 	return nullptr;
 }
 
+shared_ptr<BaseMapper> MapperFactory::InitializeFromRomData(RomData &romData)
+{
+	return shared_ptr<BaseMapper>(GetMapperFromID(romData));
+}
+
 shared_ptr<BaseMapper> MapperFactory::InitializeFromFile(shared_ptr<Console> console, VirtualFile &romFile, RomData &romData)
 {
 	RomLoader loader;
 
 	if(loader.LoadFile(romFile)) {
-		romData = loader.GetRomData();
+		romData = std::move(loader.GetRomData());
 
 		if((romData.Info.IsInDatabase || romData.Info.IsNes20Header) && romData.Info.InputType != GameInputType::Unspecified) {
 			//If in DB or a NES 2.0 file, auto-configure the inputs
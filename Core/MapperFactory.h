@@ -18,4 +18,7 @@ class MapperFactory
 		static constexpr uint16_t StudyBoxMapperID = 65533;
 
 		static shared_ptr<BaseMapper> InitializeFromFile(shared_ptr<Console> console, VirtualFile &romFile, RomData &outRomData);
+
+		//Creates a new mapper for a rom that was already loaded by InitializeFromFile (used to clone consoles)
+		static shared_ptr<BaseMapper> InitializeFromRomData(RomData &romData);
 };
@@ -9,7 +9,8 @@ MemoryManager::MemoryManager(shared_ptr<Console> console)
 {
 	_console = console;
 	_internalRAM = new uint8_t[InternalRAMSize];
-	_internalRamHandler.SetInternalRam(_internalRAM);
+	_internalRamPages.Init(_internalRAM, InternalRAMSize);
+	_internalRamHandler.SetInternalRam(_internalRAM, _internalRamPages.GetDirtyFlags());
 
 	_ramReadHandlers = new IMemoryHandler*[RAMSize];
 	_ramWriteHandlers = new IMemoryHandler*[RAMSize];
@@ -39,6 +40,7 @@ void MemoryManager::Reset(bool softReset)
 {
 	if(!softReset) {
 		_console->InitializeRam(_internalRAM, InternalRAMSize);
+		_internalRamPages.MarkAllDirty();
 	}
 
 	_mapper->Reset(softReset);
@@ -84,6 +86,11 @@ void MemoryManager::UnregisterIODevice(IMemoryHandler *handler)
 	}
 }
 
+DirtyPageTracker* MemoryManager::GetDirtyPageTracker()
+{
+	return &_internalRamPages;
+}
+
 uint8_t* MemoryManager::GetInternalRAM()
 {
 	return _internalRAM;
@@ -162,8 +169,13 @@ uint32_t MemoryManager::ToAbsolutePrgAddress(uint16_t ramAddr)
 
 void MemoryManager::StreamState(bool saving)
 {
-	ArrayInfo<uint8_t> internalRam = { _internalRAM, MemoryManager::InternalRAMSize };
+	bool excludeRam = _console->IsRamExcludedFromState();
+	ArrayInfo<uint8_t> internalRam = { _internalRAM, excludeRam ? 0 : (uint32_t)MemoryManager::InternalRAMSize };
 	Stream(internalRam);
+
+	if(!saving && !excludeRam) {
+		_internalRamPages.MarkAllDirty();
+	}
 }
 
 uint8_t MemoryManager::GetOpenBus(uint8_t mask)
@@ -5,6 +5,7 @@
 #include "Snapshotable.h"
 #include "OpenBusHandler.h"
 #include "InternalRamHandler.h"
+#include "DirtyPageTracker.h"
 
 class BaseMapper;
 class Console;
@@ -19,6 +20,7 @@ class MemoryManager : public Snapshotable
 		shared_ptr<BaseMapper> _mapper;
 
 		uint8_t *_internalRAM;
+		DirtyPageTracker _internalRamPages;
 
 		OpenBusHandler _openBusHandler;
 		InternalRamHandler<0x7FF> _internalRamHandler;
@@ -48,6 +50,7 @@ class MemoryManager : public Snapshotable
 		void DebugWrite(uint16_t addr, uint8_t value, bool disableSideEffects = true);
 
 		uint8_t* GetInternalRAM();
+		DirtyPageTracker* GetDirtyPageTracker();
 
 		uint8_t Read(uint16_t addr, MemoryOperationType operationType = MemoryOperationType::Read);
 		void Write(uint16_t addr, uint8_t value, MemoryOperationType operationType);
@@ -14,10 +14,14 @@
 #include "VirtualFile.h"
 #include "NotificationManager.h"
 #include "RomData.h"
+#include "SoundMixer.h"
+#include "APU.h"
+#include "Debugger.h"
 
 MesenMovie::MesenMovie(shared_ptr<Console> console)
 {
 	_console = console;
+	_seekState = SeekState::None;
 }
 
 MesenMovie::~MesenMovie()
@@ -45,11 +49,12 @@ bool MesenMovie::SetInput(BaseControlDevice *device)
 {
 	uint32_t inputRowIndex = _console->GetControlManager()->GetPollCounter();
 
-	if(_inputData.size() > inputRowIndex && _inputData[inputRowIndex].size() > _deviceIndex) {
-		device->SetTextState(_inputData[inputRowIndex][_deviceIndex]);
+	vector<ControlDeviceState>* frame = _inputLog.GetFrame(inputRowIndex);
+	if(frame && frame->size() > _deviceIndex) {
+		device->SetRawState((*frame)[_deviceIndex]);
 
 		_deviceIndex++;
-		if(_deviceIndex >= _inputData[inputRowIndex].size()) {
+		if(_deviceIndex >= frame->size()) {
 			//Move to the next frame's data
 			_deviceIndex = 0;
 		}
@@ -64,6 +69,83 @@ bool MesenMovie::IsPlaying()
 	return _playing;
 }
 
+bool MesenMovie::SeekTo(uint32_t frame)
+{
+	if(frame >= _inputLog.GetFrameCount()) {
+		return false;
+	}
+
+	if(std::this_thread::get_id() == _console->GetEmulationThreadId()) {
+		return RunSeek(frame);
+	}
+
+	//The frames between the keyframe and the target frame must be emulated by the emulation thread (the debugger, pause requests, etc. expect it)
+	//Queue the seek and wait until the emulation thread is done with it
+	_seekFrame = frame;
+	_seekResult = false;
+	_seekDone.Reset();
+	_seekState = SeekState::Pending;
+
+	while(_seekState != SeekState::None) {
+		_seekDone.Wait(50);
+
+		shared_ptr<Debugger> debugger = _console->GetDebugger(false);
+		if(!_console->IsRunning() || (debugger && debugger->IsExecutionStopped())) {
+			//The emulation thread can't process the seek (emulation stopped or debugger break), cancel it if it hasn't started yet
+			SeekState pending = SeekState::Pending;
+			if(_seekState.compare_exchange_strong(pending, SeekState::None)) {
+				return false;
+			}
+		}
+	}
+	return _seekResult;
+}
+
+void MesenMovie::ProcessSeek()
+{
+	if(std::this_thread::get_id() != _console->GetEmulationThreadId()) {
+		return;
+	}
+
+	SeekState pending = SeekState::Pending;
+	if(_seekState.compare_exchange_strong(pending, SeekState::Running)) {
+		_seekResult = RunSeek(_seekFrame);
+		_seekState = SeekState::None;
+		_seekDone.Signal();
+	}
+}
+
+bool MesenMovie::RunSeek(uint32_t frame)
+{
+	//Called on the emulation thread
+	stringstream stateData;
+	int32_t keyframe = _keyframes.GetKeyframe(frame, stateData);
+	if(keyframe < 0) {
+		return false;
+	}
+
+	_console->LoadState(stateData);
+	ControlManager* controlManager = _console->GetControlManager();
+	controlManager->SetPollCounter(keyframe);
+	_deviceIndex = 0;
+
+	//Emulate the frames between the keyframe and the target frame without audio/video output
+	//Stop if the game stops reading input for a long time, rather than emulate indefinitely
+	EmulationSettings* settings = _console->GetSettings();
+	settings->SetRunAheadFrameFlag(true);
+	uint32_t framesWithoutInput = 0;
+	while(_playing && controlManager->GetPollCounter() < frame && framesWithoutInput < MaxSeekFramesWithoutInput) {
+		uint32_t pollCounter = controlManager->GetPollCounter();
+		_console->RunFrame();
+		framesWithoutInput = controlManager->GetPollCounter() == pollCounter ? framesWithoutInput + 1 : 0;
+	}
+	_console->GetApu()->EndFrame();
+	settings->SetRunAheadFrameFlag(false);
+
+	_console->GetSoundMixer()->StopAudio(true);
+	return true;
+}
+
 vector<uint8_t> MesenMovie::LoadBattery(string extension)
 {
 	vector<uint8_t> batteryData;
@@ -88,22 +170,28 @@ bool MesenMovie::Play(VirtualFile &file)
 	_reader.reset(new ZipReader());
 	_reader->LoadArchive(ss);
 
-	stringstream settingsData, inputData;
+	stringstream settingsData, textInputData;
+	vector<uint8_t> inputData;
 	if(!_reader->GetStream("GameSettings.txt", settingsData)) {
 		MessageManager::Log("[Movie] File not found: GameSettings.txt");
 		return false;
 	}
-	if(!_reader->GetStream("Input.txt", inputData)) {
-		MessageManager::Log("[Movie] File not found: Input.txt");
+	if(_reader->ExtractFile("Input.bin", inputData)) {
+		if(!_inputLog.Load(inputData)) {
+			MessageManager::Log("[Movie] Invalid input data: Input.bin");
+			return false;
+		}
+	} else if(!_reader->GetStream("Input.txt", textInputData)) {
+		//Movies recorded by older versions store their input as text (converted once the game is loaded)
+		MessageManager::Log("[Movie] File not found: Input.bin");
 		return false;
 	}
 
-	while(inputData) {
-		string line;
-		std::getline(inputData, line);
-		if(line.substr(0, 1) == "|") {
-			_inputData.push_back(StringUtilities::Split(line.substr(1), '|'));
-		}
+	vector<uint8_t> keyframeData;
+	if(_reader->ExtractFile("Keyframes.bin", keyframeData) && !_keyframes.Load(keyframeData)) {
+		//Not needed to play the movie, only to seek
+		MessageManager::Log("[Movie] Invalid keyframe data: Keyframes.bin");
+		_keyframes = MovieKeyframes();
 	}
 
 	_deviceIndex = 0;
@@ -113,7 +201,7 @@ bool MesenMovie::Play(VirtualFile &file)
 	_console->Pause();
 		
 	_console->GetBatteryManager()->SetBatteryProvider(shared_from_this());
-	_console->GetNotificationManager()->RegisterNotificationListener(shared_from_this());
+	_console->GetNotificationManager()->RegisterNotificationListener(shared_from_this(), { ConsoleNotificationType::GameLoaded });
 	ApplySettings();
 
 	//Disable auto-configure input option (otherwise the movie file's input types are ignored)
@@ -134,6 +222,10 @@ bool MesenMovie::Play(VirtualFile &file)
 		return false;
 	}
 
+	if(_inputLog.GetFrameCount() == 0) {
+		ConvertTextInput(textInputData);
+	}
+
 	stringstream saveStateData;
 	if(_reader->GetStream("SaveState.mst", saveStateData)) {
 		if(!_console->GetSaveStateManager()->LoadState(saveStateData, true)) {
@@ -162,6 +254,35 @@ T FromString(string name, const vector<string> &enumNames, T defaultValue)
 	return defaultValue;
 }
 
+void MesenMovie::ConvertTextInput(stringstream &inputData)
+{
+	//Each line contains the text state of every device (e.g "|RLDUTSBA|..."), in the same order as the ControlManager's device list
+	//The devices are used to convert their text state to their raw state - their original state is restored once this is done
+	vector<shared_ptr<BaseControlDevice>> devices = _console->GetControlManager()->GetControlDevices();
+	vector<ControlDeviceState> originalStates;
+	for(shared_ptr<BaseControlDevice> &device : devices) {
+		originalStates.push_back(device->GetRawState());
+	}
+
+	string line;
+	vector<ControlDeviceState> states;
+	while(std::getline(inputData, line)) {
+		if(line.size() > 0 && line[0] == '|') {
+			vector<string> textStates = StringUtilities::Split(line.substr(1), '|');
+			states.clear();
+			for(size_t i = 0; i < textStates.size() && i < devices.size(); i++) {
+				devices[i]->SetTextState(textStates[i]);
+				states.push_back(devices[i]->GetRawState());
+			}
+			_inputLog.AddFrame(states);
+		}
+	}
+
+	for(size_t i = 0; i < devices.size(); i++) {
+		devices[i]->SetRawState(originalStates[i]);
+	}
+}
+
 void MesenMovie::ParseSettings(stringstream &data)
 {
 	while(!data.eof()) {
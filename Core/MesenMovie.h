@@ -1,10 +1,14 @@
 #pragma once
 
 #include "stdafx.h"
+#include <atomic>
 #include "MovieManager.h"
 #include "VirtualFile.h"
 #include "BatteryManager.h"
 #include "INotificationListener.h"
+#include "MovieInputLog.h"
+#include "MovieKeyframes.h"
+#include "../Utilities/AutoResetEvent.h"
 
 class ZipReader;
 class Console;
@@ -13,22 +17,34 @@ struct CodeInfo;
 class MesenMovie : public IMovie, public INotificationListener, public IBatteryProvider, public std::enable_shared_from_this<MesenMovie>
 {
 private:
+	static constexpr uint32_t MaxSeekFramesWithoutInput = 3600;
+
 	shared_ptr<Console> _console;
 
 	VirtualFile _movieFile;
 	shared_ptr<ZipReader> _reader;
 	bool _playing = false;
 	size_t _deviceIndex = 0;
-	vector<vector<string>> _inputData;
+	MovieInputLog _inputLog;
+	MovieKeyframes _keyframes;
 	vector<string> _cheats;
 	std::unordered_map<string, string> _settings;
 	string _filename;
 
+	//Seeks are requested by the UI and run by the emulation thread
+	enum class SeekState { None, Pending, Running };
+	std::atomic<SeekState> _seekState;
+	uint32_t _seekFrame = 0;
+	bool _seekResult = false;
+	AutoResetEvent _seekDone;
+
 private:
 	void ParseSettings(stringstream &data);
+	void ConvertTextInput(stringstream &inputData);
 	void ApplySettings();
 	bool LoadGame();
 	void Stop();
+	bool RunSeek(uint32_t frame);
 
 	uint32_t LoadInt(std::unordered_map<string, string> &settings, string name, uint32_t defaultValue = 0);
 	bool LoadBool(std::unordered_map<string, string> &settings, string name);
@@ -43,6 +59,8 @@ public:
 	bool Play(VirtualFile &file) override;
 	bool SetInput(BaseControlDevice* device) override;
 	bool IsPlaying() override;
+	bool SeekTo(uint32_t frame) override;
+	void ProcessSeek() override;
 
 	// Inherited via IBatteryProvider
 	virtual vector<uint8_t> LoadBattery(string extension) override;
@@ -0,0 +1,197 @@
+#include "stdafx.h"
+#include "MovieInputLog.h"
+
+void MovieInputLog::AddFrame(vector<ControlDeviceState> &states)
+{
+	bool sameFrame = _pendingCount > 0 && _pendingFrame.size() == states.size();
+	for(size_t i = 0; sameFrame && i < states.size(); i++) {
+		sameFrame = !(_pendingFrame[i] != states[i]);
+	}
+
+	if(_frameCount % ChunkSize == 0) {
+		//Runs never cross chunk boundaries, each chunk can be decoded on its own
+		WriteRun();
+		_chunkOffsets.push_back((uint32_t)_data.size());
+		sameFrame = false;
+	} else if(!sameFrame) {
+		WriteRun();
+	}
+
+	if(!sameFrame) {
+		_pendingFrame = states;
+	}
+	_pendingCount++;
+	_frameCount++;
+}
+
+void MovieInputLog::WriteRun()
+{
+	if(_pendingCount == 0) {
+		return;
+	}
+
+	//Run: frame count, device count, then the size & content of each device's state
+	WriteValue(_data, _pendingCount);
+	WriteValue(_data, (uint32_t)_pendingFrame.size());
+	for(ControlDeviceState &state : _pendingFrame) {
+		WriteValue(_data, (uint32_t)state.State.size());
+		_data.insert(_data.end(), state.State.begin(), state.State.end());
+	}
+	_pendingCount = 0;
+}
+
+uint32_t MovieInputLog::GetFrameCount()
+{
+	return _frameCount;
+}
+
+bool MovieInputLog::DecodeChunk(uint32_t chunkIndex)
+{
+	_decodedRuns.clear();
+	_runIndex = 0;
+	_decodedChunk = -1;
+
+	size_t pos = _chunkOffsets[chunkIndex];
+	size_t end = chunkIndex + 1 < _chunkOffsets.size() ? _chunkOffsets[chunkIndex + 1] : _data.size();
+	uint32_t frame = chunkIndex * ChunkSize;
+	uint8_t* data = _data.data();
+	while(pos < end) {
+		InputRun run;
+		uint32_t deviceCount;
+		run.FirstFrame = frame;
+		if(!ReadValue(data, pos, end, run.FrameCount) || run.FrameCount == 0 || !ReadValue(data, pos, end, deviceCount)) {
+			return false;
+		}
+
+		if(deviceCount > end - pos) {
+			//Each device's state starts with its size (at least 1 byte) - the count can't be larger than the remaining data
+			return false;
+		}
+
+		run.States.resize(deviceCount);
+		for(ControlDeviceState &state : run.States) {
+			uint32_t size;
+			if(!ReadValue(data, pos, end, size) || end - pos < size) {
+				return false;
+			}
+			state.State.assign(data + pos, data + pos + size);
+			pos += size;
+		}
+
+		frame += run.FrameCount;
+		_decodedRuns.push_back(std::move(run));
+	}
+
+	_decodedChunk = (int32_t)chunkIndex;
+	return true;
+}
+
+vector<ControlDeviceState>* MovieInputLog::GetFrame(uint32_t frame)
+{
+	//Encode the last frames that were added, if any
+	WriteRun();
+
+	if(frame >= _frameCount) {
+		return nullptr;
+	}
+
+	uint32_t chunkIndex = frame / ChunkSize;
+	if((int32_t)chunkIndex != _decodedChunk && (chunkIndex >= _chunkOffsets.size() || !DecodeChunk(chunkIndex))) {
+		return nullptr;
+	}
+
+	//Frames are usually read in order, start searching from the last run that was used
+	if(_runIndex >= _decodedRuns.size() || _decodedRuns[_runIndex].FirstFrame > frame) {
+		_runIndex = 0;
+	}
+	while(_runIndex < _decodedRuns.size() && _decodedRuns[_runIndex].FirstFrame + _decodedRuns[_runIndex].FrameCount <= frame) {
+		_runIndex++;
+	}
+
+	return _runIndex < _decodedRuns.size() ? &_decodedRuns[_runIndex].States : nullptr;
+}
+
+void MovieInputLog::Save(vector<uint8_t> &out)
+{
+	WriteRun();
+
+	out.insert(out.end(), Signature, Signature + 4);
+	WriteInt(out, FormatVersion);
+	WriteInt(out, _frameCount);
+	WriteInt(out, (uint32_t)_chunkOffsets.size());
+	for(uint32_t offset : _chunkOffsets) {
+		WriteInt(out, offset);
+	}
+	out.insert(out.end(), _data.begin(), _data.end());
+}
+
+bool MovieInputLog::Load(vector<uint8_t> &data)
+{
+	if(data.size() < 16 || memcmp(data.data(), Signature, 4) != 0 || ReadInt(data.data() + 4) != FormatVersion) {
+		return false;
+	}
+
+	uint32_t frameCount = ReadInt(data.data() + 8);
+	uint32_t chunkCount = ReadInt(data.data() + 12);
+	if(chunkCount != (frameCount + ChunkSize - 1) / ChunkSize || (data.size() - 16) / 4 < chunkCount) {
+		return false;
+	}
+
+	size_t headerSize = 16 + chunkCount * 4;
+	vector<uint32_t> chunkOffsets(chunkCount);
+	for(uint32_t i = 0; i < chunkCount; i++) {
+		chunkOffsets[i] = ReadInt(data.data() + 16 + i * 4);
+		if(chunkOffsets[i] > data.size() - headerSize || (i > 0 && chunkOffsets[i] < chunkOffsets[i - 1])) {
+			return false;
+		}
+	}
+
+	_data.assign(data.begin() + headerSize, data.end());
+	_chunkOffsets = std::move(chunkOffsets);
+	_frameCount = frameCount;
+	_pendingFrame.clear();
+	_pendingCount = 0;
+	_decodedRuns.clear();
+	_decodedChunk = -1;
+	_runIndex = 0;
+	return true;
+}
+
+void MovieInputLog::WriteValue(vector<uint8_t> &out, uint32_t value)
+{
+	//7 bits per byte, the top bit is set when more bytes follow
+	while(value >= 0x80) {
+		out.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((uint8_t)value);
+}
+
+void MovieInputLog::WriteInt(vector<uint8_t> &out, uint32_t value)
+{
+	out.push_back(value & 0xFF);
+	out.push_back((value >> 8) & 0xFF);
+	out.push_back((value >> 16) & 0xFF);
+	out.push_back((value >> 24) & 0xFF);
+}
+
+bool MovieInputLog::ReadValue(uint8_t* data, size_t &pos, size_t end, uint32_t &value)
+{
+	value = 0;
+	for(int shift = 0; shift < 35; shift += 7) {
+		if(pos >= end) {
+			return false;
+		}
+		uint8_t b = data[pos++];
+		value |= (uint32_t)(b & 0x7F) << shift;
+		if(!(b & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+uint32_t MovieInputLog::ReadInt(uint8_t* data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
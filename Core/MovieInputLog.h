@@ -0,0 +1,55 @@
+#pragma once
+#include "stdafx.h"
+#include "ControlDeviceState.h"
+
+//Compact binary input log used by Mesen movies (Input.bin)
+//Each frame contains the raw state of every device (the device's packed button bits, plus coordinates, etc.)
+//Identical consecutive frames are stored as a single run, and runs are grouped in chunks of ChunkSize frames
+//During playback, only the chunk that contains the current frame is decoded
+class MovieInputLog
+{
+private:
+	static constexpr const char* Signature = "MMIL";
+	static constexpr uint32_t FormatVersion = 1;
+	static constexpr uint32_t ChunkSize = 1024;
+
+	struct InputRun
+	{
+		uint32_t FirstFrame;
+		uint32_t FrameCount;
+		vector<ControlDeviceState> States;
+	};
+
+	vector<uint8_t> _data;
+	vector<uint32_t> _chunkOffsets;
+	uint32_t _frameCount = 0;
+
+	//Recording: the last frame is kept until a different frame is added (or until its chunk ends)
+	vector<ControlDeviceState> _pendingFrame;
+	uint32_t _pendingCount = 0;
+
+	//Playback: runs of the chunk that was decoded last
+	int32_t _decodedChunk = -1;
+	vector<InputRun> _decodedRuns;
+	size_t _runIndex = 0;
+
+	void WriteRun();
+	bool DecodeChunk(uint32_t chunkIndex);
+
+	static void WriteValue(vector<uint8_t> &out, uint32_t value);
+	static bool ReadValue(uint8_t* data, size_t &pos, size_t end, uint32_t &value);
+
+public:
+	//Little endian 32-bit integers (also used by MovieKeyframes)
+	static void WriteInt(vector<uint8_t> &out, uint32_t value);
+	static uint32_t ReadInt(uint8_t* data);
+
+	void AddFrame(vector<ControlDeviceState> &states);
+	uint32_t GetFrameCount();
+
+	//Returns the states of the devices for the given frame, or nullptr when the frame is past the end of the log
+	vector<ControlDeviceState>* GetFrame(uint32_t frame);
+
+	void Save(vector<uint8_t> &out);
+	bool Load(vector<uint8_t> &data);
+};
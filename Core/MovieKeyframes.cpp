@@ -0,0 +1,92 @@
+#include "stdafx.h"
+#include <algorithm>
+#include "MovieKeyframes.h"
+#include "MovieInputLog.h"
+#include "SaveStateManager.h"
+#include "../Utilities/miniz.h"
+
+void MovieKeyframes::AddKeyframe(uint32_t frame, string stateData)
+{
+	Keyframe keyframe;
+	keyframe.Frame = frame;
+	keyframe.StateSize = (uint32_t)stateData.size();
+
+	unsigned long compressedSize = compressBound((unsigned long)stateData.size());
+	keyframe.CompressedState.resize(compressedSize);
+	compress(keyframe.CompressedState.data(), &compressedSize, (unsigned char*)stateData.c_str(), (unsigned long)stateData.size());
+	keyframe.CompressedState.resize(compressedSize);
+
+	_keyframes.push_back(std::move(keyframe));
+}
+
+uint32_t MovieKeyframes::GetKeyframeCount()
+{
+	return (uint32_t)_keyframes.size();
+}
+
+int32_t MovieKeyframes::GetKeyframe(uint32_t frame, stringstream &stateData)
+{
+	auto result = std::upper_bound(_keyframes.begin(), _keyframes.end(), frame, [](uint32_t frame, const Keyframe &keyframe) {
+		return frame < keyframe.Frame;
+	});
+
+	if(result == _keyframes.begin()) {
+		return -1;
+	}
+
+	Keyframe &keyframe = *(result - 1);
+	unsigned long length = keyframe.StateSize;
+	vector<uint8_t> buffer(length);
+	if(uncompress(buffer.data(), &length, keyframe.CompressedState.data(), (unsigned long)keyframe.CompressedState.size()) != MZ_OK) {
+		return -1;
+	}
+	stateData.write((char*)buffer.data(), length);
+	return (int32_t)keyframe.Frame;
+}
+
+void MovieKeyframes::Save(vector<uint8_t> &out)
+{
+	//Header: signature, version, keyframe count - followed by each keyframe's frame number, state size, compressed size & compressed state
+	out.insert(out.end(), Signature, Signature + 4);
+	MovieInputLog::WriteInt(out, FormatVersion);
+	MovieInputLog::WriteInt(out, (uint32_t)_keyframes.size());
+	for(Keyframe &keyframe : _keyframes) {
+		MovieInputLog::WriteInt(out, keyframe.Frame);
+		MovieInputLog::WriteInt(out, keyframe.StateSize);
+		MovieInputLog::WriteInt(out, (uint32_t)keyframe.CompressedState.size());
+		out.insert(out.end(), keyframe.CompressedState.begin(), keyframe.CompressedState.end());
+	}
+}
+
+bool MovieKeyframes::Load(vector<uint8_t> &data)
+{
+	if(data.size() < 12 || memcmp(data.data(), Signature, 4) != 0 || MovieInputLog::ReadInt(data.data() + 4) != FormatVersion) {
+		return false;
+	}
+
+	uint32_t keyframeCount = MovieInputLog::ReadInt(data.data() + 8);
+	size_t pos = 12;
+	vector<Keyframe> keyframes;
+	for(uint32_t i = 0; i < keyframeCount; i++) {
+		if(data.size() - pos < 12) {
+			return false;
+		}
+
+		Keyframe keyframe;
+		keyframe.Frame = MovieInputLog::ReadInt(data.data() + pos);
+		keyframe.StateSize = MovieInputLog::ReadInt(data.data() + pos + 4);
+		uint32_t compressedSize = MovieInputLog::ReadInt(data.data() + pos + 8);
+		pos += 12;
+
+		if(keyframe.StateSize > SaveStateManager::MaxStateSize || data.size() - pos < compressedSize || (!keyframes.empty() && keyframe.Frame < keyframes.back().Frame)) {
+			return false;
+		}
+		keyframe.CompressedState.assign(data.begin() + pos, data.begin() + pos + compressedSize);
+		pos += compressedSize;
+
+		keyframes.push_back(std::move(keyframe));
+	}
+
+	_keyframes = std::move(keyframes);
+	return true;
+}
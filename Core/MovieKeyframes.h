@@ -0,0 +1,31 @@
+#pragma once
+#include "stdafx.h"
+
+//Save state keyframes embedded in Mesen movies (Keyframes.bin), used to seek without replaying the movie from the start
+//Each keyframe is a compressed copy of the console's state at the end of a frame, indexed by the number of input frames that precede it
+class MovieKeyframes
+{
+private:
+	static constexpr const char* Signature = "MMKF";
+	static constexpr uint32_t FormatVersion = 1;
+
+	struct Keyframe
+	{
+		uint32_t Frame;
+		uint32_t StateSize;
+		vector<uint8_t> CompressedState;
+	};
+
+	vector<Keyframe> _keyframes;
+
+public:
+	//Keyframes must be added in increasing frame order
+	void AddKeyframe(uint32_t frame, string stateData);
+	uint32_t GetKeyframeCount();
+
+	//Writes the state of the last keyframe at or before the given frame and returns its frame number, or -1 if there is none
+	int32_t GetKeyframe(uint32_t frame, stringstream &stateData);
+
+	void Save(vector<uint8_t> &out);
+	bool Load(vector<uint8_t> &data);
+};
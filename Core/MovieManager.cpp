@@ -68,3 +68,25 @@ bool MovieManager::Recording()
 {
 	return _recorder != nullptr;
 }
+
+bool MovieManager::SeekTo(uint32_t frame)
+{
+	shared_ptr<IMovie> player = _player;
+	return player && player->IsPlaying() && player->SeekTo(frame);
+}
+
+void MovieManager::ProcessSeek()
+{
+	shared_ptr<IMovie> player = _player;
+	if(player) {
+		player->ProcessSeek();
+	}
+}
+
+void MovieManager::ProcessEndOfFrame(Console* console)
+{
+	shared_ptr<MovieRecorder> recorder = _recorder;
+	if(recorder) {
+		recorder->ProcessEndOfFrame(console);
+	}
+}
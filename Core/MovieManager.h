@@ -14,6 +14,12 @@ class IMovie : public IInputProvider
 public:
 	virtual bool Play(VirtualFile &file) = 0;
 	virtual bool IsPlaying() = 0;
+
+	//Only supported by movies that contain keyframes
+	virtual bool SeekTo(uint32_t frame) { return false; }
+
+	//Called by the emulation thread between frames (and while paused) to run the seek requested by SeekTo
+	virtual void ProcessSeek() { }
 };
 
 class MovieManager
@@ -28,4 +34,8 @@ public:
 	static void Stop();
 	static bool Playing();
 	static bool Recording();
+
+	static bool SeekTo(uint32_t frame);
+	static void ProcessSeek();
+	static void ProcessEndOfFrame(Console* console);
 };
\ No newline at end of file
@@ -30,7 +30,10 @@ bool MovieRecorder::Record(RecordMovieOptions options)
 	_author = options.Author;
 	_description = options.Description;
 	_writer.reset(new ZipWriter());
-	_inputData = stringstream();
+	_inputLog = MovieInputLog();
+	_keyframes = MovieKeyframes();
+	_keyframeInterval = GetKeyframeInterval(options.KeyframeInterval);
+	_nextKeyframe = 0;
 	_saveStateData = stringstream();
 	_hasSaveState = false;
 
@@ -49,7 +52,7 @@ bool MovieRecorder::Record(RecordMovieOptions options)
 			_console->GetBatteryManager()->SetBatteryRecorder(shared_from_this());
 		}
 		
-		_console->GetNotificationManager()->RegisterNotificationListener(shared_from_this());
+		_console->GetNotificationManager()->RegisterNotificationListener(shared_from_this(), { ConsoleNotificationType::GameLoaded });
 		if(options.RecordFrom == RecordMovieFrom::CurrentState) {
 			_console->GetControlManager()->RegisterInputRecorder(this);
 			_console->GetSaveStateManager()->SaveState(_saveStateData);
@@ -58,6 +61,9 @@ bool MovieRecorder::Record(RecordMovieOptions options)
 			_console->PowerCycle();
 		}
 		_console->GetBatteryManager()->SetBatteryRecorder(nullptr);
+
+		//The first keyframe is the movie's starting point, so every frame can be reached from a keyframe
+		ProcessEndOfFrame(_console.get());
 		_console->Resume();
 
 		MessageManager::DisplayMessage("Movies", "MovieRecordingTo", FolderUtilities::GetFilename(_filename, true));
@@ -66,6 +72,28 @@ bool MovieRecorder::Record(RecordMovieOptions options)
 	}
 }
 
+uint32_t MovieRecorder::GetKeyframeInterval(uint32_t seconds)
+{
+	return seconds * (_console->GetModel() == NesModel::NTSC ? 60 : 50);
+}
+
+void MovieRecorder::ProcessEndOfFrame(Console* console)
+{
+	//Keyframes are taken between frames, once all of the frame's input has been recorded
+	//Not done while run ahead is enabled - the console is ahead of the recorded input at this point
+	if(console != _console.get() || !_writer || _keyframeInterval == 0 || _console->GetSettings()->GetRunAheadFrames() > 0) {
+		return;
+	}
+
+	uint32_t frame = _inputLog.GetFrameCount();
+	if(frame >= _nextKeyframe) {
+		stringstream state;
+		_console->SaveState(state);
+		_keyframes.AddKeyframe(frame, state.str());
+		_nextKeyframe = frame + _keyframeInterval;
+	}
+}
+
 void MovieRecorder::GetGameSettings(stringstream &out)
 {
 	EmulationSettings* settings = _console->GetSettings();
@@ -163,9 +191,15 @@ void MovieRecorder::WriteBool(stringstream &out, string name, bool enabled)
 bool MovieRecorder::Stop()
 {
 	if(_writer) {
+		//Stop recording input and keyframes (from the emulation thread) before saving them
+		_console->Pause();
 		_console->GetControlManager()->UnregisterInputRecorder(this);
+		_keyframeInterval = 0;
+		_console->Resume();
 
-		_writer->AddFile(_inputData, "Input.txt");
+		vector<uint8_t> inputData;
+		_inputLog.Save(inputData);
+		_writer->AddFile(inputData, "Input.bin");
 
 		stringstream out;
 		GetGameSettings(out);
@@ -188,6 +222,12 @@ bool MovieRecorder::Stop()
 			_writer->AddFile(_saveStateData, "SaveState.mst");
 		}
 
+		if(_keyframes.GetKeyframeCount() > 0) {
+			vector<uint8_t> keyframeData;
+			_keyframes.Save(keyframeData);
+			_writer->AddFile(keyframeData, "Keyframes.bin");
+		}
+
 		for(auto kvp : _batteryData) {
 			_writer->AddFile(kvp.second, "Battery" + kvp.first);
 		}
@@ -204,10 +244,12 @@ bool MovieRecorder::Stop()
 
 void MovieRecorder::RecordInput(vector<shared_ptr<BaseControlDevice>> devices)
 {
+	vector<ControlDeviceState> states;
+	states.reserve(devices.size());
 	for(shared_ptr<BaseControlDevice> &device : devices) {
-		_inputData << ("|" + device->GetTextState());
+		states.push_back(device->GetRawState());
 	}
-	_inputData << "\n";
+	_inputLog.AddFrame(states);
 }
 
 void MovieRecorder::OnLoadBattery(string extension, vector<uint8_t> batteryData)
@@ -242,19 +284,32 @@ bool MovieRecorder::CreateMovie(string movieFile, std::deque<RewindData> &data,
 			data[startPosition].GetStateData(_saveStateData);
 		}
 
-		_inputData = stringstream();
+		_inputLog = MovieInputLog();
+		_keyframes = MovieKeyframes();
 
+		//Each rewind entry starts with a state, one of them is used as a keyframe every DefaultKeyframeInterval seconds
+		uint32_t keyframeStep = std::max<uint32_t>(1, GetKeyframeInterval(DefaultKeyframeInterval) / 30);
+
+		vector<ControlDeviceState> states;
 		for(uint32_t i = startPosition; i < endPosition; i++) {
-			RewindData rewindData = data[i];
+			RewindData &rewindData = data[i];
+			if((i - startPosition) % keyframeStep == 0) {
+				stringstream keyframeState;
+				rewindData.GetStateData(keyframeState);
+				_keyframes.AddKeyframe(_inputLog.GetFrameCount(), keyframeState.str());
+			}
+
 			for(uint32_t i = 0; i < 30; i++) {
+				states.clear();
 				for(shared_ptr<BaseControlDevice> &device : devices) {
 					uint8_t port = device->GetPort();
 					if(i < rewindData.InputLogs[port].size()) {
-						device->SetRawState(rewindData.InputLogs[port][i]);
-						_inputData << ("|" + device->GetTextState());
+						states.push_back(rewindData.InputLogs[port][i]);
 					}
 				}
-				_inputData << "\n";
+				if(!states.empty()) {
+					_inputLog.AddFrame(states);
+				}
 			}
 		}
 
@@ -6,6 +6,8 @@
 #include "BatteryManager.h"
 #include "Types.h"
 #include "INotificationListener.h"
+#include "MovieInputLog.h"
+#include "MovieKeyframes.h"
 
 class ZipWriter;
 class Console;
@@ -15,7 +17,8 @@ struct CodeInfo;
 class MovieRecorder : public INotificationListener, public IInputRecorder, public IBatteryRecorder, public IBatteryProvider, public std::enable_shared_from_this<MovieRecorder>
 {
 private:
-	static const uint32_t MovieFormatVersion = 1;
+	static const uint32_t MovieFormatVersion = 2;
+	static const uint32_t DefaultKeyframeInterval = 10;
 
 	shared_ptr<Console> _console;
 	string _filename;
@@ -23,11 +26,15 @@ private:
 	string _description;
 	unique_ptr<ZipWriter> _writer;
 	std::unordered_map<string, vector<uint8_t>> _batteryData;
-	stringstream _inputData;
+	MovieInputLog _inputLog;
+	MovieKeyframes _keyframes;
+	uint32_t _keyframeInterval = 0;
+	uint32_t _nextKeyframe = 0;
 	bool _hasSaveState = false;
 	stringstream _saveStateData;
 
 	void GetGameSettings(stringstream &out);
+	uint32_t GetKeyframeInterval(uint32_t seconds);
 	void WriteCheat(stringstream &out, CodeInfo &code);
 	void WriteString(stringstream &out, string name, string value);
 	void WriteInt(stringstream &out, string name, uint32_t value);
@@ -42,6 +49,8 @@ public:
 
 	bool CreateMovie(string movieFile, std::deque<RewindData> &data, uint32_t startPosition, uint32_t endPosition);
 
+	void ProcessEndOfFrame(Console* console);
+
 	// Inherited via IInputRecorder
 	void RecordInput(vector<shared_ptr<BaseControlDevice>> devices) override;
 
@@ -30,6 +30,8 @@ private:
 	{
 		if(_autoDetectVariant) {
 			if(!_notNamco340 || variant != NamcoVariant::Namco340) {
+				//Only the Namco 163 has an audio chip
+				_audio->SetClockEnabled(variant == NamcoVariant::Namco163);
 				_variant = variant;
 			}
 		}
@@ -85,6 +87,7 @@ protected:
 				}
 				break;
 		}
+		_audio->SetClockEnabled(_variant == NamcoVariant::Namco163);
 		
 		_notNamco340 = false;
 
@@ -107,6 +110,7 @@ protected:
 		SnapshotInfo audio{ _audio.get() };
 		Stream(_variant, _notNamco340, _autoDetectVariant, _writeProtect, _lowChrNtMode, _highChrNtMode, _irqCounter, audio);
 		if(!saving) {
+			_audio->SetClockEnabled(_variant == NamcoVariant::Namco163);
 			UpdateSaveRamAccess();
 		}
 	}
@@ -125,6 +129,9 @@ protected:
 	void SaveBattery() override
 	{
 		if(HasBattery()) {
+			//The chip's channel state (phase, etc.) is stored in its internal ram, catch up before saving it
+			_audio->Run();
+
 			vector<uint8_t> batteryContent(_saveRamSize + Namco163Audio::AudioRamSize, 0);
 			memcpy(batteryContent.data(), _saveRam, _saveRamSize);
 			memcpy(batteryContent.data() + _saveRamSize, _audio->GetInternalRam(), Namco163Audio::AudioRamSize);
@@ -133,6 +140,16 @@ protected:
 		}
 	}
 
+	void RunExpansionAudio() override
+	{
+		_audio->Run();
+	}
+
+	void ClockExpansionAudio() override
+	{
+		_audio->Clock();
+	}
+
 	void ProcessCpuClock() override
 	{
 		if(_irqCounter & 0x8000 && (_irqCounter & 0x7FFF) != 0x7FFF) {
@@ -141,10 +158,6 @@ protected:
 				_console->GetCpu()->SetIrqSource(IRQSource::External);
 			}
 		}
-
-		if(_variant == NamcoVariant::Namco163) {
-			_audio->Clock();
-		}
 	}
 
 	void WriteRAM(uint16_t addr, uint8_t value) override
@@ -110,7 +110,7 @@ private:
 		}
 		summedOutput /= GetNumberOfChannels() + 1;
 
-		_console->GetApu()->AddExpansionAudioDelta(AudioChannel::Namco163, summedOutput - _lastOutput);
+		AddAudioDelta(AudioChannel::Namco163, summedOutput - _lastOutput);
 		_lastOutput = summedOutput;
 	}
 
@@ -160,6 +160,7 @@ public:
 
 	void WriteRegister(uint16_t addr, uint8_t value)
 	{
+		Run();
 		switch(addr & 0xF800) {
 			case 0x4800:
 				_internalRam[_ramPosition] = value;
@@ -180,6 +181,7 @@ public:
 
 	uint8_t ReadRegister(uint16_t addr)
 	{
+		Run();
 		uint8_t value = 0;
 		switch(addr & 0xF800) {
 			case 0x4800: {
@@ -117,13 +117,23 @@ public:
 		return _type;
 	}
 
-	void Send(Socket &socket)
+	void Serialize(vector<uint8_t> &output)
+	{
+		//Appends the message (length + content) to the buffer, to be sent later to one or more clients
+		StreamState();
+		uint32_t messageLength = (uint32_t)_buffer.size();
+		output.insert(output.end(), (uint8_t*)&messageLength, (uint8_t*)&messageLength + sizeof(messageLength));
+		output.insert(output.end(), _buffer.begin(), _buffer.end());
+	}
+
+	uint32_t Send(Socket &socket)
 	{
 		StreamState();
 		uint32_t messageLength = (uint32_t)_buffer.size();
 		socket.BufferedSend((char*)&messageLength, sizeof(messageLength));
 		socket.BufferedSend((char*)&_buffer[0], messageLength);
 		socket.SendBuffer();
+		return messageLength + sizeof(messageLength);
 	}
 
 	void CopyString(char** dest, uint32_t &length, string src)
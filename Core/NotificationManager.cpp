@@ -1,19 +1,54 @@
 #include "stdafx.h"
 #include <algorithm>
 #include "NotificationManager.h"
+#include "FrameProfiler.h"
+
+NotificationManager::NotificationManager(shared_ptr<FrameProfiler> profiler)
+{
+	_profiler = profiler;
+	_activeSenders = 0;
+
+	_currentSnapshot.reset(new ListenerSnapshot());
+	_snapshot = _currentSnapshot.get();
+}
 
 void NotificationManager::RegisterNotificationListener(shared_ptr<INotificationListener> notificationListener)
+{
+	RegisterNotificationListener(notificationListener, AllNotificationTypes);
+}
+
+void NotificationManager::RegisterNotificationListener(shared_ptr<INotificationListener> notificationListener, std::initializer_list<ConsoleNotificationType> types)
+{
+	uint32_t typeMask = 0;
+	for(ConsoleNotificationType type : types) {
+		if((int)type < MaxNotificationTypes) {
+			typeMask |= 1u << (int)type;
+		}
+	}
+	RegisterNotificationListener(notificationListener, typeMask);
+}
+
+void NotificationManager::RegisterNotificationListener(shared_ptr<INotificationListener> notificationListener, uint32_t typeMask)
 {
 	auto lock = _lock.AcquireSafe();
 
-	for(weak_ptr<INotificationListener> listener : _listeners) {
-		if(listener.lock() == notificationListener) {
-			//This listener is already registered, do nothing
-			return;
+	CleanupNotificationListeners();
+
+	bool registered = false;
+	for(ListenerInfo &info : _listeners) {
+		if(info.Listener.lock() == notificationListener) {
+			//This listener is already registered, add the new types to its list
+			info.TypeMask |= typeMask;
+			registered = true;
+			break;
 		}
 	}
 
-	_listeners.push_back(notificationListener);
+	if(!registered) {
+		_listeners.push_back({ notificationListener, typeMask });
+	}
+
+	UpdateSnapshot();
 }
 
 void NotificationManager::CleanupNotificationListeners()
@@ -21,30 +56,67 @@ void NotificationManager::CleanupNotificationListeners()
 	auto lock = _lock.AcquireSafe();
 
 	//Remove expired listeners
+	size_t listenerCount = _listeners.size();
 	_listeners.erase(
 		std::remove_if(
 			_listeners.begin(),
 			_listeners.end(),
-			[](weak_ptr<INotificationListener> ptr) { return ptr.expired(); }
+			[](ListenerInfo &info) { return info.Listener.expired(); }
 		),
 		_listeners.end()
 	);
+
+	if(_listeners.size() != listenerCount) {
+		UpdateSnapshot();
+	}
+}
+
+void NotificationManager::UpdateSnapshot()
+{
+	//Must be called while holding the lock
+	unique_ptr<ListenerSnapshot> snapshot(new ListenerSnapshot());
+	for(ListenerInfo &info : _listeners) {
+		for(int i = 0; i < MaxNotificationTypes; i++) {
+			if(info.TypeMask & (1u << i)) {
+				snapshot->Listeners[i].push_back(info.Listener);
+			}
+		}
+	}
+
+	_snapshot = snapshot.get();
+	_retiredSnapshots.push_back(std::move(_currentSnapshot));
+	_currentSnapshot = std::move(snapshot);
+
+	//A SendNotification call that starts after this point can only get the new snapshot
+	if(_activeSenders == 0) {
+		_retiredSnapshots.clear();
+	}
 }
 
 void NotificationManager::SendNotification(ConsoleNotificationType type, void* parameter)
 {
-	vector<weak_ptr<INotificationListener>> listeners;
-	{
-		auto lock = _lock.AcquireSafe();
-		CleanupNotificationListeners();
-		listeners = _listeners;
+	PROFILE_SCOPE(_profiler.get(), Notification);
+
+	if((int)type >= MaxNotificationTypes) {
+		return;
 	}
 
-	//Iterate on a copy without using a lock
-	for(weak_ptr<INotificationListener> notificationListener : listeners) {
+	_activeSenders++;
+
+	//The snapshot is never modified, and is not deleted until _activeSenders is back to 0
+	bool hasExpiredListeners = false;
+	for(weak_ptr<INotificationListener> &notificationListener : _snapshot.load()->Listeners[(int)type]) {
 		shared_ptr<INotificationListener> listener = notificationListener.lock();
 		if(listener) {
 			listener->ProcessNotification(type, parameter);
+		} else {
+			hasExpiredListeners = true;
 		}
 	}
+
+	_activeSenders--;
+
+	if(hasExpiredListeners) {
+		CleanupNotificationListeners();
+	}
 }
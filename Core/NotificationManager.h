@@ -1,18 +1,53 @@
 #pragma once
 #include "stdafx.h"
+#include <atomic>
 #include "INotificationListener.h"
 #include "../Utilities/SimpleLock.h"
 
+class FrameProfiler;
+
 class NotificationManager
 {
 private:
+	static constexpr int MaxNotificationTypes = 32;
+	static constexpr uint32_t AllNotificationTypes = 0xFFFFFFFF;
+
+	struct ListenerInfo
+	{
+		weak_ptr<INotificationListener> Listener;
+		uint32_t TypeMask;
+	};
+
+	//Read-only copy of the listener list, split by notification type
+	//A new snapshot replaces it when a listener is added or removed, SendNotification reads the current snapshot without locking or copying it
+	struct ListenerSnapshot
+	{
+		vector<weak_ptr<INotificationListener>> Listeners[MaxNotificationTypes];
+	};
+
+	shared_ptr<FrameProfiler> _profiler;
 	SimpleLock _lock;
-	vector<weak_ptr<INotificationListener>> _listenersToAdd;
-	vector<weak_ptr<INotificationListener>> _listeners;
-	
+	vector<ListenerInfo> _listeners;
+
+	unique_ptr<ListenerSnapshot> _currentSnapshot;
+	std::atomic<ListenerSnapshot*> _snapshot;
+
+	//Previous snapshots, kept until no SendNotification call can still be using them
+	vector<unique_ptr<ListenerSnapshot>> _retiredSnapshots;
+	std::atomic<uint32_t> _activeSenders;
+
+	void RegisterNotificationListener(shared_ptr<INotificationListener> notificationListener, uint32_t typeMask);
 	void CleanupNotificationListeners();
+	void UpdateSnapshot();
 
 public:
+	NotificationManager(shared_ptr<FrameProfiler> profiler);
+
+	//Registers a listener for every type of notification
 	void RegisterNotificationListener(shared_ptr<INotificationListener> notificationListener);
+
+	//Registers a listener that only receives the given types of notifications
+	void RegisterNotificationListener(shared_ptr<INotificationListener> notificationListener, std::initializer_list<ConsoleNotificationType> types);
+
 	void SendNotification(ConsoleNotificationType type, void* parameter = nullptr);
 };
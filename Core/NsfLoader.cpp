@@ -116,13 +116,13 @@ void NsfLoader::InitHeader(NsfHeader & header)
 	}
 }
 
-void NsfLoader::LoadRom(RomData& romData, vector<uint8_t>& romFile)
+void NsfLoader::LoadRom(RomData& romData, uint8_t* romFile, size_t romSize)
 {
 	NsfHeader &header = romData.Info.NsfInfo;
 
 	InitHeader(header);
 
-	uint8_t* data = romFile.data();
+	uint8_t* data = romFile;
 	Read(data, header.Header, 5);
 	Read(data, header.Version);
 	Read(data, header.TotalSongs);
@@ -155,7 +155,7 @@ void NsfLoader::LoadRom(RomData& romData, vector<uint8_t>& romFile)
 	//Pad start of file to make the first block start at a multiple of 4k
 	romData.PrgRom.insert(romData.PrgRom.end(), header.LoadAddress % 4096, 0);
 
-	romData.PrgRom.insert(romData.PrgRom.end(), data, data + romFile.size() - 0x80);
+	romData.PrgRom.insert(romData.PrgRom.end(), data, data + romSize - 0x80);
 
 	//Pad out the last block to be a multiple of 4k
 	if(romData.PrgRom.size() % 4096 != 0) {
@@ -19,5 +19,5 @@ protected:
 public:
 	using BaseLoader::BaseLoader;
 
-	void LoadRom(RomData& romData, vector<uint8_t>& romFile);
+	void LoadRom(RomData& romData, uint8_t* romFile, size_t romSize);
 };
\ No newline at end of file
@@ -107,6 +107,14 @@ void NsfMapper::InitMapper(RomData& romData)
 	if(_nsfHeader.SoundChips & NsfSoundChips::FDS) {
 		AddRegisterRange(0x4040, 0x4092, MemoryOperation::Any);
 	}
+
+	//The chips that the NSF file doesn't use never run
+	_mmc5Audio->SetClockEnabled((_nsfHeader.SoundChips & NsfSoundChips::MMC5) != 0);
+	_vrc6Audio->SetClockEnabled((_nsfHeader.SoundChips & NsfSoundChips::VRC6) != 0);
+	_vrc7Audio->SetClockEnabled((_nsfHeader.SoundChips & NsfSoundChips::VRC7) != 0);
+	_namcoAudio->SetClockEnabled((_nsfHeader.SoundChips & NsfSoundChips::Namco) != 0);
+	_sunsoftAudio->SetClockEnabled((_nsfHeader.SoundChips & NsfSoundChips::Sunsoft) != 0);
+	_fdsAudio->SetClockEnabled((_nsfHeader.SoundChips & NsfSoundChips::FDS) != 0);
 }
 
 void NsfMapper::Reset(bool softReset)
@@ -218,6 +226,50 @@ void NsfMapper::SelectNextTrack()
 	_trackEnded = false;
 }
 
+void NsfMapper::RunExpansionAudio()
+{
+	if(_nsfHeader.SoundChips & NsfSoundChips::MMC5) {
+		_mmc5Audio->Run();
+	}
+	if(_nsfHeader.SoundChips & NsfSoundChips::VRC6) {
+		_vrc6Audio->Run();
+	}
+	if(_nsfHeader.SoundChips & NsfSoundChips::VRC7) {
+		_vrc7Audio->Run();
+	}
+	if(_nsfHeader.SoundChips & NsfSoundChips::Namco) {
+		_namcoAudio->Run();
+	}
+	if(_nsfHeader.SoundChips & NsfSoundChips::Sunsoft) {
+		_sunsoftAudio->Run();
+	}
+	if(_nsfHeader.SoundChips & NsfSoundChips::FDS) {
+		_fdsAudio->Run();
+	}
+}
+
+void NsfMapper::ClockExpansionAudio()
+{
+	if(_nsfHeader.SoundChips & NsfSoundChips::MMC5) {
+		_mmc5Audio->Clock();
+	}
+	if(_nsfHeader.SoundChips & NsfSoundChips::VRC6) {
+		_vrc6Audio->Clock();
+	}
+	if(_nsfHeader.SoundChips & NsfSoundChips::VRC7) {
+		_vrc7Audio->Clock();
+	}
+	if(_nsfHeader.SoundChips & NsfSoundChips::Namco) {
+		_namcoAudio->Clock();
+	}
+	if(_nsfHeader.SoundChips & NsfSoundChips::Sunsoft) {
+		_sunsoftAudio->Clock();
+	}
+	if(_nsfHeader.SoundChips & NsfSoundChips::FDS) {
+		_fdsAudio->Clock();
+	}
+}
+
 void NsfMapper::ProcessCpuClock()
 {
 	if(_console->IsDebuggerAttached()) {
@@ -253,25 +305,6 @@ void NsfMapper::ProcessCpuClock()
 	}
 
 	ClockLengthAndFadeCounters();
-
-	if(_nsfHeader.SoundChips & NsfSoundChips::MMC5) {
-		_mmc5Audio->Clock();
-	}
-	if(_nsfHeader.SoundChips & NsfSoundChips::VRC6) {
-		_vrc6Audio->Clock();
-	}
-	if(_nsfHeader.SoundChips & NsfSoundChips::VRC7) {
-		_vrc7Audio->Clock();
-	}
-	if(_nsfHeader.SoundChips & NsfSoundChips::Namco) {
-		_namcoAudio->Clock();
-	}
-	if(_nsfHeader.SoundChips & NsfSoundChips::Sunsoft) {
-		_sunsoftAudio->Clock();
-	}
-	if(_nsfHeader.SoundChips & NsfSoundChips::FDS) {
-		_fdsAudio->Clock();
-	}
 }
 
 uint8_t NsfMapper::ReadRegister(uint16_t addr)
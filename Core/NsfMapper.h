@@ -111,6 +111,8 @@ protected:
 	void Reset(bool softReset) override;
 	void GetMemoryRanges(MemoryRanges &ranges) override;
 	
+	void RunExpansionAudio() override;
+	void ClockExpansionAudio() override;
 	void ProcessCpuClock() override;
 	uint8_t ReadRegister(uint16_t addr) override;
 	void WriteRegister(uint16_t addr, uint8_t value) override;
@@ -181,7 +181,7 @@ private:
 public:
 	using NsfLoader::NsfLoader;
 
-	void LoadRom(RomData& romData, vector<uint8_t>& romFile)
+	void LoadRom(RomData& romData, uint8_t* romFile, size_t romSize)
 	{
 		NsfHeader &header = romData.Info.NsfInfo;
 
@@ -189,9 +189,9 @@ public:
 
 		romData.Info.Format = RomFormat::Nsf;
 
-		uint8_t* fileStart = romFile.data();
-		uint8_t* data = romFile.data() + 4;
-		uint8_t* endOfData = romFile.data() + romFile.size();
+		uint8_t* fileStart = romFile;
+		uint8_t* data = romFile + 4;
+		uint8_t* endOfData = romFile + romSize;
 
 		memset(header.SongName, 0, sizeof(header.SongName));
 		memset(header.ArtistName, 0, sizeof(header.ArtistName));
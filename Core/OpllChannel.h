@@ -86,18 +86,9 @@ namespace Vrc7Opll
 			return d*(int32_t)(EG_STEP / DB_STEP);
 		}
 
-		uint32_t SL2EG(int32_t d)
-		{
-			return d*(int32_t)(SL_STEP / EG_STEP);
-		}
-
-		uint32_t S2E(double x)
-		{
-			return (SL2EG((int32_t)(x / SL_STEP)) << (EG_DP_BITS - EG_BITS));
-		}
-
 		shared_ptr<OpllTables> _tables;
-		OpllPatch patch;
+		//The carrier's TL and FB are never set by setInstrument, but they are saved in the state
+		OpllPatch patch = {};
 
 		int32_t type;          /* 0 : modulator 1 : carrier */
 
@@ -344,11 +335,6 @@ namespace Vrc7Opll
 
 		void calc_envelope(int32_t lfo)
 		{
-			static uint32_t SL[16] = {
-				S2E(0.0), S2E(3.0), S2E(6.0), S2E(9.0), S2E(12.0), S2E(15.0), S2E(18.0), S2E(21.0),
-				S2E(24.0), S2E(27.0), S2E(30.0), S2E(33.0), S2E(36.0), S2E(39.0), S2E(42.0), S2E(48.0)
-			};
-
 			uint32_t egout;
 
 			switch(eg_mode) {
@@ -368,13 +354,13 @@ namespace Vrc7Opll
 				case DECAY:
 					egout = GetHighBits(eg_phase, EG_DP_BITS - EG_BITS);
 					eg_phase += eg_dphase;
-					if(eg_phase >= SL[patch.SL]) {
+					if(eg_phase >= _tables->slTable[patch.SL]) {
 						if(patch.EG) {
-							eg_phase = SL[patch.SL];
+							eg_phase = _tables->slTable[patch.SL];
 							eg_mode = SUSHOLD;
 							UpdateEg();
 						} else {
-							eg_phase = SL[patch.SL];
+							eg_phase = _tables->slTable[patch.SL];
 							eg_mode = SUSTINE;
 							UpdateEg();
 						}
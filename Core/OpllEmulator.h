@@ -514,18 +514,21 @@ namespace Vrc7Opll
 			return (int32_t)out;
 		}
 
-		int16_t GetOutput()
+		/* Generates a block of samples */
+		void GetOutput(int16_t* output, uint32_t sampleCount)
 		{
-			while(realstep > oplltime) {
-				oplltime += opllstep;
-				prev = next;
-				next = calc();
-			}
+			for(uint32_t i = 0; i < sampleCount; i++) {
+				while(realstep > oplltime) {
+					oplltime += opllstep;
+					prev = next;
+					next = calc();
+				}
 
-			oplltime -= realstep;
-			out = (int16_t)(((double)next * (opllstep - oplltime) + (double)prev * oplltime) / opllstep);
+				oplltime -= realstep;
+				out = (int16_t)(((double)next * (opllstep - oplltime) + (double)prev * oplltime) / opllstep);
 
-			return (int16_t)out;
+				output[i] = (int16_t)out;
+			}
 		}
 	};
 }
\ No newline at end of file
@@ -135,6 +135,16 @@ namespace Vrc7Opll {
 			return d*(int32_t)(TL_STEP / EG_STEP);
 		}
 
+		uint32_t SL2EG(int32_t d)
+		{
+			return d*(int32_t)(SL_STEP / EG_STEP);
+		}
+
+		uint32_t S2E(double x)
+		{
+			return (SL2EG((int32_t)(x / SL_STEP)) << (EG_DP_BITS - EG_BITS));
+		}
+
 		/* Adjust envelope speed which depends on sampling rate. */
 		uint32_t rate_adjust(double x)
 		{
@@ -184,10 +194,22 @@ namespace Vrc7Opll {
 
 		uint16_t *waveform[2] = { fullsintable, halfsintable };
 
+		/* Sustain level (SL) to envelope phase table */
+		uint32_t slTable[16];
+
 		/* Phase delta for LFO */
 		uint32_t pm_dphase;
 		uint32_t am_dphase;
 
+		/* Table for SL to envelope phase. */
+		void makeSlTable()
+		{
+			static const double levels[16] = { 0.0, 3.0, 6.0, 9.0, 12.0, 15.0, 18.0, 21.0, 24.0, 27.0, 30.0, 33.0, 36.0, 39.0, 42.0, 48.0 };
+			for(int32_t i = 0; i < 16; i++) {
+				slTable[i] = S2E(levels[i]);
+			}
+		}
+
 		/* Table for AR to LogCurve. */
 		void makeAdjustTable()
 		{
@@ -390,6 +412,7 @@ namespace Vrc7Opll {
 			makeTllTable();
 			makeRksTable();
 			makeSinTable();
+			makeSlTable();
 			//makeDefaultPatch ();
 
 			rate = r;
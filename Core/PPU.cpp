@@ -640,7 +640,7 @@ uint16_t PPU::GetAttributeAddr()
 void PPU::SetBusAddress(uint16_t addr)
 {
 	_ppuBusAddress = addr;
-	_console->GetMapper()->NotifyVRAMAddressChange(addr);
+	_console->GetMapper()->ProcessVramAddressChange(addr);
 }
 
 uint8_t PPU::ReadVram(uint16_t addr, MemoryOperationType type)
@@ -1171,7 +1171,10 @@ void PPU::SendFrame()
 {
 	UpdateGrayscaleAndIntensifyBits();
 
-	_console->GetNotificationManager()->SendNotification(ConsoleNotificationType::PpuFrameDone, _currentOutputBuffer);
+	if(!_settings->IsHeadlessMode()) {
+		//Nothing is displayed in headless mode, the listeners (UI, rewind, etc.) don't need to know about the frame
+		_console->GetNotificationManager()->SendNotification(ConsoleNotificationType::PpuFrameDone, _currentOutputBuffer);
+	}
 
 #ifdef LIBRETRO
 	_console->GetVideoDecoder()->UpdateFrameSync(_currentOutputBuffer);
@@ -0,0 +1,104 @@
+#include "stdafx.h"
+#include "PageSnapshotManager.h"
+#include "Console.h"
+#include "MessageManager.h"
+
+PageSnapshotManager::PageSnapshotManager(Console* console)
+{
+	_console = console;
+}
+
+void PageSnapshotManager::UpdateLayout()
+{
+	static atomic<uint32_t> nextLayoutId(1);
+
+	_updatedTrackers.clear();
+	_console->GetDirtyPageTrackers(_updatedTrackers);
+
+	uint32_t pageCount = 0;
+	for(DirtyPageTracker* tracker : _updatedTrackers) {
+		pageCount += tracker->GetPageCount();
+	}
+
+	bool changed = _layoutId == 0 || _updatedTrackers != _trackers || pageCount != (uint32_t)_currentPages.size();
+
+	if(changed) {
+		//A new game was loaded or the console was power cycled, start over from a full copy of the RAM
+		std::swap(_trackers, _updatedTrackers);
+
+		_stats.TrackedBytes = 0;
+		for(DirtyPageTracker* tracker : _trackers) {
+			tracker->MarkAllDirty();
+			_stats.TrackedBytes += tracker->GetSize();
+		}
+		_currentPages.clear();
+		_currentPages.resize(pageCount);
+		_layoutId = nextLayoutId++;
+	}
+}
+
+void PageSnapshotManager::TakeSnapshot(PageSnapshot &snapshot, uint32_t stateSize)
+{
+	UpdateLayout();
+
+	uint32_t storedBytes = 0;
+	uint32_t index = 0;
+	for(DirtyPageTracker* tracker : _trackers) {
+		uint8_t* memory = tracker->GetMemory();
+		uint32_t size = tracker->GetSize();
+		for(uint32_t i = 0, count = tracker->GetPageCount(); i < count; i++, index++) {
+			if(tracker->IsDirty(i)) {
+				uint32_t offset = i << DirtyPageTracker::PageShift;
+				uint32_t length = std::min(DirtyPageTracker::PageSize, size - offset);
+				shared_ptr<RamPage> page = std::make_shared<RamPage>();
+				memcpy(page->Data, memory + offset, length);
+				_currentPages[index] = page;
+				tracker->ClearDirty(i);
+				storedBytes += length;
+			}
+		}
+	}
+
+	snapshot.LayoutId = _layoutId;
+	snapshot.Pages = _currentPages;
+
+	_stats.SnapshotCount++;
+	_stats.StoredBytes += storedBytes;
+	_stats.StateBytes += stateSize;
+}
+
+bool PageSnapshotManager::RestoreSnapshot(PageSnapshot &snapshot)
+{
+	UpdateLayout();
+
+	if(snapshot.LayoutId != _layoutId || snapshot.Pages.size() != _currentPages.size()) {
+		MessageManager::Log("[PageSnapshot] Snapshot does not match the current game's RAM layout.");
+		return false;
+	}
+
+	uint32_t restoredBytes = 0;
+	uint32_t index = 0;
+	for(DirtyPageTracker* tracker : _trackers) {
+		uint8_t* memory = tracker->GetMemory();
+		uint32_t size = tracker->GetSize();
+		for(uint32_t i = 0, count = tracker->GetPageCount(); i < count; i++, index++) {
+			if(tracker->IsDirty(i) || _currentPages[index] != snapshot.Pages[index]) {
+				uint32_t offset = i << DirtyPageTracker::PageShift;
+				uint32_t length = std::min(DirtyPageTracker::PageSize, size - offset);
+				memcpy(memory + offset, snapshot.Pages[index]->Data, length);
+				_currentPages[index] = snapshot.Pages[index];
+				tracker->ClearDirty(i);
+				restoredBytes += length;
+			}
+		}
+	}
+
+	_stats.RestoreCount++;
+	_stats.RestoredBytes += restoredBytes;
+	return true;
+}
+
+PageSnapshotStatistics PageSnapshotManager::GetStatistics()
+{
+	return _stats;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "stdafx.h"
+#include "DirtyPageTracker.h"
+
+class Console;
+
+struct RamPage
+{
+	uint8_t Data[DirtyPageTracker::PageSize];
+};
+
+//Content of every tracked RAM page at the time of the snapshot.
+//Pages that were not modified between 2 snapshots are shared between them, so each snapshot only stores the pages that changed.
+struct PageSnapshot
+{
+	uint32_t LayoutId = 0;
+	vector<shared_ptr<RamPage>> Pages;
+};
+
+struct PageSnapshotStatistics
+{
+	uint64_t SnapshotCount;
+	uint64_t StoredBytes;
+	uint64_t StateBytes;
+	uint64_t RestoreCount;
+	uint64_t RestoredBytes;
+
+	//Total size of the RAM covered by the snapshots (what a regular save state contains)
+	uint32_t TrackedBytes;
+};
+
+//Incremental RAM snapshots for run-ahead and netplay rollback:
+//The internal RAM, work/save RAM, CHR RAM and nametable RAM are excluded from the state stream and saved as 256-byte pages instead.
+//Taking a snapshot only copies the pages written to since the previous snapshot, and restoring one only copies back the pages
+//that differ from the console's current RAM (those written to since the snapshot, or since the state that is being replaced)
+class PageSnapshotManager
+{
+private:
+	Console* _console;
+	uint32_t _layoutId = 0;
+
+	vector<DirtyPageTracker*> _trackers;
+	vector<DirtyPageTracker*> _updatedTrackers;
+
+	//Pages of the last snapshot taken or restored - this matches the RAM's content, except for the dirty pages
+	vector<shared_ptr<RamPage>> _currentPages;
+
+	PageSnapshotStatistics _stats = {};
+
+	void UpdateLayout();
+
+public:
+	PageSnapshotManager(Console* console);
+
+	void TakeSnapshot(PageSnapshot &snapshot, uint32_t stateSize);
+	bool RestoreSnapshot(PageSnapshot &snapshot);
+
+	PageSnapshotStatistics GetStatistics();
+};
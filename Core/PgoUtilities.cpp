@@ -1,38 +1,1008 @@
 #include "stdafx.h"
+#include <iomanip>
 #include <thread>
+#include <random>
 #include "PgoUtilities.h"
 #include "Types.h"
 #include "Debugger.h"
-#include "DebuggerTypes.h"
 #include "Console.h"
+#include "CPU.h"
+#include "EmulationSettings.h"
+#include "ControlManager.h"
+#include "IInputProvider.h"
+#include "StandardController.h"
+#include "PageSnapshotManager.h"
+#include "RomImageCache.h"
+#include "NotificationManager.h"
+#include "FrameProfiler.h"
+#include "GameConnection.h"
+#include "InputDataMessage.h"
+#include "APU.h"
+#include "SoundMixer.h"
+#include "IAudioDevice.h"
+#include "MapperFactory.h"
+#include "RomData.h"
 #include "../Utilities/FolderUtilities.h"
+#include "../Utilities/PlatformUtilities.h"
+#include "../Utilities/Timer.h"
+#include "../Utilities/Socket.h"
+#include "../Utilities/StringUtilities.h"
+#include "../Utilities/HexUtilities.h"
+
+struct BenchmarkMode
+{
+	string Name;
+	VideoFilterType Filter = VideoFilterType::None;
+	bool Video = false;
+	bool Debugger = false;
+	bool HdPack = false;
+	bool RunAhead = false;
+	uint32_t InstanceCount = 1;
+	bool Clone = false;
+	bool Notifications = false;
+	bool NetworkSimulation = false;
+	uint32_t SimulatedLatency = 0;
+	uint32_t SimulatedPacketLoss = 0;
+	bool Headless = false;
+	bool ExpansionAudio = false;
+	bool MapperIrq = false;
+	uint32_t ExtraScanlinesBeforeNmi = 0;
+	uint32_t ExtraScanlinesAfterNmi = 0;
+};
+
+struct BenchmarkResult
+{
+	bool Skipped = false;
+	double ElapsedMs = 0;
+	uint64_t Instructions = 0;
+	uint64_t PpuDots = 0;
+
+	//Instance mode only
+	int64_t FirstInstanceBytes = 0;
+	int64_t BytesPerInstance = 0;
+	uint64_t SharedRomBytes = 0;
+
+	//Clone mode only
+	double CloneMs = 0;
+	double ReusedCloneMs = 0;
+	double FileForkMs = 0;
+	uint32_t FileForkCount = 0;
+
+	//Notifications mode only
+	uint64_t NotificationCount = 0;
+
+	//Network simulation mode only
+	uint32_t MessageCount = 0;
+	double TotalDeliveryMs = 0;
+	double MaxDeliveryMs = 0;
+
+	//Headless mode only
+	double RegularMs = 0;
+
+	//Expansion audio mode only
+	string ChipName;
+	double ReferenceMs = 0;
+	bool AudioMatch = false;
+	uint64_t SampleCount = 0;
+
+	//Mapper IRQ mode only (normal speed, overclocked)
+	uint64_t StateHash[2] = {};
+	uint64_t AudioHash[2] = {};
+};
+
+//Scripted input for player 1: the buttons only depend on the frame number, so every run (and every run ahead frame) receives the same input
+class BenchmarkInputProvider : public IInputProvider
+{
+private:
+	Console* _console;
+
+public:
+	BenchmarkInputProvider(Console* console)
+	{
+		_console = console;
+	}
+
+	bool SetInput(BaseControlDevice* device) override
+	{
+		if(device->GetPort() != 0 || !dynamic_cast<StandardController*>(device)) {
+			return false;
+		}
+
+		//Pick a new set of buttons every 8 frames, and hold start for 8 frames every ~2 seconds to get through title screens & menus
+		uint32_t step = _console->GetFrameCount() / 8;
+		uint32_t buttons = step * 2654435761u;
+		buttons ^= buttons >> 16;
+
+		for(uint8_t i = StandardController::Buttons::Up; i <= StandardController::Buttons::A; i++) {
+			device->SetBitValue(i, (buttons >> i) & 0x01);
+		}
+		device->SetBitValue(StandardController::Buttons::Start, (step % 16) == 0);
+		device->SetBitValue(StandardController::Buttons::Select, false);
+		if(device->IsPressed(StandardController::Buttons::Up)) {
+			device->SetBitValue(StandardController::Buttons::Down, false);
+		}
+		if(device->IsPressed(StandardController::Buttons::Left)) {
+			device->SetBitValue(StandardController::Buttons::Right, false);
+		}
+		return true;
+	}
+};
+
+static bool GetBenchmarkMode(string name, BenchmarkMode &mode)
+{
+	static const std::pair<const char*, VideoFilterType> filterTypes[] = {
+		{ "none", VideoFilterType::None }, { "ntsc", VideoFilterType::NTSC },
+		{ "bisqwitntscquarterres", VideoFilterType::BisqwitNtscQuarterRes }, { "bisqwitntschalfres", VideoFilterType::BisqwitNtscHalfRes }, { "bisqwitntsc", VideoFilterType::BisqwitNtsc },
+		{ "xbrz2x", VideoFilterType::xBRZ2x }, { "xbrz3x", VideoFilterType::xBRZ3x }, { "xbrz4x", VideoFilterType::xBRZ4x }, { "xbrz5x", VideoFilterType::xBRZ5x }, { "xbrz6x", VideoFilterType::xBRZ6x },
+		{ "hq2x", VideoFilterType::HQ2x }, { "hq3x", VideoFilterType::HQ3x }, { "hq4x", VideoFilterType::HQ4x },
+		{ "scale2x", VideoFilterType::Scale2x }, { "scale3x", VideoFilterType::Scale3x }, { "scale4x", VideoFilterType::Scale4x },
+		{ "2xsai", VideoFilterType::_2xSai }, { "super2xsai", VideoFilterType::Super2xSai }, { "supereagle", VideoFilterType::SuperEagle },
+		{ "prescale2x", VideoFilterType::Prescale2x }, { "prescale3x", VideoFilterType::Prescale3x }, { "prescale4x", VideoFilterType::Prescale4x },
+		{ "prescale6x", VideoFilterType::Prescale6x }, { "prescale8x", VideoFilterType::Prescale8x }, { "prescale10x", VideoFilterType::Prescale10x },
+		{ "raw", VideoFilterType::Raw }
+	};
+
+	mode = BenchmarkMode();
+	mode.Name = name;
+
+	if(name == "core") {
+		return true;
+	} else if(name == "debugger") {
+		mode.Debugger = true;
+		return true;
+	} else if(name == "hdpack") {
+		mode.HdPack = true;
+		mode.Video = true;
+		return true;
+	} else if(name == "runahead") {
+		//The frame that is displayed after the run ahead frames is always decoded (with the default filter)
+		mode.RunAhead = true;
+		mode.Video = true;
+		return true;
+	} else if(name == "clone") {
+		mode.Clone = true;
+		return true;
+	} else if(name == "headless") {
+		mode.Headless = true;
+		return true;
+	} else if(name == "expaudio") {
+		mode.ExpansionAudio = true;
+		return true;
+	} else if(name == "mapperirq") {
+		mode.MapperIrq = true;
+		return true;
+	} else if(name == "notifications") {
+		mode.Notifications = true;
+		return true;
+	} else if(name.compare(0, 6, "netsim") == 0) {
+		//netsim[:latency[:packetloss]] - defaults to 20ms of latency with 5% packet loss
+		mode.NetworkSimulation = true;
+		mode.SimulatedLatency = 20;
+		mode.SimulatedPacketLoss = 5;
+		vector<string> args = StringUtilities::Split(name, ':');
+		if(args[0] != "netsim") {
+			return false;
+		}
+		if(args.size() > 1) {
+			mode.SimulatedLatency = atoi(args[1].c_str());
+		}
+		if(args.size() > 2) {
+			mode.SimulatedPacketLoss = std::min(atoi(args[2].c_str()), 100);
+		}
+		return true;
+	} else if(name == "instances") {
+		mode.InstanceCount = 16;
+		return true;
+	} else if(name.compare(0, 10, "instances:") == 0) {
+		mode.InstanceCount = std::max(2, atoi(name.substr(10).c_str()));
+		return true;
+	} else if(name.compare(0, 7, "filter:") == 0) {
+		for(auto &filterType : filterTypes) {
+			if(name.substr(7) == filterType.first) {
+				mode.Filter = filterType.second;
+				mode.Video = true;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+static shared_ptr<Console> LoadBenchmarkConsole(string romPath, BenchmarkMode &mode)
+{
+	shared_ptr<Console> console(new Console());
+	console->Init();
+
+	EmulationSettings* settings = console->GetSettings();
+	settings->SetFlags(EmulationFlags::ConsoleMode);
+	if(mode.HdPack) {
+		settings->SetFlags(EmulationFlags::UseHdPacks);
+	}
+	settings->SetControllerType(0, ControllerType::StandardController);
+	settings->SetVideoFilterType(mode.Filter);
+	settings->SetRunAheadFrames(mode.RunAhead ? 1 : 0);
+	settings->SetPpuNmiConfig(mode.ExtraScanlinesBeforeNmi, mode.ExtraScanlinesAfterNmi);
+
+	if(!console->Initialize(romPath) || (mode.HdPack && !console->GetHdData())) {
+		//The rom couldn't be loaded, or there is no HD pack for it in the HdPacks folder
+		console->Release(true);
+		return nullptr;
+	}
+	return console;
+}
+
+static void RunInstanceBenchmark(string romPath, BenchmarkMode &mode, uint32_t frameCount, BenchmarkResult &result)
+{
+	//Loads the same game in several consoles (e.g to run automated tests in parallel) and measures the memory used by each additional console
+	vector<shared_ptr<Console>> consoles;
+	vector<unique_ptr<BenchmarkInputProvider>> inputProviders;
+
+	int64_t startMemory = (int64_t)PlatformUtilities::GetMemoryUsage();
+	int64_t firstInstanceMemory = 0;
+
+	Timer timer;
+	for(uint32_t i = 0; i < mode.InstanceCount; i++) {
+		shared_ptr<Console> console = LoadBenchmarkConsole(romPath, mode);
+		if(!console) {
+			result.Skipped = true;
+			break;
+		}
+
+		inputProviders.emplace_back(new BenchmarkInputProvider(console.get()));
+		console->GetControlManager()->RegisterInputProvider(inputProviders.back().get());
+		console->GetSettings()->SetRunAheadFrameFlag(true);
+		consoles.push_back(console);
+
+		//Run each console for a while, to make sure all of its memory has been allocated & used
+		uint64_t startInstructions = console->GetCpu()->GetInstructionCount();
+		for(uint32_t j = 0; j < frameCount; j++) {
+			console->RunSingleFrame();
+		}
+		result.Instructions += console->GetCpu()->GetInstructionCount() - startInstructions;
+		result.PpuDots += (uint64_t)frameCount * 341 * (console->GetModel() == NesModel::NTSC ? 262 : 312);
+
+		if(i == 0) {
+			firstInstanceMemory = (int64_t)PlatformUtilities::GetMemoryUsage();
+		}
+	}
+	result.ElapsedMs = timer.GetElapsedMS();
+
+	if(!result.Skipped) {
+		result.FirstInstanceBytes = firstInstanceMemory - startMemory;
+		result.BytesPerInstance = ((int64_t)PlatformUtilities::GetMemoryUsage() - firstInstanceMemory) / (int64_t)(mode.InstanceCount - 1);
+		result.SharedRomBytes = RomImageCache::GetStatistics().ImageBytes;
+	}
+
+	for(size_t i = 0; i < consoles.size(); i++) {
+		consoles[i]->GetSettings()->SetRunAheadFrameFlag(false);
+		consoles[i]->GetControlManager()->UnregisterInputProvider(inputProviders[i].get());
+		consoles[i]->Release(true);
+	}
+}
+
+static void RunCloneBenchmark(string romPath, BenchmarkMode &mode, uint32_t frameCount, BenchmarkResult &result)
+{
+	//Forks the console on every frame (like a search-based tool trying out inputs from the same state), each fork runs a frame before being released
+	shared_ptr<Console> console = LoadBenchmarkConsole(romPath, mode);
+	if(!console) {
+		result.Skipped = true;
+		return;
+	}
+
+	BenchmarkInputProvider inputProvider(console.get());
+	console->GetControlManager()->RegisterInputProvider(&inputProvider);
+	console->GetSettings()->SetRunAheadFrameFlag(true);
+	console->RunSingleFrame();
+
+	CPU* cpu = console->GetCpu();
+	uint64_t startInstructions = cpu->GetInstructionCount();
+	shared_ptr<Console> reusedClone;
+	Timer timer;
+	for(uint32_t i = 0; i < frameCount; i++) {
+		console->RunSingleFrame();
+
+		Timer cloneTimer;
+		shared_ptr<Console> clone = console->Clone();
+		result.CloneMs += cloneTimer.GetElapsedMS();
+
+		//Same thing, but reusing the console that was cloned on the previous frame
+		cloneTimer.Reset();
+		reusedClone = console->Clone(reusedClone);
+		result.ReusedCloneMs += cloneTimer.GetElapsedMS();
+
+		for(Console* fork : { clone.get(), reusedClone.get() }) {
+			uint64_t forkInstructions = fork->GetCpu()->GetInstructionCount();
+			fork->RunHeadlessFrames(1);
+			result.Instructions += fork->GetCpu()->GetInstructionCount() - forkInstructions;
+		}
+		clone->Release(true);
+	}
+	result.ElapsedMs = timer.GetElapsedMS();
+	result.Instructions += cpu->GetInstructionCount() - startInstructions;
+	result.PpuDots = (uint64_t)frameCount * 3 * 341 * (console->GetModel() == NesModel::NTSC ? 262 : 312);
+	reusedClone->Release(true);
+
+	//Fork the same way without Clone(): load the game in a new console and load a save state from the source console
+	result.FileForkCount = std::min<uint32_t>(frameCount, 60);
+	for(uint32_t i = 0; i < result.FileForkCount; i++) {
+		Timer forkTimer;
+		shared_ptr<Console> fork = LoadBenchmarkConsole(romPath, mode);
+		stringstream state;
+		console->SaveState(state);
+		fork->LoadState(state);
+		result.FileForkMs += forkTimer.GetElapsedMS();
+		fork->Release(true);
+	}
+
+	console->GetSettings()->SetRunAheadFrameFlag(false);
+	console->GetControlManager()->UnregisterInputProvider(&inputProvider);
+	console->Release(true);
+}
+
+class BenchmarkNotificationListener : public INotificationListener
+{
+public:
+	uint64_t CallCount = 0;
+
+	void ProcessNotification(ConsoleNotificationType type, void* parameter) override
+	{
+		CallCount++;
+	}
+};
+
+//Measures the cost of SendNotification alone, with the same set of listeners as a netplay host that is recording a movie with rewind enabled
+//The rom is not used - the notification manager is not attached to a console, so no other code runs when a notification is sent
+static void RunNotificationBenchmark(BenchmarkMode &mode, uint32_t frameCount, BenchmarkResult &result)
+{
+	NotificationManager notificationManager(shared_ptr<FrameProfiler>(new FrameProfiler()));
+	vector<shared_ptr<BenchmarkNotificationListener>> listeners;
+	auto addListener = [&](std::initializer_list<ConsoleNotificationType> types) {
+		listeners.push_back(shared_ptr<BenchmarkNotificationListener>(new BenchmarkNotificationListener()));
+		if(types.size() == 0) {
+			notificationManager.RegisterNotificationListener(listeners.back());
+		} else {
+			notificationManager.RegisterNotificationListener(listeners.back(), types);
+		}
+	};
+
+	//UI & rewind manager
+	addListener({});
+	addListener({ ConsoleNotificationType::PpuFrameDone, ConsoleNotificationType::StateLoaded });
+
+	//Movie recorder & netplay server
+	addListener({ ConsoleNotificationType::GameLoaded });
+	addListener({ ConsoleNotificationType::GameLoaded });
+
+	//Netplay clients
+	for(int i = 0; i < 4; i++) {
+		addListener({
+			ConsoleNotificationType::GamePaused, ConsoleNotificationType::GameResumed, ConsoleNotificationType::GameReset, ConsoleNotificationType::StateLoaded,
+			ConsoleNotificationType::CheatAdded, ConsoleNotificationType::ConfigChanged, ConsoleNotificationType::GameInitCompleted
+		});
+	}
+
+	//1000 notifications per frame, about as many as a frame takes to emulate
+	result.NotificationCount = (uint64_t)frameCount * 1000;
+	Timer timer;
+	for(uint64_t i = 0; i < result.NotificationCount; i++) {
+		notificationManager.SendNotification(ConsoleNotificationType::PpuFrameDone);
+	}
+	result.ElapsedMs = timer.GetElapsedMS();
+
+	uint64_t callCount = 0;
+	for(shared_ptr<BenchmarkNotificationListener> &listener : listeners) {
+		callCount += listener->CallCount;
+	}
+	if(callCount != result.NotificationCount * 2) {
+		std::cerr << "Unexpected number of notifications received: " << callCount << std::endl;
+	}
+}
+
+//Receiving end of the network simulation benchmark, records how long each message took to be delivered
+class BenchmarkConnection : public GameConnection
+{
+private:
+	Timer &_timer;
+	vector<double> &_sendTimes;
+	BenchmarkResult &_result;
+
+	void ProcessMessage(NetMessage* message) override
+	{
+		vector<uint8_t> state = ((InputDataMessage*)message)->GetInputState().State;
+		uint32_t index = state[0] | (state[1] << 8) | (state[2] << 16) | ((uint32_t)state[3] << 24);
+		if(index < _sendTimes.size()) {
+			double deliveryMs = _timer.GetElapsedMS() - _sendTimes[index];
+			_result.MessageCount++;
+			_result.TotalDeliveryMs += deliveryMs;
+			_result.MaxDeliveryMs = std::max(_result.MaxDeliveryMs, deliveryMs);
+		}
+	}
+
+public:
+	BenchmarkConnection(shared_ptr<Socket> socket, Timer &timer, vector<double> &sendTimes, BenchmarkResult &result)
+		: GameConnection(nullptr, socket), _timer(timer), _sendTimes(sendTimes), _result(result)
+	{
+	}
+};
+
+//Sends one input message per frame over a loopback connection, and receives them through the netplay client's latency/packet loss simulation
+//The rom is not used - skipped when sockets are not available (e.g libretro builds)
+static void RunNetworkSimulationBenchmark(BenchmarkMode &mode, uint32_t frameCount, BenchmarkResult &result)
+{
+	//Try the next ports if the port is still in use (e.g by a connection from a previous run that is in TIME_WAIT)
+	unique_ptr<Socket> listener;
+	uint16_t port = 8897;
+	for(int i = 0; i < 10; i++, port++) {
+		listener.reset(new Socket());
+		listener->Bind(port);
+		if(!listener->ConnectionError()) {
+			break;
+		}
+	}
+	listener->Listen(1);
+
+	shared_ptr<Socket> sender(new Socket());
+	if(listener->ConnectionError() || !sender->Connect("127.0.0.1", port)) {
+		result.Skipped = true;
+		return;
+	}
+
+	shared_ptr<Socket> receiverSocket = listener->Accept();
+	Timer timer;
+	while(receiverSocket->ConnectionError() && timer.GetElapsedMS() < 3000) {
+		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(1));
+		receiverSocket = listener->Accept();
+	}
+	if(receiverSocket->ConnectionError()) {
+		result.Skipped = true;
+		return;
+	}
+
+	vector<double> sendTimes;
+	sendTimes.reserve(frameCount);
+	BenchmarkConnection receiver(receiverSocket, timer, sendTimes, result);
+	receiver.SetNetworkSimulation(mode.SimulatedLatency, mode.SimulatedPacketLoss);
+
+	//Messages are sent at 60 per second (one per frame) and received on the same thread, which polls the connection every 1ms like the netplay client's thread
+	timer.Reset();
+	for(uint32_t i = 0; i < frameCount;) {
+		if(timer.GetElapsedMS() >= i * 1000.0 / 60) {
+			ControlDeviceState state;
+			state.State = { (uint8_t)i, (uint8_t)(i >> 8), (uint8_t)(i >> 16), (uint8_t)(i >> 24) };
+			InputDataMessage message(state);
+			sendTimes.push_back(timer.GetElapsedMS());
+			message.Send(*sender);
+			i++;
+		}
+
+		receiver.ProcessMessages();
+		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(1));
+	}
+
+	//Wait for the messages that are still being delayed
+	double timeout = timer.GetElapsedMS() + 5000 + mode.SimulatedLatency * 3;
+	while(result.MessageCount < frameCount && timer.GetElapsedMS() < timeout) {
+		receiver.ProcessMessages();
+		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(1));
+	}
+	result.ElapsedMs = timer.GetElapsedMS();
+
+	//Close the sender first, so the listening port is not the one left in TIME_WAIT
+	sender->Close();
+
+	if(result.MessageCount != frameCount) {
+		std::cerr << "Messages lost: " << (frameCount - result.MessageCount) << std::endl;
+	}
+}
+
+//Runs the same frames with the same input twice, from power on: with RunSingleFrame (video decoding, audio mixing, end of frame processing, frame notifications)
+//and with RunHeadlessFrames - a listener receives every notification in both cases, like the UI does
+static void RunHeadlessBenchmark(string romPath, BenchmarkMode &mode, uint32_t frameCount, BenchmarkResult &result)
+{
+	shared_ptr<BenchmarkNotificationListener> uiListener(new BenchmarkNotificationListener());
+	uint64_t regularInstructions = 0;
+	for(bool headless : { false, true }) {
+		shared_ptr<Console> console = LoadBenchmarkConsole(romPath, mode);
+		if(!console) {
+			result.Skipped = true;
+			return;
+		}
+		console->GetNotificationManager()->RegisterNotificationListener(uiListener);
+
+		BenchmarkInputProvider inputProvider(console.get());
+		console->GetControlManager()->RegisterInputProvider(&inputProvider);
+
+		CPU* cpu = console->GetCpu();
+		uint64_t startInstructions = cpu->GetInstructionCount();
+		Timer timer;
+		if(headless) {
+			console->RunHeadlessFrames(frameCount);
+			result.ElapsedMs = timer.GetElapsedMS();
+			result.Instructions = cpu->GetInstructionCount() - startInstructions;
+			result.PpuDots = (uint64_t)frameCount * 341 * (console->GetModel() == NesModel::NTSC ? 262 : 312);
+		} else {
+			for(uint32_t i = 0; i < frameCount; i++) {
+				console->RunSingleFrame();
+			}
+			result.RegularMs = timer.GetElapsedMS();
+			regularInstructions = cpu->GetInstructionCount() - startInstructions;
+		}
+
+		console->GetControlManager()->UnregisterInputProvider(&inputProvider);
+		console->Release(true);
+	}
+
+	if(regularInstructions != result.Instructions) {
+		std::cerr << "Headless and regular runs did not emulate the same instructions: " << result.Instructions << " vs " << regularInstructions << std::endl;
+	}
+}
+
+//Hashes the mixed audio output, to compare the output of two runs
+class BenchmarkAudioDevice : public IAudioDevice
+{
+public:
+	uint64_t Hash = 14695981039346656037ull;
+	uint64_t SampleCount = 0;
+
+	void PlayBuffer(int16_t *soundBuffer, uint32_t bufferSize, uint32_t sampleRate, bool isStereo) override
+	{
+		uint32_t count = bufferSize * (isStereo ? 2 : 1);
+		for(uint32_t i = 0; i < count; i++) {
+			Hash = (Hash ^ (uint16_t)soundBuffer[i]) * 1099511628211ull;
+		}
+		SampleCount += bufferSize;
+	}
+
+	void Stop() override { }
+	void Pause() override { }
+	void ProcessEndOfFrame() override { }
+	void UpdateSoundSettings() override { }
+	string GetAvailableDevices() override { return ""; }
+	void SetAudioDevice(string deviceName) override { }
+	AudioStatistics GetStatistics() override { return AudioStatistics(); }
+};
+
+static string GetExpansionAudioChipName(uint16_t mapperId)
+{
+	switch(mapperId) {
+		case 5: return "MMC5";
+		case 19: return "Namco163";
+		case 24: case 26: return "VRC6";
+		case 69: return "Sunsoft5B";
+		case 85: return "VRC7";
+		case 284: return "DripGame";
+		case MapperFactory::FdsMapperID: return "FDS";
+		case MapperFactory::NsfMapperID: return "NSF";
+		default: return "";
+	}
+}
+
+//Runs the same frames with the same input twice, from power on: with the expansion audio chip catching up when its state is needed (like the emulation
+//does) and with the chip clocked on every cycle through its per-cycle ClockAudio implementation (reference) - the mixed audio output of both runs must be identical
+static void RunExpansionAudioBenchmark(string romPath, BenchmarkMode &mode, uint32_t frameCount, BenchmarkResult &result)
+{
+	uint64_t hashes[2] = {};
+	uint64_t sampleCounts[2] = {};
+	for(bool reference : { false, true }) {
+		shared_ptr<Console> console = LoadBenchmarkConsole(romPath, mode);
+		if(!console) {
+			result.Skipped = true;
+			return;
+		}
+
+		result.ChipName = GetExpansionAudioChipName(console->GetRomInfo().MapperID);
+		if(result.ChipName.empty()) {
+			//No expansion audio on this board
+			console->Release(true);
+			result.Skipped = true;
+			return;
+		}
+
+		BenchmarkAudioDevice audioDevice;
+		console->GetSoundMixer()->RegisterAudioDevice(&audioDevice);
+
+		BenchmarkInputProvider inputProvider(console.get());
+		console->GetControlManager()->RegisterInputProvider(&inputProvider);
+
+		console->GetApu()->SetExpansionAudioReferenceMode(reference);
+
+		CPU* cpu = console->GetCpu();
+		uint64_t startInstructions = cpu->GetInstructionCount();
+		Timer timer;
+		for(uint32_t i = 0; i < frameCount; i++) {
+			console->RunSingleFrame();
+		}
+		if(reference) {
+			result.ReferenceMs = timer.GetElapsedMS();
+		} else {
+			result.ElapsedMs = timer.GetElapsedMS();
+			result.Instructions = cpu->GetInstructionCount() - startInstructions;
+			result.PpuDots = (uint64_t)frameCount * 341 * (console->GetModel() == NesModel::NTSC ? 262 : 312);
+		}
+		hashes[reference] = audioDevice.Hash;
+		sampleCounts[reference] = audioDevice.SampleCount;
+
+		console->GetSoundMixer()->RegisterAudioDevice(nullptr);
+		console->GetControlManager()->UnregisterInputProvider(&inputProvider);
+		console->Release(true);
+	}
+
+	result.SampleCount = sampleCounts[0];
+	result.AudioMatch = hashes[0] == hashes[1] && sampleCounts[0] == sampleCounts[1];
+	if(!result.AudioMatch) {
+		std::cerr << "Expansion audio output does not match the reference (per-cycle) output: " << romPath << " (" << result.ChipName << ")" << std::endl;
+	}
+}
+
+//Runs the rom twice from power on, at the normal speed and with extra (overclock) scanlines, with a save state reloaded halfway through each run
+//The state after each frame and the audio output are hashed: comparing the hashes produced by two builds shows whether the emulation changed
+//(this is used with the test roms written by PgoGenerateMapperTestRoms, to check the mappers' IRQ counters & expansion audio)
+static void RunMapperIrqBenchmark(string romPath, BenchmarkMode &mode, uint32_t frameCount, BenchmarkResult &result)
+{
+	for(bool overclock : { false, true }) {
+		BenchmarkMode runMode = mode;
+		runMode.ExtraScanlinesBeforeNmi = overclock ? 20 : 0;
+		runMode.ExtraScanlinesAfterNmi = overclock ? 30 : 0;
+		shared_ptr<Console> console = LoadBenchmarkConsole(romPath, runMode);
+		if(!console) {
+			result.Skipped = true;
+			return;
+		}
+
+		BenchmarkAudioDevice audioDevice;
+		console->GetSoundMixer()->RegisterAudioDevice(&audioDevice);
+
+		BenchmarkInputProvider inputProvider(console.get());
+		console->GetControlManager()->RegisterInputProvider(&inputProvider);
+
+		uint64_t stateHash = 14695981039346656037ull;
+		CPU* cpu = console->GetCpu();
+		uint64_t startInstructions = cpu->GetInstructionCount();
+		Timer timer;
+		for(uint32_t i = 0; i < frameCount; i++) {
+			console->RunSingleFrame();
+
+			stringstream state;
+			console->SaveState(state);
+			string stateData = state.str();
+			for(char c : stateData) {
+				stateHash = (stateHash ^ (uint8_t)c) * 1099511628211ull;
+			}
+
+			if(i == frameCount / 2) {
+				//Reload the state, the mappers must resume their counters from the values that were saved
+				console->LoadState(state);
+			}
+		}
+
+		int index = overclock ? 1 : 0;
+		if(!overclock) {
+			result.ElapsedMs = timer.GetElapsedMS();
+			result.Instructions = cpu->GetInstructionCount() - startInstructions;
+			result.PpuDots = (uint64_t)frameCount * 341 * (console->GetModel() == NesModel::NTSC ? 262 : 312);
+		}
+		result.StateHash[index] = stateHash;
+		result.AudioHash[index] = audioDevice.Hash;
+
+		console->GetSoundMixer()->RegisterAudioDevice(nullptr);
+		console->GetControlManager()->UnregisterInputProvider(&inputProvider);
+		console->Release(true);
+	}
+}
+
+static void RunBenchmark(string romPath, BenchmarkMode &mode, uint32_t frameCount, BenchmarkResult &result)
+{
+	if(mode.InstanceCount > 1) {
+		RunInstanceBenchmark(romPath, mode, frameCount, result);
+		return;
+	} else if(mode.Clone) {
+		RunCloneBenchmark(romPath, mode, frameCount, result);
+		return;
+	} else if(mode.Notifications) {
+		RunNotificationBenchmark(mode, frameCount, result);
+		return;
+	} else if(mode.NetworkSimulation) {
+		RunNetworkSimulationBenchmark(mode, frameCount, result);
+		return;
+	} else if(mode.Headless) {
+		RunHeadlessBenchmark(romPath, mode, frameCount, result);
+		return;
+	} else if(mode.ExpansionAudio) {
+		RunExpansionAudioBenchmark(romPath, mode, frameCount, result);
+		return;
+	} else if(mode.MapperIrq) {
+		RunMapperIrqBenchmark(romPath, mode, frameCount, result);
+		return;
+	}
+
+	shared_ptr<Console> console = LoadBenchmarkConsole(romPath, mode);
+	if(!console) {
+		result.Skipped = true;
+		return;
+	}
+	EmulationSettings* settings = console->GetSettings();
+
+	if(mode.Debugger) {
+		console->GetDebugger(true);
+	}
+
+	BenchmarkInputProvider inputProvider(console.get());
+	console->GetControlManager()->RegisterInputProvider(&inputProvider);
+
+	//Frames are run on this thread, without the emulation thread's frame limiter - the video decoder decodes frames synchronously when its thread isn't running
+	//The run ahead flag is used to skip video output for the modes that don't use it
+	settings->SetRunAheadFrameFlag(!mode.Video);
+
+	//The first frame is not measured (the video filter and the debugger are initialized on the first frame)
+	console->RunSingleFrame();
+
+	CPU* cpu = console->GetCpu();
+	uint64_t startInstructions = cpu->GetInstructionCount();
+	Timer timer;
+	for(uint32_t i = 0; i < frameCount; i++) {
+		if(mode.RunAhead) {
+			//Same steps as the emulation thread's run ahead loop
+			stringstream runAheadState;
+			PageSnapshot runAheadPages;
+			console->RunFrameWithRunAhead(runAheadState, runAheadPages);
+			settings->SetRunAheadFrameFlag(true);
+			console->LoadState(runAheadState, runAheadPages);
+			settings->SetRunAheadFrameFlag(false);
+		} else {
+			console->RunSingleFrame();
+		}
+	}
+	result.ElapsedMs = timer.GetElapsedMS();
+	result.Instructions = cpu->GetInstructionCount() - startInstructions;
+
+	//Frames that were emulated (including run ahead frames), not the number of frames that were displayed
+	uint64_t emulatedFrames = (uint64_t)frameCount * (mode.RunAhead ? 2 : 1);
+	uint32_t scanlineCount = console->GetModel() == NesModel::NTSC ? 262 : 312;
+	result.PpuDots = emulatedFrames * 341 * scanlineCount;
+
+	settings->SetRunAheadFrameFlag(false);
+	console->GetControlManager()->UnregisterInputProvider(&inputProvider);
+	console->Release(true);
+}
+
+struct MapperTestRegister
+{
+	uint16_t Address;
+	vector<uint8_t> Values; //Random value when empty
+};
+
+struct MapperTestRom
+{
+	string Name;
+	uint16_t MapperId;
+	uint8_t SubMapperId;
+	vector<MapperTestRegister> Registers;
+	vector<std::pair<uint16_t, uint8_t>> IrqAck;
+	vector<std::pair<uint16_t, uint8_t>> Setup;
+};
+
+static vector<uint8_t> GetValueRange(uint8_t count)
+{
+	vector<uint8_t> values;
+	for(int i = 0; i < count; i++) {
+		values.push_back((uint8_t)i);
+	}
+	return values;
+}
+
+//Builds a 32kb PRG/8kb CHR rom whose code (in the last PRG bank) writes a random script of register writes, with random delays between the writes
+//$00-$01 is a counter incremented by the delay loops, $02 counts the IRQs and the IRQ handler logs the counter's value at the time of each IRQ in $201-$2FF
+static vector<uint8_t> BuildMapperTestRom(MapperTestRom &rom, uint32_t seed)
+{
+	constexpr uint32_t scriptLength = 60;
+	constexpr uint16_t scriptAddr = 0xE800;
+
+	vector<uint8_t> code;
+	auto emit = [&code](std::initializer_list<uint8_t> bytes) { code.insert(code.end(), bytes); };
+	auto here = [&code]() { return (uint16_t)(0xE000 + code.size()); };
+	auto emitWrite = [&emit](uint16_t addr, uint8_t value) { emit({ 0xA9, value, 0x8D, (uint8_t)addr, (uint8_t)(addr >> 8) }); }; //LDA #value, STA addr
+
+	uint16_t resetAddr = here();
+	emit({ 0x78, 0xD8, 0xA2, 0xFF, 0x9A }); //SEI, CLD, LDX #$FF, TXS
+	emit({ 0xA9, 0x00, 0x85, 0x00, 0x85, 0x01, 0x85, 0x02 }); //LDA #0, STA $00, STA $01, STA $02
+	emitWrite(0x4017, 0x40); //Disable the APU frame counter's IRQ
+	for(std::pair<uint16_t, uint8_t> &write : rom.Setup) {
+		emitWrite(write.first, write.second);
+	}
+	emit({ 0xA0, 0x00, 0x58 }); //LDY #0, CLI
+
+	//Each script entry is: address (2 bytes), value, delay
+	uint16_t loopAddr = here();
+	emit({ 0xB9, (uint8_t)scriptAddr, (uint8_t)(scriptAddr >> 8), 0x85, 0x10 }); //LDA script,Y, STA $10
+	emit({ 0xB9, (uint8_t)(scriptAddr + 1), (uint8_t)(scriptAddr >> 8), 0x85, 0x11 }); //LDA script+1,Y, STA $11
+	emit({ 0xB9, (uint8_t)(scriptAddr + 2), (uint8_t)(scriptAddr >> 8), 0xA2, 0x00, 0x81, 0x10 }); //LDA script+2,Y, LDX #0, STA ($10,X)
+	emit({ 0xB9, (uint8_t)(scriptAddr + 3), (uint8_t)(scriptAddr >> 8), 0xAA }); //LDA script+3,Y, TAX
+	uint16_t delayAddr = here();
+	emit({ 0xE6, 0x00, 0xD0, 0x02, 0xE6, 0x01, 0xCA }); //INC $00, BNE +2, INC $01, DEX
+	emit({ 0xD0, (uint8_t)(delayAddr - (here() + 2)) }); //BNE delay
+	emit({ 0xC8, 0xC8, 0xC8, 0xC8, 0xC0, (uint8_t)(scriptLength * 4) }); //INY x4, CPY #length
+	emit({ 0xD0, (uint8_t)(loopAddr - (here() + 2)) }); //BNE loop
+	emit({ 0xA0, 0x00, 0x4C, (uint8_t)loopAddr, (uint8_t)(loopAddr >> 8) }); //LDY #0, JMP loop
+
+	uint16_t irqAddr = here();
+	emit({ 0x48, 0x8A, 0x48 }); //PHA, TXA, PHA
+	emit({ 0xE6, 0x02, 0xA6, 0x02, 0xA5, 0x00, 0x9D, 0x00, 0x02 }); //INC $02, LDX $02, LDA $00, STA $200,X
+	for(std::pair<uint16_t, uint8_t> &write : rom.IrqAck) {
+		emitWrite(write.first, write.second);
+	}
+	emit({ 0x68, 0xAA, 0x68, 0x40 }); //PLA, TAX, PLA, RTI
+
+	uint16_t nmiAddr = here();
+	emit({ 0x40 }); //RTI
+
+	vector<uint8_t> codeBank(0x2000, 0xFF);
+	std::copy(code.begin(), code.end(), codeBank.begin());
+
+	std::mt19937 random(seed);
+	for(uint32_t i = 0; i < scriptLength; i++) {
+		MapperTestRegister &reg = rom.Registers[random() % rom.Registers.size()];
+		uint8_t* entry = codeBank.data() + (scriptAddr - 0xE000) + i * 4;
+		entry[0] = (uint8_t)reg.Address;
+		entry[1] = (uint8_t)(reg.Address >> 8);
+		entry[2] = reg.Values.empty() ? (uint8_t)random() : reg.Values[random() % reg.Values.size()];
+		entry[3] = (uint8_t)(1 + random() % 255);
+	}
+
+	uint16_t vectors[3] = { nmiAddr, resetAddr, irqAddr };
+	for(int i = 0; i < 3; i++) {
+		codeBank[0x1FFA + i * 2] = (uint8_t)vectors[i];
+		codeBank[0x1FFB + i * 2] = (uint8_t)(vectors[i] >> 8);
+	}
+
+	//NES 2.0 headers are only used for submappers (with 8kb of PRG RAM)
+	bool nes20 = rom.SubMapperId != 0;
+	vector<uint8_t> romData = { 'N', 'E', 'S', 0x1A, 2, 1, (uint8_t)((rom.MapperId & 0x0F) << 4), (uint8_t)((rom.MapperId & 0xF0) | (nes20 ? 0x08 : 0x00)) };
+	if(nes20) {
+		romData.insert(romData.end(), { (uint8_t)((rom.SubMapperId << 4) | (rom.MapperId >> 8)), 0, 0x07, 0, 0, 0, 0, 0 });
+	} else {
+		romData.insert(romData.end(), 8, 0);
+	}
+
+	//The first 3 PRG banks are filled with their bank number
+	for(uint8_t i = 0; i < 3; i++) {
+		romData.insert(romData.end(), 0x2000, i);
+	}
+	romData.insert(romData.end(), codeBank.begin(), codeBank.end());
+	for(uint32_t i = 0; i < 0x2000; i++) {
+		romData.push_back((uint8_t)(i * 7));
+	}
+	return romData;
+}
+
+static string EscapeJson(string str)
+{
+	string result;
+	for(char c : str) {
+		if(c == '"' || c == '\\') {
+			result += '\\';
+		}
+		result += c;
+	}
+	return result;
+}
 
 extern "C" {
-	void __stdcall PgoRunTest(vector<string> testRoms, bool enableDebugger)
+	void __stdcall PgoRunBenchmark(vector<string> testRoms, vector<string> modes, uint32_t frameCount, string outputFile)
 	{
-		const VideoFilterType filterTypes[13] = { VideoFilterType::BisqwitNtscQuarterRes, VideoFilterType::HQ2x, VideoFilterType::HQ3x, VideoFilterType::HQ4x, VideoFilterType::NTSC, VideoFilterType::Scale2x, VideoFilterType::Scale3x, VideoFilterType::Scale4x, VideoFilterType::xBRZ2x, VideoFilterType::xBRZ3x, VideoFilterType::xBRZ4x, VideoFilterType::xBRZ5x, VideoFilterType::xBRZ6x };
 		FolderUtilities::SetHomeFolder("../PGOMesenHome");
 
-		for(size_t i = 0; i < testRoms.size(); i++) {
-			std::cout << "Running: " << testRoms[i] << std::endl;
+		if(modes.empty()) {
+			//Runs every mode, the same code paths the previous (time-based) PGO run used to go through
+			modes = { "core", "debugger", "hdpack", "runahead", "filter:ntsc", "filter:bisqwitntscquarterres", "filter:hq2x", "filter:hq3x", "filter:hq4x", "filter:scale2x", "filter:scale3x", "filter:scale4x", "filter:xbrz2x", "filter:xbrz3x", "filter:xbrz4x", "filter:xbrz5x", "filter:xbrz6x" };
+		}
 
-			shared_ptr<Console> console(new Console());
-			console->Init();
-			console->Initialize(testRoms[i]);
-			console->GetSettings()->SetFlags(EmulationFlags::ConsoleMode | EmulationFlags::UseHdPacks);
-			console->GetSettings()->SetVideoFilterType(filterTypes[i % 13]);
+		std::stringstream json;
+		json << std::fixed << std::setprecision(3);
+		json << "{" << std::endl;
+		json << "  \"frameCount\": " << frameCount << "," << std::endl;
+		json << "  \"results\": [";
 
-			if(enableDebugger) {
-				console->GetDebugger(true)->SetFlags((uint32_t)DebuggerFlags::BreakOnFirstCycle);
+		bool firstResult = true;
+		for(string &romPath : testRoms) {
+			for(string &modeName : modes) {
+				BenchmarkMode mode;
+				if(!GetBenchmarkMode(modeName, mode)) {
+					std::cerr << "Unknown benchmark mode: " << modeName << std::endl;
+					continue;
+				}
+
+				std::cerr << "Running: " << romPath << " (" << mode.Name << ")" << std::endl;
+
+				BenchmarkResult result;
+				RunBenchmark(romPath, mode, frameCount, result);
+
+				json << (firstResult ? "" : ",") << std::endl;
+				json << "    { \"rom\": \"" << EscapeJson(FolderUtilities::GetFilename(romPath, true)) << "\", \"mode\": \"" << EscapeJson(mode.Name) << "\", ";
+				json << "\"video\": " << (mode.Video ? "true" : "false") << ", ";
+				if(result.Skipped) {
+					json << "\"skipped\": true }";
+				} else {
+					double elapsedNs = result.ElapsedMs * 1000000;
+					json << "\"skipped\": false, ";
+					json << "\"elapsedMs\": " << result.ElapsedMs << ", ";
+					json << "\"fps\": " << (result.ElapsedMs > 0 ? (double)frameCount * mode.InstanceCount * 1000 / result.ElapsedMs : 0) << ", ";
+					json << "\"instructions\": " << result.Instructions << ", ";
+					json << "\"nsPerInstruction\": " << (result.Instructions ? elapsedNs / result.Instructions : 0) << ", ";
+					json << "\"nsPerPpuDot\": " << (result.PpuDots ? elapsedNs / result.PpuDots : 0);
+					if(mode.InstanceCount > 1) {
+						json << ", \"instances\": " << mode.InstanceCount << ", ";
+						json << "\"firstInstanceBytes\": " << result.FirstInstanceBytes << ", ";
+						json << "\"bytesPerInstance\": " << result.BytesPerInstance << ", ";
+						json << "\"sharedRomBytes\": " << result.SharedRomBytes;
+					} else if(mode.Clone) {
+						json << ", \"forksPerSecond\": " << (result.CloneMs > 0 ? frameCount * 1000 / result.CloneMs : 0) << ", ";
+						json << "\"usPerFork\": " << result.CloneMs * 1000 / frameCount << ", ";
+						json << "\"usPerReusedFork\": " << result.ReusedCloneMs * 1000 / frameCount << ", ";
+						json << "\"usPerFileFork\": " << (result.FileForkCount ? result.FileForkMs * 1000 / result.FileForkCount : 0);
+					} else if(mode.Notifications) {
+						json << ", \"notifications\": " << result.NotificationCount << ", ";
+						json << "\"nsPerNotification\": " << (result.NotificationCount ? elapsedNs / result.NotificationCount : 0);
+					} else if(mode.NetworkSimulation) {
+						json << ", \"simulatedLatency\": " << mode.SimulatedLatency << ", ";
+						json << "\"simulatedPacketLoss\": " << mode.SimulatedPacketLoss << ", ";
+						json << "\"messages\": " << result.MessageCount << ", ";
+						json << "\"avgDeliveryMs\": " << (result.MessageCount ? result.TotalDeliveryMs / result.MessageCount : 0) << ", ";
+						json << "\"maxDeliveryMs\": " << result.MaxDeliveryMs;
+					} else if(mode.Headless) {
+						json << ", \"regularFps\": " << (result.RegularMs > 0 ? (double)frameCount * 1000 / result.RegularMs : 0) << ", ";
+						json << "\"headlessSpeedup\": " << (result.ElapsedMs > 0 ? result.RegularMs / result.ElapsedMs : 0);
+					} else if(mode.ExpansionAudio) {
+						json << ", \"chip\": \"" << result.ChipName << "\", ";
+						json << "\"referenceFps\": " << (result.ReferenceMs > 0 ? (double)frameCount * 1000 / result.ReferenceMs : 0) << ", ";
+						json << "\"samples\": " << result.SampleCount << ", ";
+						json << "\"audioMatch\": " << (result.AudioMatch ? "true" : "false");
+					} else if(mode.MapperIrq) {
+						json << ", \"stateHash\": \"" << HexUtilities::ToHex(result.StateHash[0], true) << "\", ";
+						json << "\"audioHash\": \"" << HexUtilities::ToHex(result.AudioHash[0], true) << "\", ";
+						json << "\"overclockStateHash\": \"" << HexUtilities::ToHex(result.StateHash[1], true) << "\", ";
+						json << "\"overclockAudioHash\": \"" << HexUtilities::ToHex(result.AudioHash[1], true) << "\"";
+					}
+					json << " }";
+				}
+				firstResult = false;
 			}
+		}
 
-			thread testThread([&console] {
-				console->Run();
-			});
-			std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(5000));
-			console->Stop();
-			testThread.join();
-			console->Release(true);
+		json << std::endl << "  ]" << std::endl << "}" << std::endl;
+
+		if(outputFile.empty()) {
+			std::cout << json.str();
+		} else {
+			ofstream output(outputFile, ios::out);
+			output << json.str();
+		}
+	}
+
+	void __stdcall PgoGenerateMapperTestRoms(string outputFolder)
+	{
+		//Boards with a cycle-based IRQ counter and/or expansion audio - the scripts write random values to their IRQ, audio & banking registers
+		vector<MapperTestRom> roms = {
+			{ "vrc4", 23, 0, { { 0xF000 }, { 0xF001 }, { 0xF002, { 0, 2, 3, 6, 7, 1, 5 } }, { 0xF003 }, { 0x8000 } }, { { 0xF003, 0 } }, {} },
+			{ "vrc6", 24, 0, { { 0xF000 }, { 0xF001, { 2, 3, 6, 7, 0 } }, { 0xF002 }, { 0x9000 }, { 0x9001 }, { 0x9002 }, { 0xA000 }, { 0xA002 }, { 0xB000 }, { 0xB001 }, { 0xB002 }, { 0x9003 } }, { { 0xF002, 0 } }, {} },
+			{ "vrc7", 85, 0, { { 0xE008 }, { 0xF000, { 2, 3, 6, 7, 0 } }, { 0xF008 }, { 0x9010, GetValueRange(0x40) }, { 0x9030 }, { 0xE000, { 0, 0x40 } } }, { { 0xF008, 0 } },
+				{ { 0x9010, 0x10 }, { 0x9030, 0x80 }, { 0x9010, 0x30 }, { 0x9030, 0x10 }, { 0x9010, 0x20 }, { 0x9030, 0x1C }, { 0x9010, 0x11 }, { 0x9030, 0x40 }, { 0x9010, 0x31 }, { 0x9030, 0x30 }, { 0x9010, 0x21 }, { 0x9030, 0x1A } } },
+			{ "fme7", 69, 0, { { 0x8000, { 0x0D, 0x0E, 0x0F } }, { 0xA000 }, { 0xA000, { 0x81, 0x80, 0x01, 0x00 } }, { 0xC000, GetValueRange(14) }, { 0xE000 } }, { { 0x8000, 0x0D }, { 0xA000, 0x81 } },
+				{ { 0xC000, 0 }, { 0xE000, 0x80 }, { 0xC000, 1 }, { 0xE000, 0 }, { 0xC000, 7 }, { 0xE000, 0x3C }, { 0xC000, 8 }, { 0xE000, 0x0F }, { 0xC000, 2 }, { 0xE000, 0x40 }, { 0xC000, 9 }, { 0xE000, 0x0C } } },
+			{ "bandai", 16, 0, { { 0x800A, { 0, 1 } }, { 0x800B }, { 0x800C, GetValueRange(4) }, { 0x8008 } }, { { 0x800A, 1 } }, {} },
+			{ "bandai4", 16, 4, { { 0x600A, { 0, 1 } }, { 0x600B }, { 0x600C, GetValueRange(4) }, { 0x6008 } }, { { 0x600A, 1 } }, {} },
+			{ "bandai5", 16, 5, { { 0x800A, { 0, 1 } }, { 0x800B }, { 0x800C, GetValueRange(4) }, { 0x8008 } }, { { 0x800A, 1 } }, {} },
+			{ "jaleco", 18, 0, { { 0xE000, GetValueRange(16) }, { 0xE001, GetValueRange(16) }, { 0xE002, GetValueRange(4) }, { 0xE003, { 0 } }, { 0xF000 }, { 0xF001, { 1, 3, 5, 9, 0 } }, { 0x8000 } }, { { 0xF000, 0 } }, {} },
+			{ "n163", 19, 0, { { 0x5000 }, { 0x5800, { 0x80, 0x81, 0xFF, 0x00 } }, { 0xF800, GetValueRange(0x80) }, { 0x4800 }, { 0xE000, { 0, 0x10, 0x30 } } }, { { 0x5800, 0x80 } }, {} },
+			{ "mmc5", 5, 0, { { 0x5000 }, { 0x5002 }, { 0x5003 }, { 0x5004 }, { 0x5006 }, { 0x5007 }, { 0x5010 }, { 0x5011 }, { 0x5015 }, { 0x5203 }, { 0x5204, { 0, 0x80 } } }, {}, { { 0x5100, 3 }, { 0x2001, 0x18 } } },
+			{ "w252", 252, 0, { { 0xF000 }, { 0xF004 }, { 0xF008, { 2, 3, 6, 7, 0 } }, { 0xF00C } }, { { 0xF00C, 0 } }, {} }
+		};
+
+		for(MapperTestRom &rom : roms) {
+			for(uint32_t seed = 0; seed < 10; seed++) {
+				vector<uint8_t> romData = BuildMapperTestRom(rom, seed);
+				ofstream romFile(FolderUtilities::CombinePath(outputFolder, rom.Name + "_" + std::to_string(seed) + ".nes"), ios::out | ios::binary);
+				romFile.write((char*)romData.data(), romData.size());
+			}
 		}
 	}
-}
\ No newline at end of file
+}
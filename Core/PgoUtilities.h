@@ -10,5 +10,11 @@ extern "C" {
 #define __stdcall
 #endif
 
-	DllExport2 void __stdcall PgoRunTest(vector<string> testRoms, bool enableDebugger);
+	//Runs each rom for a fixed number of frames with scripted input, once per benchmark mode (all modes when the list is empty)
+	//Modes: core, debugger, hdpack, runahead, headless, expaudio, mapperirq, clone, instances[:count], notifications, netsim[:latency[:packetloss]], filter:<name> (e.g filter:ntsc, filter:hq4x, filter:xbrz6x)
+	//Results are written as JSON to outputFile (or to the standard output when no file is given)
+	DllExport2 void __stdcall PgoRunBenchmark(vector<string> testRoms, vector<string> modes, uint32_t frameCount, string outputFile);
+
+	//Writes test roms for the boards with a cycle-based IRQ counter and/or expansion audio to outputFolder (10 roms per board, to be run in the mapperirq mode)
+	DllExport2 void __stdcall PgoGenerateMapperTestRoms(string outputFolder);
 }
@@ -6,6 +6,7 @@
 #include "SoundMixer.h"
 #include "BaseControlDevice.h"
 #include "HistoryViewer.h"
+#include "FrameProfiler.h"
 
 RewindManager::RewindManager(shared_ptr<Console> console)
 {
@@ -48,7 +49,7 @@ void RewindManager::ClearBuffer()
 
 void RewindManager::ProcessNotification(ConsoleNotificationType type, void * parameter)
 {
-	if(_settings->IsRunAheadFrame()) {
+	if(_settings->IsRunAheadFrame() || _settings->IsHeadlessMode()) {
 		return;
 	}
 
@@ -229,6 +230,8 @@ void RewindManager::Stop()
 
 void RewindManager::ProcessEndOfFrame()
 {
+	PROFILE_SCOPE(_console->GetFrameProfiler(), Rewind);
+
 	if(_rewindState >= RewindState::Starting) {
 		if(_currentHistory.FrameCount <= 0 && _rewindState != RewindState::Debugging) {
 			//If we're debugging, we want to keep running the emulation to the end of the next frame (even if it's incomplete)
@@ -300,7 +303,7 @@ bool RewindManager::ProcessAudio(int16_t * soundBuffer, uint32_t sampleCount, ui
 
 void RewindManager::RecordInput(vector<shared_ptr<BaseControlDevice>> devices)
 {
-	if(_settings->GetRewindBufferSize() > 0 && _rewindState == RewindState::Stopped) {
+	if(_settings->GetRewindBufferSize() > 0 && _rewindState == RewindState::Stopped && !_settings->IsHeadlessMode()) {
 		for(shared_ptr<BaseControlDevice> &device : devices) {
 			_currentHistory.InputLogs[device->GetPort()].push_back(device->GetRawState());
 		}
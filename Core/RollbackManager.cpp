@@ -0,0 +1,275 @@
+#include "stdafx.h"
+#include "RollbackManager.h"
+#include "Console.h"
+#include "APU.h"
+#include "EmulationSettings.h"
+
+RollbackManager::RollbackManager(shared_ptr<Console> console, uint32_t maxFrames)
+{
+	_console = console;
+	_maxFrames = std::max<uint32_t>(maxFrames, 1);
+	_frames.resize(_maxFrames + 1);
+	_enabled = false;
+	_resimulating = false;
+	Reset();
+}
+
+void RollbackManager::Reset()
+{
+	auto lock = _lock.AcquireSafe();
+	_currentFrame = 0;
+	_rollbackFrame = NoRollback;
+	_activePorts = 0;
+	for(int i = 0; i < BaseControlDevice::PortCount; i++) {
+		_confirmedInput[i].clear();
+		_confirmedStart[i] = 0;
+		_lastConfirmedInput[i] = ControlDeviceState();
+	}
+	for(RollbackFrame &frame : _frames) {
+		frame.FrameNumber = NoRollback;
+		frame.State.clear();
+		frame.RamPages = PageSnapshot();
+	}
+}
+
+void RollbackManager::Disable()
+{
+	//Called before Console::Pause() to make sure the emulation thread is not waiting for input (prevents deadlocks)
+	_enabled = false;
+	_waitForInput.Signal();
+}
+
+void RollbackManager::Enable()
+{
+	Reset();
+	_enabled = true;
+}
+
+void RollbackManager::SetLocalInput(uint8_t port, ControlDeviceState state)
+{
+	auto lock = _lock.AcquireSafe();
+	_localPort = port;
+	_localInput = state;
+}
+
+uint32_t RollbackManager::GetConfirmedFrameCount(uint8_t port)
+{
+	return _confirmedStart[port] + (uint32_t)_confirmedInput[port].size();
+}
+
+void RollbackManager::AddConfirmedInput(uint8_t port, ControlDeviceState state)
+{
+	if(port >= BaseControlDevice::PortCount) {
+		return;
+	}
+
+	{
+		auto lock = _lock.AcquireSafe();
+		uint32_t frameNumber = GetConfirmedFrameCount(port);
+		_confirmedInput[port].push_back(state);
+		_lastConfirmedInput[port] = state;
+
+		if(frameNumber < _currentFrame) {
+			//This frame was already emulated using a predicted input, check if the prediction was correct
+			RollbackFrame &frame = _frames[frameNumber % _frames.size()];
+			if(frame.FrameNumber == frameNumber && frame.Predicted[port]) {
+				frame.Predicted[port] = false;
+				if(frame.Input[port] != state) {
+					_rollbackFrame = std::min(_rollbackFrame, frameNumber);
+				}
+			}
+		}
+
+		//Input older than the oldest frame we can roll back to is no longer needed
+		uint32_t oldestFrame = _currentFrame > _maxFrames ? _currentFrame - _maxFrames : 0;
+		while(!_confirmedInput[port].empty() && _confirmedStart[port] < oldestFrame) {
+			_confirmedInput[port].pop_front();
+			_confirmedStart[port]++;
+		}
+	}
+
+	_waitForInput.Signal();
+}
+
+uint32_t RollbackManager::GetPendingInputCount()
+{
+	//Number of frames for which we have the server's input, but that have not been emulated yet
+	auto lock = _lock.AcquireSafe();
+	uint32_t pendingCount = UINT32_MAX;
+	for(int i = 0; i < BaseControlDevice::PortCount; i++) {
+		if(_activePorts & (1 << i)) {
+			uint32_t confirmedCount = GetConfirmedFrameCount(i);
+			pendingCount = std::min(pendingCount, confirmedCount > _currentFrame ? confirmedCount - _currentFrame : 0);
+		}
+	}
+	return pendingCount == UINT32_MAX ? 0 : pendingCount;
+}
+
+bool RollbackManager::IsWaitingForInput()
+{
+	//Stop predicting once the oldest unconfirmed frame is about to fall out of the snapshot buffer
+	for(int i = 0; i < BaseControlDevice::PortCount; i++) {
+		if((_activePorts & (1 << i)) && GetConfirmedFrameCount(i) + _maxFrames <= _currentFrame) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool RollbackManager::SetInput(BaseControlDevice* device)
+{
+	if(!_enabled) {
+		return false;
+	}
+
+	uint8_t port = device->GetPort();
+	if(port >= BaseControlDevice::PortCount) {
+		return false;
+	}
+
+	auto lock = _lock.AcquireSafe();
+	_activePorts |= (1 << port);
+
+	RollbackFrame &frame = _frames[_currentFrame % _frames.size()];
+	uint32_t confirmedCount = GetConfirmedFrameCount(port);
+	if(_currentFrame >= _confirmedStart[port] && _currentFrame < confirmedCount) {
+		frame.Input[port] = _confirmedInput[port][_currentFrame - _confirmedStart[port]];
+		frame.Predicted[port] = false;
+	} else if(port == _localPort && !_resimulating) {
+		//Assume the server will receive our own input in time
+		frame.Input[port] = _localInput;
+		frame.Predicted[port] = true;
+	} else if(port == _localPort) {
+		//Keep using the prediction that was made when the frame was first emulated
+		frame.Predicted[port] = true;
+	} else {
+		//Assume remote players are still pressing the same buttons
+		frame.Input[port] = _lastConfirmedInput[port];
+		frame.Predicted[port] = true;
+	}
+
+	device->SetRawState(frame.Input[port]);
+	return true;
+}
+
+void RollbackManager::SaveFrameState()
+{
+	stringstream state;
+	PageSnapshot ramPages;
+	_console->SaveState(state, ramPages);
+
+	auto lock = _lock.AcquireSafe();
+	RollbackFrame &frame = _frames[_currentFrame % _frames.size()];
+	frame.State = state.str();
+	frame.RamPages = std::move(ramPages);
+	frame.FrameNumber = _currentFrame;
+	for(int i = 0; i < BaseControlDevice::PortCount; i++) {
+		frame.Predicted[i] = false;
+	}
+}
+
+void RollbackManager::Rollback()
+{
+	uint32_t targetFrame;
+	uint32_t rollbackFrame;
+	{
+		auto lock = _lock.AcquireSafe();
+		rollbackFrame = _rollbackFrame;
+		targetFrame = _currentFrame;
+		_rollbackFrame = NoRollback;
+		if(rollbackFrame == NoRollback || rollbackFrame >= targetFrame || _frames[rollbackFrame % _frames.size()].FrameNumber != rollbackFrame) {
+			return;
+		}
+	}
+
+	Timer timer;
+	stringstream state(_frames[rollbackFrame % _frames.size()].State);
+
+	EmulationSettings* settings = _console->GetSettings();
+	settings->SetRunAheadFrameFlag(true);
+	_console->LoadState(state, _frames[rollbackFrame % _frames.size()].RamPages);
+
+	_resimulating = true;
+	SetCurrentFrame(rollbackFrame);
+	for(uint32_t frameNumber = rollbackFrame; frameNumber < targetFrame; frameNumber++) {
+		if(frameNumber != rollbackFrame) {
+			SaveFrameState();
+		} else {
+			//The state for this frame is still valid, only reset the prediction flags
+			auto lock = _lock.AcquireSafe();
+			RollbackFrame &frame = _frames[frameNumber % _frames.size()];
+			for(int i = 0; i < BaseControlDevice::PortCount; i++) {
+				frame.Predicted[i] = false;
+			}
+		}
+		_console->RunFrame();
+		_console->ProcessStateChecksums();
+		SetCurrentFrame(frameNumber + 1);
+	}
+	_resimulating = false;
+
+	_console->GetApu()->EndFrame();
+	settings->SetRunAheadFrameFlag(false);
+
+	UpdateStatistics(targetFrame - rollbackFrame, timer.GetElapsedMS());
+}
+
+void RollbackManager::SetCurrentFrame(uint32_t frameNumber)
+{
+	auto lock = _lock.AcquireSafe();
+	_currentFrame = frameNumber;
+}
+
+void RollbackManager::RunFrame()
+{
+	Rollback();
+
+	while(_enabled) {
+		{
+			auto lock = _lock.AcquireSafe();
+			if(!IsWaitingForInput()) {
+				break;
+			}
+		}
+
+		//Too far ahead of the server, wait for its input before predicting more frames
+		_waitForInput.Wait(50);
+		Rollback();
+	}
+
+	SaveFrameState();
+	_console->RunFrame();
+	_console->ProcessStateChecksums();
+
+	auto lock = _lock.AcquireSafe();
+	_currentFrame++;
+}
+
+void RollbackManager::UpdateStatistics(uint32_t depth, double duration)
+{
+	auto lock = _lock.AcquireSafe();
+	_stats.RollbackCount++;
+	_stats.ResimulatedFrames += depth;
+	_stats.ResimulationTime += duration;
+	_stats.MaxRollbackDepth = std::max(_stats.MaxRollbackDepth, depth);
+
+	_secondRollbackCount++;
+	_secondResimulatedFrames += depth;
+	_secondResimulationTime += duration;
+}
+
+RollbackStatistics RollbackManager::GetStatistics()
+{
+	auto lock = _lock.AcquireSafe();
+	double elapsed = _statsTimer.GetElapsedMS();
+	if(elapsed >= 1000) {
+		_stats.RollbacksPerSecond = _secondRollbackCount * 1000 / elapsed;
+		_stats.ResimulatedFramesPerSecond = _secondResimulatedFrames * 1000 / elapsed;
+		_stats.AverageResimulationTime = _secondRollbackCount > 0 ? _secondResimulationTime / _secondRollbackCount : 0;
+		_secondRollbackCount = 0;
+		_secondResimulatedFrames = 0;
+		_secondResimulationTime = 0;
+		_statsTimer.Reset();
+	}
+	return _stats;
+}
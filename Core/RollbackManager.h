@@ -0,0 +1,94 @@
+#pragma once
+#include "stdafx.h"
+#include <deque>
+#include "../Utilities/SimpleLock.h"
+#include "../Utilities/AutoResetEvent.h"
+#include "../Utilities/Timer.h"
+#include "BaseControlDevice.h"
+#include "ControlDeviceState.h"
+#include "PageSnapshotManager.h"
+
+class Console;
+
+struct RollbackStatistics
+{
+	uint32_t RollbackCount;
+	uint32_t ResimulatedFrames;
+	uint32_t MaxRollbackDepth;
+	double ResimulationTime;
+
+	//Values for the last full second of emulation
+	double RollbacksPerSecond;
+	double ResimulatedFramesPerSecond;
+	double AverageResimulationTime;
+};
+
+struct RollbackFrame
+{
+	uint32_t FrameNumber;
+	string State;
+	PageSnapshot RamPages;
+	ControlDeviceState Input[BaseControlDevice::PortCount];
+	bool Predicted[BaseControlDevice::PortCount];
+};
+
+//Rollback netplay (client-side):
+//Instead of waiting for the server's input for every frame, the remote players' input is predicted (the last known input is repeated)
+//and a save state is kept for each of the last [rollbackFrames] frames. When the server's input for a frame does not
+//match the prediction, the state for that frame is reloaded and all the frames since then are emulated again (without audio/video)
+class RollbackManager
+{
+private:
+	static constexpr uint32_t NoRollback = UINT32_MAX;
+
+	shared_ptr<Console> _console;
+	SimpleLock _lock;
+	AutoResetEvent _waitForInput;
+	atomic<bool> _enabled;
+
+	uint32_t _maxFrames;
+	vector<RollbackFrame> _frames;
+
+	//Number of the next frame to run, relative to the last state loaded from the server
+	uint32_t _currentFrame = 0;
+	uint32_t _rollbackFrame = NoRollback;
+	atomic<bool> _resimulating;
+
+	//Input received from the server, _confirmedInput[port].front() is the input for frame _confirmedStart[port]
+	std::deque<ControlDeviceState> _confirmedInput[BaseControlDevice::PortCount];
+	uint32_t _confirmedStart[BaseControlDevice::PortCount] = {};
+	ControlDeviceState _lastConfirmedInput[BaseControlDevice::PortCount];
+	uint8_t _activePorts = 0;
+
+	uint8_t _localPort = BaseControlDevice::PortCount;
+	ControlDeviceState _localInput;
+
+	RollbackStatistics _stats = {};
+	Timer _statsTimer;
+	uint32_t _secondRollbackCount = 0;
+	uint32_t _secondResimulatedFrames = 0;
+	double _secondResimulationTime = 0;
+
+	uint32_t GetConfirmedFrameCount(uint8_t port);
+	bool IsWaitingForInput();
+	void Rollback();
+	void SaveFrameState();
+	void SetCurrentFrame(uint32_t frameNumber);
+	void UpdateStatistics(uint32_t depth, double duration);
+
+public:
+	RollbackManager(shared_ptr<Console> console, uint32_t maxFrames);
+
+	void Reset();
+	void Disable();
+	void Enable();
+
+	void SetLocalInput(uint8_t port, ControlDeviceState state);
+	void AddConfirmedInput(uint8_t port, ControlDeviceState state);
+	uint32_t GetPendingInputCount();
+
+	bool SetInput(BaseControlDevice* device);
+	void RunFrame();
+
+	RollbackStatistics GetStatistics();
+};
@@ -106,6 +106,8 @@ struct StudyBoxData
 	vector<PageInfo> Pages;
 };
 
+struct RomImage;
+
 struct RomData
 {
 	RomInfo Info;
@@ -117,6 +119,11 @@ struct RomData
 	
 	vector<uint8_t> PrgRom;
 	vector<uint8_t> ChrRom;
+
+	//Set when the mapper is initialized, the PRG/CHR ROM data is then moved to these (shared) images - see RomImageCache::ShareRomData
+	shared_ptr<const RomImage> PrgRomImage;
+	shared_ptr<const RomImage> ChrRomImage;
+
 	vector<uint8_t> TrainerData;
 	vector<vector<uint8_t>> FdsDiskData;
 	vector<vector<uint8_t>> FdsDiskHeaders;
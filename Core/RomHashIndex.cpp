@@ -0,0 +1,279 @@
+#include "stdafx.h"
+#include <thread>
+#include <unordered_set>
+#include "../Utilities/FolderUtilities.h"
+#include "../Utilities/StringUtilities.h"
+#include "../Utilities/HexUtilities.h"
+#include "../Utilities/ArchiveReader.h"
+#include "../Utilities/HashUtilities.h"
+#include "RomHashIndex.h"
+#include "VirtualFile.h"
+#include "MessageManager.h"
+#include "Types.h"
+
+SimpleLock RomHashIndex::_lock;
+bool RomHashIndex::_loaded = false;
+std::unordered_map<string, IndexedFile> RomHashIndex::_files;
+std::unordered_map<uint32_t, string> RomHashIndex::_crcIndex;
+std::unordered_map<string, string> RomHashIndex::_sha1Index;
+
+string RomHashIndex::GetIndexPath()
+{
+	return FolderUtilities::CombinePath(FolderUtilities::GetHomeFolder(), "RomHashIndex.txt");
+}
+
+void RomHashIndex::LoadIndex()
+{
+	if(_loaded) {
+		return;
+	}
+	_loaded = true;
+
+	ifstream index(GetIndexPath(), ios::in | ios::binary);
+	string lineContent;
+	if(!std::getline(index, lineContent) || lineContent != IndexHeader) {
+		//Missing or outdated index, everything will be read again
+		return;
+	}
+
+	//Each line is: path, modification time, size, [file name in archive, crc32, sha1]
+	try {
+		while(std::getline(index, lineContent)) {
+			vector<string> values = StringUtilities::Split(lineContent, '\t');
+			if(values.size() < 3) {
+				continue;
+			}
+
+			IndexedFile &file = _files[UnescapeField(values[0])];
+			file.ModifiedTime = std::stoll(values[1]);
+			file.Size = std::stoull(values[2]);
+			if(values.size() >= 6) {
+				IndexedRom rom;
+				rom.InnerFile = UnescapeField(values[3]);
+				rom.Crc32 = (uint32_t)std::stoul(values[4], nullptr, 16);
+				rom.Sha1 = values[5];
+				file.Roms.push_back(rom);
+			}
+		}
+	} catch(std::exception&) {
+		//Corrupted index, rebuild it
+		_files.clear();
+	}
+
+	BuildLookupTables();
+}
+
+void RomHashIndex::SaveIndex()
+{
+	ofstream index(GetIndexPath(), ios::out | ios::binary);
+	if(!index) {
+		return;
+	}
+
+	index << IndexHeader << "\n";
+	for(auto &kvp : _files) {
+		string fileInfo = EscapeField(kvp.first) + "\t" + std::to_string(kvp.second.ModifiedTime) + "\t" + std::to_string(kvp.second.Size);
+		if(kvp.second.Roms.empty()) {
+			//Keep files that contain no roms (e.g archives) in the index, to avoid reading them again
+			index << fileInfo << "\n";
+		}
+		for(IndexedRom &rom : kvp.second.Roms) {
+			index << fileInfo << "\t" << EscapeField(rom.InnerFile) << "\t" << HexUtilities::ToHex(rom.Crc32, true) << "\t" << rom.Sha1 << "\n";
+		}
+	}
+}
+
+string RomHashIndex::EscapeField(const string &value)
+{
+	string result;
+	result.reserve(value.size());
+	for(char c : value) {
+		switch(c) {
+			case '\\': result += "\\\\"; break;
+			case '\t': result += "\\t"; break;
+			case '\n': result += "\\n"; break;
+			case '\r': result += "\\r"; break;
+			default: result += c; break;
+		}
+	}
+	return result;
+}
+
+string RomHashIndex::UnescapeField(const string &value)
+{
+	string result;
+	result.reserve(value.size());
+	for(size_t i = 0; i < value.size(); i++) {
+		if(value[i] == '\\' && i + 1 < value.size()) {
+			i++;
+			switch(value[i]) {
+				case 't': result += '\t'; break;
+				case 'n': result += '\n'; break;
+				case 'r': result += '\r'; break;
+				default: result += value[i]; break;
+			}
+		} else {
+			result += value[i];
+		}
+	}
+	return result;
+}
+
+void RomHashIndex::BuildLookupTables()
+{
+	_crcIndex.clear();
+	_sha1Index.clear();
+	for(auto &kvp : _files) {
+		for(IndexedRom &rom : kvp.second.Roms) {
+			string romPath = rom.InnerFile.empty() ? kvp.first : (string)VirtualFile(kvp.first, rom.InnerFile);
+			_crcIndex[rom.Crc32] = romPath;
+			_sha1Index[rom.Sha1] = romPath;
+		}
+	}
+}
+
+void RomHashIndex::AddRom(IndexedFile &file, string innerFile, uint8_t* fileData, size_t fileSize)
+{
+	//Must produce the same hashes as RomLoader::LoadFile
+	IndexedRom rom;
+	rom.InnerFile = innerFile;
+	if(fileSize >= 4 && memcmp(fileData, "STBX", 4) == 0) {
+		//StudyBox files use their CRC32 instead of a SHA1 hash (see StudyBoxLoader)
+		rom.Crc32 = HashUtilities::GetHashes(fileData, fileSize, HashType::Crc32Hash).Crc32;
+		string crc32String = HexUtilities::ToHex(rom.Crc32);
+		rom.Sha1 = crc32String + crc32String + crc32String + crc32String + crc32String;
+	} else {
+		HashValues hashes = HashUtilities::GetHashes(fileData, fileSize, HashType::Crc32Hash | HashType::Sha1Hash);
+		rom.Crc32 = hashes.Crc32;
+		rom.Sha1 = hashes.Sha1;
+	}
+	file.Roms.push_back(rom);
+}
+
+bool RomHashIndex::IndexFile(string filepath, IndexedFile &file)
+{
+	if(!FolderUtilities::GetFileInfo(filepath, file.ModifiedTime, file.Size)) {
+		return false;
+	}
+
+	file.Roms.clear();
+	shared_ptr<ArchiveReader> reader = ArchiveReader::GetReader(filepath);
+	if(reader) {
+		for(string innerFile : reader->GetFileList(VirtualFile::RomExtensions)) {
+			vector<uint8_t> fileData;
+			if(reader->ExtractFile(innerFile, fileData) && fileData.size() >= 15) {
+				AddRom(file, innerFile, fileData.data(), fileData.size());
+			}
+		}
+	} else {
+		VirtualFile romFile = filepath;
+		if(romFile.GetSize() >= 15) {
+			AddRom(file, "", romFile.GetData(), romFile.GetSize());
+		}
+	}
+	return true;
+}
+
+bool RomHashIndex::IsFileUnchanged(string filepath)
+{
+	auto result = _files.find(filepath);
+	int64_t modifiedTime;
+	uint64_t size;
+	return (
+		result != _files.end() &&
+		FolderUtilities::GetFileInfo(filepath, modifiedTime, size) &&
+		result->second.ModifiedTime == modifiedTime &&
+		result->second.Size == size
+	);
+}
+
+string RomHashIndex::FindMatchingRom(HashInfo &hashInfo)
+{
+	auto lock = _lock.AcquireSafe();
+	LoadIndex();
+
+	string match;
+	if(!hashInfo.Sha1.empty()) {
+		auto result = _sha1Index.find(hashInfo.Sha1);
+		if(result != _sha1Index.end()) {
+			match = result->second;
+		}
+	}
+	if(match.empty() && hashInfo.Crc32 != 0) {
+		auto result = _crcIndex.find(hashInfo.Crc32);
+		if(result != _crcIndex.end()) {
+			match = result->second;
+		}
+	}
+
+	if(!match.empty() && !IsFileUnchanged(VirtualFile(match).GetFilePath())) {
+		//File was modified or deleted since it was indexed
+		return "";
+	}
+	return match;
+}
+
+void RomHashIndex::Update(vector<string> &romFiles)
+{
+	auto lock = _lock.AcquireSafe();
+	LoadIndex();
+
+	std::unordered_set<string> currentFiles(romFiles.begin(), romFiles.end());
+	size_t removedCount = 0;
+	for(auto it = _files.begin(); it != _files.end();) {
+		int64_t modifiedTime;
+		uint64_t size;
+		if(currentFiles.find(it->first) == currentFiles.end() && !FolderUtilities::GetFileInfo(it->first, modifiedTime, size)) {
+			//The file was deleted (files that are only missing from the list, e.g because their folder is not scanned anymore, are kept)
+			it = _files.erase(it);
+			removedCount++;
+		} else {
+			it++;
+		}
+	}
+
+	vector<string> pendingFiles;
+	for(const string &filepath : currentFiles) {
+		if(!IsFileUnchanged(filepath)) {
+			pendingFiles.push_back(filepath);
+		}
+	}
+
+	if(pendingFiles.empty() && removedCount == 0) {
+		return;
+	}
+
+	//Each thread reads & hashes the next file in the list, the results are merged once all threads are done
+	vector<IndexedFile> results(pendingFiles.size());
+	vector<uint8_t> resultValid(pendingFiles.size());
+	atomic<size_t> nextFile(0);
+	auto indexFiles = [&]() {
+		size_t i;
+		while((i = nextFile++) < pendingFiles.size()) {
+			resultValid[i] = IndexFile(pendingFiles[i], results[i]);
+		}
+	};
+
+	size_t threadCount = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), pendingFiles.size()));
+	vector<std::thread> threads;
+	for(size_t i = 1; i < threadCount; i++) {
+		threads.push_back(std::thread(indexFiles));
+	}
+	indexFiles();
+	for(std::thread &thread : threads) {
+		thread.join();
+	}
+
+	for(size_t i = 0; i < pendingFiles.size(); i++) {
+		if(resultValid[i]) {
+			_files[pendingFiles[i]] = std::move(results[i]);
+		} else {
+			_files.erase(pendingFiles[i]);
+		}
+	}
+
+	BuildLookupTables();
+	SaveIndex();
+
+	MessageManager::Log("[RomHashIndex] Indexed " + std::to_string(pendingFiles.size()) + " file(s), removed " + std::to_string(removedCount) + " file(s)");
+}
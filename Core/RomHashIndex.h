@@ -0,0 +1,56 @@
+#pragma once
+#include "stdafx.h"
+#include <unordered_map>
+#include "../Utilities/SimpleLock.h"
+
+struct HashInfo;
+
+struct IndexedRom
+{
+	string InnerFile;
+	uint32_t Crc32 = 0;
+	string Sha1;
+};
+
+struct IndexedFile
+{
+	int64_t ModifiedTime = 0;
+	uint64_t Size = 0;
+	vector<IndexedRom> Roms;
+};
+
+//Persistent index of the CRC32/SHA1 hashes of the roms found in the known game folders (saved in RomHashIndex.txt)
+//Used to find the rom matching a movie/save state/netplay game without loading every file in the folders each time
+//Files are only read again when their size or modification time changes
+class RomHashIndex
+{
+private:
+	static constexpr const char* IndexHeader = "#MesenRomHashIndex v2";
+
+	static SimpleLock _lock;
+	static bool _loaded;
+	static std::unordered_map<string, IndexedFile> _files;
+	static std::unordered_map<uint32_t, string> _crcIndex;
+	static std::unordered_map<string, string> _sha1Index;
+
+	static string GetIndexPath();
+	static void LoadIndex();
+	static void SaveIndex();
+	static void BuildLookupTables();
+
+	//Tabs, line breaks and backslashes in paths are escaped, since they are used as separators in the index file
+	static string EscapeField(const string &value);
+	static string UnescapeField(const string &value);
+
+	static void AddRom(IndexedFile &file, string innerFile, uint8_t* fileData, size_t fileSize);
+	static bool IndexFile(string filepath, IndexedFile &file);
+	static bool IsFileUnchanged(string filepath);
+
+public:
+	//Returns the rom matching the hash from the index (without scanning the folders), or an empty string
+	static string FindMatchingRom(HashInfo &hashInfo);
+
+	//Reads the files that are not in the index yet (or have changed since they were indexed) using all cores, and removes files that no longer exist
+	//Indexed files that are not in the list (e.g a game folder that is no longer known) are kept as long as they exist
+	static void Update(vector<string> &romFiles);
+};
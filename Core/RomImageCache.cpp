@@ -0,0 +1,69 @@
+#include "stdafx.h"
+#include "RomImageCache.h"
+#include "RomData.h"
+#include "../Utilities/CRC32.h"
+
+SimpleLock RomImageCache::_lock;
+std::unordered_multimap<uint32_t, weak_ptr<const RomImage>> RomImageCache::_images;
+
+shared_ptr<const RomImage> RomImageCache::GetImage(vector<uint8_t> &data)
+{
+	if(data.empty()) {
+		return nullptr;
+	}
+
+	uint32_t crc = CRC32::GetCRC(data.data(), data.size());
+
+	auto lock = _lock.AcquireSafe();
+	auto range = _images.equal_range(crc);
+	for(auto it = range.first; it != range.second;) {
+		shared_ptr<const RomImage> image = it->second.lock();
+		if(!image) {
+			it = _images.erase(it);
+		} else if(image->Data == data) {
+			return image;
+		} else {
+			it++;
+		}
+	}
+
+	shared_ptr<RomImage> image = std::make_shared<RomImage>();
+	image->Data = std::move(data);
+	image->Crc32 = crc;
+	_images.emplace(crc, image);
+	return image;
+}
+
+void RomImageCache::ShareRomData(RomData &romData)
+{
+	if(!romData.PrgRomImage) {
+		romData.PrgRomImage = GetImage(romData.PrgRom);
+	}
+	if(!romData.ChrRomImage) {
+		romData.ChrRomImage = GetImage(romData.ChrRom);
+	}
+
+	vector<uint8_t>().swap(romData.PrgRom);
+	vector<uint8_t>().swap(romData.ChrRom);
+}
+
+RomImageCacheStatistics RomImageCache::GetStatistics()
+{
+	RomImageCacheStatistics stats = {};
+
+	auto lock = _lock.AcquireSafe();
+	for(auto it = _images.begin(); it != _images.end();) {
+		shared_ptr<const RomImage> image = it->second.lock();
+		if(!image) {
+			it = _images.erase(it);
+		} else {
+			stats.ImageCount++;
+			stats.ImageBytes += image->Data.size();
+
+			//Don't count the reference held by this function
+			stats.ReferenceCount += (uint32_t)image.use_count() - 1;
+			it++;
+		}
+	}
+	return stats;
+}
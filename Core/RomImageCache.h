@@ -0,0 +1,40 @@
+#pragma once
+#include "stdafx.h"
+#include <unordered_map>
+#include "../Utilities/SimpleLock.h"
+
+struct RomData;
+
+//Read-only copy of a game's PRG or CHR ROM
+//Every console that loads the same game maps the same image, instead of keeping its own copy of the ROM
+struct RomImage
+{
+	vector<uint8_t> Data;
+	uint32_t Crc32 = 0;
+};
+
+struct RomImageCacheStatistics
+{
+	uint32_t ImageCount;
+	uint64_t ImageBytes;
+
+	//Number of mappers (consoles) currently using the images
+	uint32_t ReferenceCount;
+};
+
+//Keeps track of the ROM images used by the consoles that are currently loaded (images are released along with the last console using them)
+class RomImageCache
+{
+private:
+	static SimpleLock _lock;
+	static std::unordered_multimap<uint32_t, weak_ptr<const RomImage>> _images;
+
+	//Returns the image matching the data, or a new image (that takes the data) if no console is using this data - nullptr for empty data
+	static shared_ptr<const RomImage> GetImage(vector<uint8_t> &data);
+
+public:
+	//Moves the rom's PRG/CHR ROM data to the matching shared images (does nothing if the rom already uses shared images)
+	static void ShareRomData(RomData &romData);
+
+	static RomImageCacheStatistics GetStatistics();
+};
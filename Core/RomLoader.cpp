@@ -2,8 +2,7 @@
 #include <algorithm>
 #include <unordered_set>
 #include "../Utilities/FolderUtilities.h"
-#include "../Utilities/CRC32.h"
-#include "../Utilities/sha1.h"
+#include "../Utilities/HashUtilities.h"
 #include "../Utilities/ArchiveReader.h"
 #include "VirtualFile.h"
 #include "RomLoader.h"
@@ -20,17 +19,20 @@ bool RomLoader::LoadFile(VirtualFile &romFile)
 		return false;
 	}
 
-	vector<uint8_t>& fileData = _romData.RawData;
-	romFile.ReadFile(fileData);
-	if(fileData.size() < 15) {
+	//Parse the file in place (mapped in memory), without copying it
+	uint8_t* fileData = romFile.GetData();
+	size_t fileSize = romFile.GetSize();
+	if(fileSize < 15) {
 		return false;
 	}
 
 	_filename = romFile.GetFileName();
 	string romName = FolderUtilities::GetFilename(_filename, true);
 
-	bool skipSha1Hash = false;
-	uint32_t crc = CRC32::GetCRC(fileData.data(), fileData.size());
+	//StudyBox files are large and do not use a SHA1 hash (StudyBoxLoader builds one from the CRC32)
+	bool skipSha1Hash = memcmp(fileData, "STBX", 4) == 0;
+	HashValues hashes = HashUtilities::GetHashes(fileData, fileSize, skipSha1Hash ? HashType::Crc32Hash : (HashType::Crc32Hash | HashType::Sha1Hash));
+	uint32_t crc = hashes.Crc32;
 	_romData.Info.Hash.Crc32 = crc;
 
 	Log("");
@@ -39,31 +41,32 @@ bool RomLoader::LoadFile(VirtualFile &romFile)
 	crcHex << std::hex << std::uppercase << std::setfill('0') << std::setw(8) << crc;
 	Log("File CRC32: 0x" + crcHex.str());
 
-	if(memcmp(fileData.data(), "NES\x1a", 4) == 0) {
+	if(memcmp(fileData, "NES\x1a", 4) == 0) {
 		iNesLoader loader(_checkOnly);
-		loader.LoadRom(_romData, fileData, nullptr);
-	} else if(memcmp(fileData.data(), "FDS\x1a", 4) == 0 || memcmp(fileData.data(), "\x1*NINTENDO-HVC*", 15) == 0) {
+		loader.LoadRom(_romData, fileData, fileSize, nullptr);
+	} else if(memcmp(fileData, "FDS\x1a", 4) == 0 || memcmp(fileData, "\x1*NINTENDO-HVC*", 15) == 0) {
+		//The FDS mapper keeps a copy of the original file (used to create the IPS patches that store the disk changes)
+		_romData.RawData.assign(fileData, fileData + fileSize);
 		FdsLoader loader(_checkOnly);
-		loader.LoadRom(_romData, fileData);
-	} else if(memcmp(fileData.data(), "NESM\x1a", 5) == 0) {
+		loader.LoadRom(_romData, _romData.RawData);
+	} else if(memcmp(fileData, "NESM\x1a", 5) == 0) {
 		NsfLoader loader(_checkOnly);
-		loader.LoadRom(_romData, fileData);
-	} else if(memcmp(fileData.data(), "NSFE", 4) == 0) {
+		loader.LoadRom(_romData, fileData, fileSize);
+	} else if(memcmp(fileData, "NSFE", 4) == 0) {
 		NsfeLoader loader(_checkOnly);
-		loader.LoadRom(_romData, fileData);
-	} else if(memcmp(fileData.data(), "UNIF", 4) == 0) {
+		loader.LoadRom(_romData, fileData, fileSize);
+	} else if(memcmp(fileData, "UNIF", 4) == 0) {
 		UnifLoader loader(_checkOnly);
-		loader.LoadRom(_romData, fileData);
-	} else if(memcmp(fileData.data(), "STBX", 4) == 0) {
+		loader.LoadRom(_romData, fileData, fileSize);
+	} else if(memcmp(fileData, "STBX", 4) == 0) {
 		StudyBoxLoader loader(_checkOnly);
-		loader.LoadRom(_romData, fileData, romFile.GetFilePath());
-		skipSha1Hash = true;
+		loader.LoadRom(_romData, fileData, fileSize, romFile.GetFilePath());
 	} else {
 		NESHeader header = {};
 		if(GameDatabase::GetiNesHeader(crc, header)) {
 			Log("[DB] Headerless ROM file found - using game database data.");
 			iNesLoader loader;
-			loader.LoadRom(_romData, fileData, &header);
+			loader.LoadRom(_romData, fileData, fileSize, &header);
 			_romData.Info.IsHeaderlessRom = true;
 		} else {
 			Log("Invalid rom file.");
@@ -72,7 +75,7 @@ bool RomLoader::LoadFile(VirtualFile &romFile)
 	}
 
 	if(!skipSha1Hash) {
-		_romData.Info.Hash.Sha1 = SHA1::GetHash(fileData);
+		_romData.Info.Hash.Sha1 = hashes.Sha1;
 	}
 
 	_romData.Info.RomName = romName;
@@ -96,7 +99,7 @@ bool RomLoader::LoadFile(VirtualFile &romFile)
 	return !_romData.Error;
 }
 
-RomData RomLoader::GetRomData()
+RomData& RomLoader::GetRomData()
 {
 	return _romData;
 }
@@ -133,37 +136,21 @@ string RomLoader::FindMatchingRomInFile(string filePath, HashInfo hashInfo, int
 	return "";
 }
 
-string RomLoader::FindMatchingRom(vector<string> romFiles, string romFilename, HashInfo hashInfo, bool useFastSearch)
+string RomLoader::FindMatchingRom(vector<string> &romFiles, string romFilename, HashInfo hashInfo)
 {
+	//Quick search by filename (searching by hash is done by RomHashIndex)
 	int iterationCount = 0;
-	if(useFastSearch) {
-		string lcRomFile = romFilename;
-		std::transform(lcRomFile.begin(), lcRomFile.end(), lcRomFile.begin(), ::tolower);
-
-		for(string currentFile : romFiles) {
-			//Quick search by filename
-			string lcCurrentFile = currentFile;
-			std::transform(lcCurrentFile.begin(), lcCurrentFile.end(), lcCurrentFile.begin(), ::tolower);
-			if(lcCurrentFile.find(lcRomFile) != string::npos && FolderUtilities::GetFilename(lcRomFile, true) == FolderUtilities::GetFilename(lcCurrentFile, true)) {
-				string match = RomLoader::FindMatchingRomInFile(currentFile, hashInfo, iterationCount);
-				if(!match.empty()) {
-					return match;
-				}
-			}
-		}
-	} else {
-		for(string romFile : romFiles) {
-			//Slower search by CRC value
-			string match = RomLoader::FindMatchingRomInFile(romFile, hashInfo, iterationCount);
+	string lcRomFile = romFilename;
+	std::transform(lcRomFile.begin(), lcRomFile.end(), lcRomFile.begin(), ::tolower);
+
+	for(string currentFile : romFiles) {
+		string lcCurrentFile = currentFile;
+		std::transform(lcCurrentFile.begin(), lcCurrentFile.end(), lcCurrentFile.begin(), ::tolower);
+		if(lcCurrentFile.find(lcRomFile) != string::npos && FolderUtilities::GetFilename(lcRomFile, true) == FolderUtilities::GetFilename(lcCurrentFile, true)) {
+			string match = RomLoader::FindMatchingRomInFile(currentFile, hashInfo, iterationCount);
 			if(!match.empty()) {
 				return match;
 			}
-			iterationCount++;
-
-			if(iterationCount > RomLoader::MaxFilesToCheck) {
-				MessageManager::Log("[RomLoader] Could not find a file matching the specified name/hash after 100 tries, giving up...");
-				break;
-			}
 		}
 	}
 
@@ -20,6 +20,6 @@ public:
 	
 	bool LoadFile(VirtualFile &romFile);
 
-	RomData GetRomData();
-	static string FindMatchingRom(vector<string> romFiles, string romFilename, HashInfo hashInfo, bool useFastSearch);
+	RomData& GetRomData();
+	static string FindMatchingRom(vector<string> &romFiles, string romFilename, HashInfo hashInfo);
 };
@@ -0,0 +1,29 @@
+#pragma once
+#include "stdafx.h"
+#include "NetMessage.h"
+
+class SaveStateAckMessage : public NetMessage
+{
+private:
+	//ID of the state that was loaded, 0 if the client could not load the state (the server will then send a full state)
+	uint32_t _stateId;
+
+protected:
+	virtual void ProtectedStreamState()
+	{
+		Stream<uint32_t>(_stateId);
+	}
+
+public:
+	SaveStateAckMessage(void* buffer, uint32_t length) : NetMessage(buffer, length) { }
+
+	SaveStateAckMessage(uint32_t stateId) : NetMessage(MessageType::SaveStateAck)
+	{
+		_stateId = stateId;
+	}
+
+	uint32_t GetStateId()
+	{
+		return _stateId;
+	}
+};
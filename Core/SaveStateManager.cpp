@@ -14,11 +14,24 @@
 #include "RomData.h"
 #include "DefaultVideoFilter.h"
 #include "PPU.h"
+#include "NotificationManager.h"
 
 SaveStateManager::SaveStateManager(shared_ptr<Console> console)
 {
 	_console = console;
 	_lastIndex = 1;
+	_stopSaveThread = false;
+	_pendingSaveCount = 0;
+}
+
+SaveStateManager::~SaveStateManager()
+{
+	if(_saveThread.joinable()) {
+		//The thread writes the remaining states before stopping
+		_stopSaveThread = true;
+		_saveSignal.Signal();
+		_saveThread.join();
+	}
 }
 
 string SaveStateManager::GetStateFilepath(int stateIndex)
@@ -56,7 +69,7 @@ bool SaveStateManager::LoadState()
 	return LoadState(_lastIndex);
 }
 
-void SaveStateManager::GetSaveStateHeader(ostream &stream)
+void SaveStateManager::WriteStateInfo(ostream &stream)
 {
 	uint32_t emuVersion = EmulationSettings::GetMesenVersion();
 	uint32_t formatVersion = SaveStateManager::FileFormatVersion;
@@ -70,17 +83,27 @@ void SaveStateManager::GetSaveStateHeader(ostream &stream)
 
 	string sha1Hash = romInfo.Hash.Sha1;
 	stream.write(sha1Hash.c_str(), sha1Hash.size());
+}
 
-	#ifndef LIBRETRO
-	SaveScreenshotData(stream);
-	#endif
-
-	string romName = romInfo.RomName;
+void SaveStateManager::WriteRomName(ostream &stream)
+{
+	string romName = _console->GetRomInfo().RomName;
 	uint32_t nameLength = (uint32_t)romName.size();
 	stream.write((char*)&nameLength, sizeof(uint32_t));
 	stream.write(romName.c_str(), romName.size());
 }
 
+void SaveStateManager::GetSaveStateHeader(ostream &stream)
+{
+	WriteStateInfo(stream);
+
+	#ifndef LIBRETRO
+	SaveScreenshotData(stream, _console->GetPpu()->GetScreenBuffer(true));
+	#endif
+
+	WriteRomName(stream);
+}
+
 void SaveStateManager::SaveState(ostream &stream)
 {
 	GetSaveStateHeader(stream);
@@ -89,39 +112,127 @@ void SaveStateManager::SaveState(ostream &stream)
 
 bool SaveStateManager::SaveState(string filepath)
 {
-	ofstream file(filepath, ios::out | ios::binary);
+	//Written on the caller's thread, so the result tells whether the file could actually be written
+	PendingSaveState state;
+	state.Filepath = filepath;
+	CopySaveState(state);
+	return WriteSaveState(state);
+}
+
+void SaveStateManager::SaveState(int stateIndex, bool displayMessage)
+{
+	QueueSaveState(SaveStateManager::GetStateFilepath(stateIndex), stateIndex, displayMessage);
+}
+
+void SaveStateManager::CopySaveState(PendingSaveState &state)
+{
+	//Only copy the state while the emulation is paused, the screenshot is compressed when the file is written
+	stringstream stateInfo;
+	stringstream stateData;
+	_console->Pause();
+	WriteStateInfo(stateInfo);
+	#ifndef LIBRETRO
+	uint8_t* screenBuffer = (uint8_t*)_console->GetPpu()->GetScreenBuffer(true);
+	state.ScreenBuffer.assign(screenBuffer, screenBuffer + PPU::PixelCount * 2);
+	#endif
+	WriteRomName(stateData);
+	_console->SaveState(stateData);
+
+	shared_ptr<Debugger> debugger = _console->GetDebugger(false);
+	if(debugger) {
+		debugger->ProcessEvent(EventType::StateSaved);
+	}
+	_console->Resume();
+
+	state.StateInfo = stateInfo.str();
+	state.StateData = stateData.str();
+}
+
+void SaveStateManager::QueueSaveState(string filepath, int stateIndex, bool displayMessage)
+{
+	PendingSaveState state;
+	state.Filepath = filepath;
+	state.StateIndex = stateIndex;
+	state.DisplayMessage = displayMessage;
+	CopySaveState(state);
+
+	{
+		auto lock = _saveLock.AcquireSafe();
+		_pendingSaves.push_back(std::move(state));
+		_pendingSaveCount++;
+		if(!_saveThread.joinable()) {
+			_saveThread = std::thread(&SaveStateManager::WritePendingSaves, this);
+		}
+	}
+	_saveSignal.Signal();
+}
+
+void SaveStateManager::WritePendingSaves()
+{
+	while(true) {
+		PendingSaveState state;
+		bool hasState = false;
+		{
+			auto lock = _saveLock.AcquireSafe();
+			if(!_pendingSaves.empty()) {
+				state = std::move(_pendingSaves.front());
+				_pendingSaves.pop_front();
+				hasState = true;
+			}
+		}
+
+		if(hasState) {
+			WriteSaveState(state);
+			_pendingSaveCount--;
+			_saveDoneSignal.Signal();
+		} else if(_stopSaveThread) {
+			break;
+		} else {
+			_saveSignal.Wait();
+		}
+	}
+}
 
+bool SaveStateManager::WriteSaveState(PendingSaveState &state)
+{
+	ofstream file(state.Filepath, ios::out | ios::binary);
 	if(file) {
-		_console->Pause();
-		SaveState(file);
+		file.write(state.StateInfo.c_str(), state.StateInfo.size());
+		#ifndef LIBRETRO
+		SaveScreenshotData(file, (uint16_t*)state.ScreenBuffer.data());
+		#endif
+		file.write(state.StateData.c_str(), state.StateData.size());
 		file.close();
+	}
 
-		shared_ptr<Debugger> debugger = _console->GetDebugger(false);
-		if(debugger) {
-			debugger->ProcessEvent(EventType::StateSaved);
-		}
+	if(!file) {
+		MessageManager::Log("[SaveState] Could not write file: " + state.Filepath);
+		return false;
+	}
 
-		_console->Resume();
-		return true;
+	if(state.DisplayMessage) {
+		MessageManager::DisplayMessage("SaveStates", "SaveStateSaved", std::to_string(state.StateIndex));
 	}
-	return false;
+
+	shared_ptr<NotificationManager> notificationManager = _console->GetNotificationManager();
+	if(notificationManager) {
+		notificationManager->SendNotification(ConsoleNotificationType::StateSaved);
+	}
+	return true;
 }
 
-void SaveStateManager::SaveState(int stateIndex, bool displayMessage)
+void SaveStateManager::WaitForPendingSaves()
 {
-	string filepath = SaveStateManager::GetStateFilepath(stateIndex);
-	if(SaveState(filepath)) {
-		if(displayMessage) {
-			MessageManager::DisplayMessage("SaveStates", "SaveStateSaved", std::to_string(stateIndex));
-		}
+	while(_pendingSaveCount > 0) {
+		_saveDoneSignal.Wait(100);
 	}
 }
 
-void SaveStateManager::SaveScreenshotData(ostream &stream)
+void SaveStateManager::SaveScreenshotData(ostream &stream, uint16_t* screenBuffer)
 {
 	unsigned long compressedSize = compressBound(PPU::PixelCount * 2);
 	vector<uint8_t> compressedData(compressedSize, 0);
-	compress2(compressedData.data(), &compressedSize, (const unsigned char*)_console->GetPpu()->GetScreenBuffer(true), PPU::PixelCount * 2, MZ_DEFAULT_LEVEL);
+	compress2(compressedData.data(), &compressedSize, (const unsigned char*)screenBuffer, PPU::PixelCount * 2, MZ_DEFAULT_LEVEL);
 
 	uint32_t screenshotLength = (uint32_t)compressedSize;
 	stream.write((char*)&screenshotLength, sizeof(uint32_t));
@@ -224,6 +335,9 @@ bool SaveStateManager::LoadState(istream &stream, bool hashCheckRequired)
 
 bool SaveStateManager::LoadState(string filepath, bool hashCheckRequired)
 {
+	//The file may still be being written by the save thread
+	WaitForPendingSaves();
+
 	ifstream file(filepath, ios::in | ios::binary);
 	bool result = false;
 
@@ -308,6 +422,8 @@ void SaveStateManager::LoadRecentGame(string filename, bool resetGame)
 
 int32_t SaveStateManager::GetSaveStatePreview(string saveStatePath, uint8_t* pngData)
 {
+	WaitForPendingSaves();
+
 	ifstream stream(saveStatePath, ios::binary);
 
 	if(!stream) {
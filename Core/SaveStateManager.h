@@ -1,8 +1,23 @@
 #pragma once
 #include "stdafx.h"
+#include <thread>
+#include <deque>
+#include "../Utilities/SimpleLock.h"
+#include "../Utilities/AutoResetEvent.h"
 
 class Console;
 
+struct PendingSaveState
+{
+	string Filepath;
+	int StateIndex = -1;
+	bool DisplayMessage = false;
+
+	string StateInfo;
+	vector<uint8_t> ScreenBuffer;
+	string StateData;
+};
+
 class SaveStateManager
 {
 private:
@@ -11,14 +26,37 @@ private:
 	atomic<uint32_t> _lastIndex;
 	shared_ptr<Console> _console;
 
+	//Slot save states are compressed & written to the disk by a separate thread - the emulation is only paused while the state is copied in memory
+	std::thread _saveThread;
+	atomic<bool> _stopSaveThread;
+	SimpleLock _saveLock;
+	AutoResetEvent _saveSignal;
+	AutoResetEvent _saveDoneSignal;
+	std::deque<PendingSaveState> _pendingSaves;
+	atomic<uint32_t> _pendingSaveCount;
+
 	string GetStateFilepath(int stateIndex);	
-	void SaveScreenshotData(ostream& stream);
+	void WriteStateInfo(ostream& stream);
+	void WriteRomName(ostream& stream);
+	void SaveScreenshotData(ostream& stream, uint16_t* screenBuffer);
 	bool GetScreenshotData(vector<uint8_t>& out, istream& stream);
 
+	void CopySaveState(PendingSaveState &state);
+	void QueueSaveState(string filepath, int stateIndex, bool displayMessage);
+	void WritePendingSaves();
+	bool WriteSaveState(PendingSaveState &state);
+
 public:
 	static constexpr uint32_t FileFormatVersion = 13;
 
+	//Upper bound for the size of an uncompressed state - sizes read from files or received over the network are checked against it before allocating
+	static constexpr uint32_t MaxStateSize = 32 * 1024 * 1024;
+
 	SaveStateManager(shared_ptr<Console> console);
+	~SaveStateManager();
+
+	//Blocks until all the save states that were queued have been written to the disk
+	void WaitForPendingSaves();
 
 	void SaveState();
 	bool LoadState();
@@ -26,7 +64,11 @@ public:
 	void GetSaveStateHeader(ostream & stream);
 
 	void SaveState(ostream &stream);
+
+	//Writes the file before returning - returns false if the file could not be written
 	bool SaveState(string filepath);
+
+	//Slot saves are written by the save thread (see WaitForPendingSaves), failures are logged
 	void SaveState(int stateIndex, bool displayMessage = true);
 	bool LoadState(istream &stream, bool hashCheckRequired = true);
 	bool LoadState(string filepath, bool hashCheckRequired = true);
@@ -3,14 +3,23 @@
 #include "NetMessage.h"
 #include "Console.h"
 #include "CheatManager.h"
+#include "SaveStateManager.h"
+#include "../Utilities/miniz.h"
 
 class SaveStateMessage : public NetMessage
 {
 private:
 	vector<CodeInfo> _activeCheats;
 
-	uint8_t* _stateData = nullptr;
-	uint32_t _dataSize = 0;
+	//Unique ID for this state, used by the client to acknowledge it (so it can be used as the base for the next delta)
+	uint32_t _stateId = 0;
+
+	//When non-zero, _stateData is the compressed XOR delta between this state and the state with this ID
+	uint32_t _baseStateId = 0;
+
+	uint32_t _originalSize = 0;
+	vector<uint8_t> _stateData;
+	vector<uint8_t> _rawState;
 
 	CodeInfo* _cheats = nullptr;
 	uint32_t _cheatArraySize = 0;
@@ -18,13 +27,15 @@ private:
 protected:
 	virtual void ProtectedStreamState()
 	{
-		StreamArray((void**)&_stateData, _dataSize);
+		Stream<uint32_t>(_stateId);
+		Stream<uint32_t>(_baseStateId);
+		Stream<uint32_t>(_originalSize);
+		StreamArray(_stateData);
 
 		if(_sending) {
 			_cheats = _activeCheats.size() > 0 ? &_activeCheats[0] : nullptr;
 			_cheatArraySize = (uint32_t)_activeCheats.size() * sizeof(CodeInfo);
 			StreamArray((void**)&_cheats, _cheatArraySize);
-			delete[] _stateData;
 		} else {
 			StreamArray((void**)&_cheats, _cheatArraySize);
 		}
@@ -32,8 +43,8 @@ protected:
 
 public:
 	SaveStateMessage(void* buffer, uint32_t length) : NetMessage(buffer, length) { }
-	
-	SaveStateMessage(shared_ptr<Console> console) : NetMessage(MessageType::SaveState)
+
+	SaveStateMessage(shared_ptr<Console> console, uint32_t stateId, uint32_t baseStateId, vector<uint8_t> &baseState) : NetMessage(MessageType::SaveState)
 	{
 		//Used when sending state to clients
 		console->Pause();
@@ -42,19 +53,85 @@ public:
 		console->SaveState(state);
 		console->Resume();
 
-		_dataSize = (uint32_t)state.tellp();
-		_stateData = new uint8_t[_dataSize];
-		state.read((char*)_stateData, _dataSize);
+		string stateData = state.str();
+		_rawState.assign(stateData.begin(), stateData.end());
+		_originalSize = (uint32_t)_rawState.size();
+		_stateId = stateId;
+
+		vector<uint8_t> delta;
+		uint8_t* source = _rawState.data();
+		if(baseStateId != 0 && baseState.size() == _rawState.size()) {
+			//Most of the state is identical to the last state the client acknowledged - XOR them to get a buffer that is mostly zeroes
+			_baseStateId = baseStateId;
+			delta.resize(_rawState.size());
+			for(size_t i = 0, len = _rawState.size(); i < len; i++) {
+				delta[i] = _rawState[i] ^ baseState[i];
+			}
+			source = delta.data();
+		}
+
+		unsigned long compressedSize = compressBound(_originalSize);
+		_stateData.resize(compressedSize);
+		compress2(_stateData.data(), &compressedSize, source, _originalSize, MZ_DEFAULT_LEVEL);
+		_stateData.resize(compressedSize);
 	}
-	
-	void LoadState(shared_ptr<Console> console)
+
+	uint32_t GetStateId()
 	{
-		console->LoadState((uint8_t*)_stateData, _dataSize);
+		return _stateId;
+	}
+
+	uint32_t GetBaseStateId()
+	{
+		return _baseStateId;
+	}
+
+	uint32_t GetOriginalSize()
+	{
+		return _originalSize;
+	}
+
+	uint32_t GetCompressedSize()
+	{
+		return (uint32_t)_stateData.size();
+	}
+
+	vector<uint8_t>& GetRawState()
+	{
+		return _rawState;
+	}
+
+	bool LoadState(shared_ptr<Console> console, uint32_t baseStateId, vector<uint8_t> &baseState)
+	{
+		if(_originalSize > SaveStateManager::MaxStateSize) {
+			//The size is sent by the server, don't allocate it blindly
+			return false;
+		}
+
+		_rawState.resize(_originalSize);
+		unsigned long decompSize = _originalSize;
+		if(uncompress(_rawState.data(), &decompSize, _stateData.data(), (unsigned long)_stateData.size()) != MZ_OK || decompSize != _originalSize) {
+			return false;
+		}
+
+		if(_baseStateId != 0) {
+			if(_baseStateId != baseStateId || baseState.size() != _rawState.size()) {
+				//We don't have the state this delta was based on
+				return false;
+			}
+
+			for(size_t i = 0, len = _rawState.size(); i < len; i++) {
+				_rawState[i] ^= baseState[i];
+			}
+		}
+
+		console->LoadState(_rawState.data(), (uint32_t)_rawState.size());
 
 		vector<CodeInfo> cheats;
 		for(uint32_t i = 0; i < _cheatArraySize / sizeof(CodeInfo); i++) {
 			cheats.push_back(((CodeInfo*)_cheats)[i]);
 		}
 		console->GetCheatManager()->SetCheats(cheats);
+		return true;
 	}
-};
\ No newline at end of file
+};
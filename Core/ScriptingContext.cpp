@@ -4,6 +4,7 @@
 #include "DebuggerTypes.h"
 #include "Debugger.h"
 #include "Console.h"
+#include "CPU.h"
 #include "SaveStateManager.h"
 
 string ScriptingContext::_log = "";
@@ -48,10 +49,19 @@ void ScriptingContext::CallMemoryCallback(uint16_t addr, uint8_t &value, Callbac
 	_inExecOpEvent = type == CallbackType::CpuExec;
 	InternalCallMemoryCallback(addr, value, type);
 	_inExecOpEvent = false;
+
+	if(_hasMemoryLog[(int)type]) {
+		LogMemoryAccess(addr, value, type);
+	}
 }
 
 int ScriptingContext::CallEventCallback(EventType type)
 {
+	if(type == EventType::EndFrame) {
+		//Memory logs are delivered once per frame, before the script's own end of frame callbacks
+		FlushMemoryLogs();
+	}
+
 	_inStartFrameEvent = type == EventType::StartFrame;
 	int returnValue = InternalCallEventCallback(type);
 	_inStartFrameEvent = false;
@@ -131,6 +141,98 @@ void ScriptingContext::UnregisterEventCallback(EventType type, int reference)
 	callbacks.erase(std::remove(callbacks.begin(), callbacks.end(), reference), callbacks.end());
 }
 
+void ScriptingContext::RegisterMemoryLog(CallbackType type, int startAddr, int endAddr, uint32_t bufferSize, int reference)
+{
+	if(endAddr < startAddr || bufferSize == 0) {
+		return;
+	}
+
+	if(startAddr == 0 && endAddr == 0) {
+		if(type <= CallbackType::CpuExec) {
+			endAddr = 0xFFFF;
+		} else {
+			endAddr = 0x3FFF;
+		}
+	}
+
+	MemoryLog log = {};
+	log.Reference = reference;
+	log.Type = type;
+	log.StartAddr = startAddr;
+	log.EndAddr = endAddr;
+	log.Entries.resize(bufferSize);
+	_memoryLogs.push_back(std::move(log));
+	_hasMemoryLog[(int)type] = true;
+}
+
+void ScriptingContext::UnregisterMemoryLog(int reference)
+{
+	_memoryLogs.erase(std::remove_if(_memoryLogs.begin(), _memoryLogs.end(), [=](const MemoryLog &log) {
+		return log.Reference == reference;
+	}), _memoryLogs.end());
+
+	for(int i = 0; i < 5; i++) {
+		_hasMemoryLog[i] = std::any_of(_memoryLogs.begin(), _memoryLogs.end(), [=](const MemoryLog &log) {
+			return (int)log.Type == i;
+		});
+	}
+}
+
+void ScriptingContext::LogMemoryAccess(uint16_t addr, uint8_t value, CallbackType type)
+{
+	uint64_t cycle = _debugger->GetConsole()->GetCpu()->GetCycleCount();
+	for(MemoryLog &log : _memoryLogs) {
+		if(log.Type == type && addr >= log.StartAddr && addr <= log.EndAddr) {
+			uint32_t size = (uint32_t)log.Entries.size();
+			log.Entries[log.Position] = { cycle, addr, value };
+			log.Position = (log.Position + 1) % size;
+			if(log.Count < size) {
+				log.Count++;
+			} else {
+				log.DroppedCount++;
+			}
+		}
+	}
+}
+
+void ScriptingContext::FlushMemoryLogs()
+{
+	vector<int> references;
+	for(MemoryLog &log : _memoryLogs) {
+		if(log.Count > 0 || log.DroppedCount > 0) {
+			references.push_back(log.Reference);
+		}
+	}
+
+	//Callbacks may add/remove logs, so look each log up again by its reference
+	for(int reference : references) {
+		FlushMemoryLog(reference);
+	}
+}
+
+bool ScriptingContext::FlushMemoryLog(int reference)
+{
+	for(MemoryLog &log : _memoryLogs) {
+		if(log.Reference == reference) {
+			//Copy the entries (oldest first) and reset the log before calling the callback
+			uint32_t size = (uint32_t)log.Entries.size();
+			uint32_t start = (log.Position + size - log.Count) % size;
+			vector<MemoryLogEntry> entries;
+			entries.reserve(log.Count);
+			for(uint32_t i = 0; i < log.Count; i++) {
+				entries.push_back(log.Entries[(start + i) % size]);
+			}
+			uint32_t droppedCount = log.DroppedCount;
+			log.Count = 0;
+			log.DroppedCount = 0;
+
+			InternalFlushMemoryLog(reference, entries, droppedCount);
+			return true;
+		}
+	}
+	return false;
+}
+
 void ScriptingContext::RequestSaveState(int slot)
 {
 	_saveSlot = slot;
@@ -15,6 +15,27 @@ enum class CallbackType
 	PpuWrite = 4
 };
 
+struct MemoryLogEntry
+{
+	uint64_t CpuCycle;
+	uint16_t Address;
+	uint8_t Value;
+};
+
+struct MemoryLog
+{
+	int Reference;
+	CallbackType Type;
+	int32_t StartAddr;
+	int32_t EndAddr;
+
+	//Ring buffer - once full, the oldest entries are overwritten (and counted as dropped)
+	vector<MemoryLogEntry> Entries;
+	uint32_t Position;
+	uint32_t Count;
+	uint32_t DroppedCount;
+};
+
 class ScriptingContext
 {
 private:
@@ -41,8 +62,15 @@ protected:
 	vector<int> _callbacks[5][0x10000];
 	vector<int> _eventCallbacks[(int)EventType::EventTypeSize];
 
+	vector<MemoryLog> _memoryLogs;
+	bool _hasMemoryLog[5] = {};
+
 	virtual void InternalCallMemoryCallback(uint16_t addr, uint8_t &value, CallbackType type) = 0;
 	virtual int InternalCallEventCallback(EventType type) = 0;
+	virtual void InternalFlushMemoryLog(int reference, vector<MemoryLogEntry> &entries, uint32_t droppedCount) = 0;
+
+	void LogMemoryAccess(uint16_t addr, uint8_t value, CallbackType type);
+	void FlushMemoryLogs();
 
 public:
 	ScriptingContext(Debugger* debugger);
@@ -75,4 +103,8 @@ public:
 	virtual void UnregisterMemoryCallback(CallbackType type, int startAddr, int endAddr, int reference);
 	void RegisterEventCallback(EventType type, int reference);
 	virtual void UnregisterEventCallback(EventType type, int reference);
+
+	void RegisterMemoryLog(CallbackType type, int startAddr, int endAddr, uint32_t bufferSize, int reference);
+	virtual void UnregisterMemoryLog(int reference);
+	bool FlushMemoryLog(int reference);
 };
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include "Snapshotable.h"
 #include "SaveStateManager.h"
+#include "../Utilities/CRC32.h"
 
 void Snapshotable::StreamStartBlock()
 {
@@ -67,7 +68,7 @@ void Snapshotable::Stream(Snapshotable* snapshotable)
 	}
 }
 
-void Snapshotable::SaveSnapshot(ostream* file)
+void Snapshotable::WriteState()
 {
 	_stateVersion = SaveStateManager::FileFormatVersion;
 
@@ -77,14 +78,29 @@ void Snapshotable::SaveSnapshot(ostream* file)
 	_saving = true;
 
 	StreamState(_saving);
+
+	if(_blockBuffer) {
+		delete[] _stream;
+		throw new std::runtime_error("A call to StreamEndBlock is missing.");
+	}
+}
+
+void Snapshotable::SaveSnapshot(ostream* file)
+{
+	WriteState();
 	file->write((char*)&_position, sizeof(_position));
 	file->write((char*)_stream, _position);
 
 	delete[] _stream;
+}
 
-	if(_blockBuffer) {
-		throw new std::runtime_error("A call to StreamEndBlock is missing.");
-	}
+uint32_t Snapshotable::GetStateChecksum()
+{
+	WriteState();
+	uint32_t checksum = CRC32::GetCRC(_stream, _position);
+
+	delete[] _stream;
+	return checksum;
 }
 
 void Snapshotable::LoadSnapshot(istream* file, uint32_t stateVersion)
@@ -210,6 +210,7 @@ private:
 
 	void StreamStartBlock();
 	void StreamEndBlock();
+	void WriteState();
 
 protected:
 	virtual void StreamState(bool saving) = 0;
@@ -230,6 +231,9 @@ public:
 	virtual ~Snapshotable() {}
 
 	void SaveSnapshot(ostream* file);
+
+	//Returns a CRC32 of the data SaveSnapshot would write, without writing it to a stream
+	uint32_t GetStateChecksum();
 	void LoadSnapshot(istream* file, uint32_t stateVersion);
 
 	static void WriteEmptyBlock(ostream* file);
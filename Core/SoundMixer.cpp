@@ -9,6 +9,7 @@
 #include "OggMixer.h"
 #include "Console.h"
 #include "BaseMapper.h"
+#include "FrameProfiler.h"
 
 SoundMixer::SoundMixer(shared_ptr<Console> console)
 {
@@ -101,6 +102,20 @@ void SoundMixer::Reset()
 
 void SoundMixer::PlayAudioBuffer(uint32_t time)
 {
+	PROFILE_SCOPE(_console->GetFrameProfiler(), PlayAudioBuffer);
+
+	if(_settings->IsHeadlessMode()) {
+		//No audio output in headless mode, only keep track of each channel's output level
+		for(uint32_t stamp : _timestamps) {
+			for(uint32_t j = 0; j < MaxChannelCount; j++) {
+				_currentOutput[j] += _channelOutput[j][stamp];
+				_channelOutput[j][stamp] = 0;
+			}
+		}
+		_timestamps.clear();
+		return;
+	}
+
 	UpdateTargetSampleRate();
 	EndFrame(time);
 
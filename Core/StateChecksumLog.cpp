@@ -0,0 +1,159 @@
+#include "stdafx.h"
+#include "StateChecksumLog.h"
+#include "Console.h"
+#include "CPU.h"
+#include "PPU.h"
+#include "APU.h"
+#include "MemoryManager.h"
+#include "ControlManager.h"
+#include "BaseMapper.h"
+
+bool StateChecksumLog::Start(string filename, bool dualSystem)
+{
+	_file.open(filename, ios::out | ios::binary);
+	if(!_file) {
+		return false;
+	}
+
+	_checksumCount = dualSystem ? ComponentCount * 2 : ComponentCount;
+	_record.clear();
+
+	_file.write(Signature, 4);
+	_file.write((char*)&FormatVersion, sizeof(FormatVersion));
+	_file.write((char*)&_checksumCount, sizeof(_checksumCount));
+	return true;
+}
+
+void StateChecksumLog::AddChecksums(Console* console)
+{
+	//Same order as StateComponent
+	_record.push_back(console->GetCpu()->GetStateChecksum());
+	_record.push_back(console->GetPpu()->GetStateChecksum());
+	_record.push_back(console->GetMemoryManager()->GetStateChecksum());
+	_record.push_back(console->GetApu()->GetStateChecksum());
+	_record.push_back(console->GetControlManager()->GetStateChecksum());
+	_record.push_back(console->GetMapper()->GetStateChecksum());
+}
+
+void StateChecksumLog::ProcessEndOfFrame(Console* console)
+{
+	//Each record is the frame number, followed by one checksum per component
+	_record.clear();
+	_record.push_back(console->GetFrameCount());
+	AddChecksums(console);
+
+	shared_ptr<Console> slave = console->GetDualConsole();
+	if(slave) {
+		AddChecksums(slave.get());
+	}
+	_record.resize(_checksumCount + 1);
+
+	_file.write((char*)_record.data(), _record.size() * sizeof(uint32_t));
+}
+
+void StateChecksumLog::ProcessReset()
+{
+	//Frame numbers restart after a reset, the marker is used to tell them apart from the previous ones
+	_record.clear();
+	_record.resize(_checksumCount + 1);
+	_record[0] = ResetMarker;
+
+	_file.write((char*)_record.data(), _record.size() * sizeof(uint32_t));
+}
+
+bool StateChecksumLog::LoadLog(string filename, uint32_t &checksumCount, vector<FrameChecksums> &frames)
+{
+	ifstream file(filename, ios::in | ios::binary);
+	if(!file) {
+		return false;
+	}
+
+	char signature[4];
+	uint32_t formatVersion = 0;
+	file.read(signature, 4);
+	file.read((char*)&formatVersion, sizeof(formatVersion));
+	file.read((char*)&checksumCount, sizeof(checksumCount));
+	if(!file || memcmp(signature, Signature, 4) != 0 || formatVersion != FormatVersion || checksumCount == 0 || checksumCount > ComponentCount * 2) {
+		return false;
+	}
+
+	uint32_t segment = 0;
+	vector<uint32_t> record(checksumCount + 1);
+	while(file.read((char*)record.data(), record.size() * sizeof(uint32_t))) {
+		uint32_t frame = record[0];
+		if(frame == ResetMarker) {
+			segment++;
+			continue;
+		}
+
+		//Going back to an earlier frame (load state, rewind, netplay rollback) replaces the frames that were logged after it
+		while(!frames.empty() && frames.back().Segment == segment && frames.back().Frame >= frame) {
+			frames.pop_back();
+		}
+
+		frames.push_back({ segment, frame, vector<uint32_t>(record.begin() + 1, record.end()) });
+	}
+	return true;
+}
+
+bool StateChecksumLog::Compare(string filenameA, string filenameB, StateChecksumDiff &diff)
+{
+	uint32_t countA, countB;
+	vector<FrameChecksums> framesA, framesB;
+	if(!LoadLog(filenameA, countA, framesA) || !LoadLog(filenameB, countB, framesB) || countA != countB) {
+		return false;
+	}
+
+	diff = StateChecksumDiff();
+
+	//Only the frames present in both logs are compared (e.g when one of the logs was started later)
+	size_t i = 0, j = 0;
+	while(i < framesA.size() && j < framesB.size()) {
+		FrameChecksums &a = framesA[i];
+		FrameChecksums &b = framesB[j];
+		if(a.Segment != b.Segment || a.Frame != b.Frame) {
+			if(a.Segment < b.Segment || (a.Segment == b.Segment && a.Frame < b.Frame)) {
+				i++;
+			} else {
+				j++;
+			}
+			continue;
+		}
+
+		diff.ComparedFrames++;
+		for(uint32_t k = 0; k < countA; k++) {
+			if(a.Checksums[k] != b.Checksums[k]) {
+				diff.ComponentMask |= 1 << k;
+			}
+		}
+
+		if(diff.ComponentMask) {
+			diff.Diverged = true;
+			diff.Segment = a.Segment;
+			diff.Frame = a.Frame;
+			break;
+		}
+		i++;
+		j++;
+	}
+	return true;
+}
+
+string StateChecksumLog::GetComponentNames(uint32_t componentMask)
+{
+	static const char* names[ComponentCount] = { "CPU", "PPU", "RAM", "APU", "Input", "Mapper" };
+
+	string result;
+	for(uint32_t i = 0; i < ComponentCount * 2; i++) {
+		if(componentMask & (1 << i)) {
+			if(!result.empty()) {
+				result += ", ";
+			}
+			result += names[i % ComponentCount];
+			if(i >= ComponentCount) {
+				result += " (Sub)";
+			}
+		}
+	}
+	return result;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "stdafx.h"
+
+class Console;
+
+enum class StateComponent
+{
+	Cpu = 0,
+	Ppu = 1,
+	Ram = 2,
+	Apu = 3,
+	Input = 4,
+	Mapper = 5
+};
+
+struct StateChecksumDiff
+{
+	bool Diverged = false;
+
+	//Frame where the 2 runs first differ (Segment is the number of resets/power cycles that occurred before it)
+	uint32_t Segment = 0;
+	uint32_t Frame = 0;
+
+	//One bit per StateComponent (bits 6+ are the VS DualSystem's 2nd console), for the components that differ in that frame
+	uint32_t ComponentMask = 0;
+
+	uint32_t ComparedFrames = 0;
+};
+
+//Determinism audit: logs a CRC32 of the state of each component (the same data save states contain) at the end of every frame
+//Two logs (e.g from 2 netplay peers or 2 runs of the same movie) can then be compared to find the first frame and component that diverged
+class StateChecksumLog
+{
+private:
+	static constexpr const char* Signature = "MSCL";
+	static constexpr uint32_t FormatVersion = 1;
+	static constexpr uint32_t ComponentCount = 6;
+	static constexpr uint32_t ResetMarker = 0xFFFFFFFF;
+
+	struct FrameChecksums
+	{
+		uint32_t Segment;
+		uint32_t Frame;
+		vector<uint32_t> Checksums;
+	};
+
+	ofstream _file;
+	uint32_t _checksumCount = 0;
+	vector<uint32_t> _record;
+
+	void AddChecksums(Console* console);
+
+	static bool LoadLog(string filename, uint32_t &checksumCount, vector<FrameChecksums> &frames);
+
+public:
+	bool Start(string filename, bool dualSystem);
+	void ProcessEndOfFrame(Console* console);
+	void ProcessReset();
+
+	static bool Compare(string filenameA, string filenameB, StateChecksumDiff &diff);
+	static string GetComponentNames(uint32_t componentMask);
+};
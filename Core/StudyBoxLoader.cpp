@@ -31,10 +31,10 @@ vector<uint8_t> StudyBoxLoader::ReadArray(uint8_t*& data, uint32_t length)
 	return out;
 }
 
-bool StudyBoxLoader::LoadStudyBoxTape(vector<uint8_t> studyBoxFile, StudyBoxData& studyBoxData)
+bool StudyBoxLoader::LoadStudyBoxTape(uint8_t* studyBoxFile, size_t fileSize, StudyBoxData& studyBoxData)
 {
-	uint8_t* data = studyBoxFile.data();
-	uint8_t* end = data + studyBoxFile.size();
+	uint8_t* data = studyBoxFile;
+	uint8_t* end = data + fileSize;
 
 	if(end - data < 16) {
 		//File too small to parse
@@ -132,7 +132,7 @@ vector<uint8_t> StudyBoxLoader::LoadBios()
 	return {};
 }
 
-void StudyBoxLoader::LoadRom(RomData& romData, vector<uint8_t>& romFile, string filepath)
+void StudyBoxLoader::LoadRom(RomData& romData, uint8_t* romFile, size_t romSize, string filepath)
 {
 	romData.Info.Hash.PrgCrc32 = romData.Info.Hash.Crc32;
 
@@ -151,7 +151,7 @@ void StudyBoxLoader::LoadRom(RomData& romData, vector<uint8_t>& romFile, string
 		romData.BiosMissing = true;
 	} else {
 		romData.StudyBox.FileName = filepath;
-		if(!LoadStudyBoxTape(romFile, romData.StudyBox)) {
+		if(!LoadStudyBoxTape(romFile, romSize, romData.StudyBox)) {
 			romData.Error = true;
 		}
 	}
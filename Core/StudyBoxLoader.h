@@ -12,11 +12,11 @@ private:
 	string ReadFourCC(uint8_t*& data);
 	vector<uint8_t> ReadArray(uint8_t*& data, uint32_t length);
 
-	bool LoadStudyBoxTape(vector<uint8_t> studyBoxFile, StudyBoxData& studyBoxData);
+	bool LoadStudyBoxTape(uint8_t* studyBoxFile, size_t fileSize, StudyBoxData& studyBoxData);
 	vector<uint8_t> LoadBios();
 
 public:
 	using BaseLoader::BaseLoader;
 
-	void LoadRom(RomData& romData, vector<uint8_t>& romFile, string filepath);
+	void LoadRom(RomData& romData, uint8_t* romFile, size_t romSize, string filepath);
 };
\ No newline at end of file
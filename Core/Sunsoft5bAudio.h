@@ -69,7 +69,7 @@ private:
 			}
 		}
 
-		_console->GetApu()->AddExpansionAudioDelta(AudioChannel::Sunsoft5B, summedOutput - _lastOutput);
+		AddAudioDelta(AudioChannel::Sunsoft5B, summedOutput - _lastOutput);
 		_lastOutput = summedOutput;
 	}
 
@@ -118,6 +118,7 @@ public:
 
 	void WriteRegister(uint16_t addr, uint8_t value)
 	{
+		Run();
 		switch(addr & 0xE000) {
 			case 0xC000:
 				_currentRegister = value & 0x0F;
@@ -47,18 +47,29 @@ protected:
 		}
 	}
 
+	void RunExpansionAudio() override
+	{
+		_audio->Run();
+	}
+
+	void ClockExpansionAudio() override
+	{
+		_audio->Clock();
+	}
+
 	void ProcessCpuClock() override
 	{
+		//The counter is only updated when its value is needed (on the cycle the IRQ occurs, before writes to the IRQ registers and when saving a state)
+		uint32_t cycles = TakePendingCpuClocks();
 		if(_irqCounterEnabled) {
-			_irqCounter--;
-			if(_irqCounter == 0xFFFF) {
-				if(_irqEnabled) {
-					_console->GetCpu()->SetIrqSource(IRQSource::External);
-				}
+			if(cycles > _irqCounter && _irqEnabled) {
+				//The counter wrapped from 0 to $FFFF
+				_console->GetCpu()->SetIrqSource(IRQSource::External);
 			}
+			_irqCounter -= cycles;
 		}
 
-		_audio->Clock();
+		SetCpuClockPeriod(_irqCounterEnabled && _irqEnabled ? _irqCounter + 1 : 0);
 	}
 
 	void UpdateWorkRam()
@@ -78,6 +89,11 @@ protected:
 				_command = value;
 				break;
 			case 0xA000:
+				if(_command >= 0x0D && _command <= 0x0F) {
+					//Catch up to the current cycle before changing the IRQ counter
+					ProcessCpuClock();
+				}
+
 				switch(_command) {
 					case 0: case 1: case 2: case 3: case 4: case 5: case 6: case 7:
 						SelectCHRPage(_command, value);
@@ -116,6 +132,11 @@ protected:
 						_irqCounter = (_irqCounter & 0xFF) | (value << 8);
 						break;
 				}
+
+				if(_command >= 0x0D && _command <= 0x0F) {
+					//Schedule the next IRQ
+					ProcessCpuClock();
+				}
 				break;
 
 			case 0xC000:
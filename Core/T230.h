@@ -23,7 +23,7 @@ protected:
 
 	void InitMapper() override
 	{
-		_irq.reset(new VrcIrq(_console));
+		_irq.reset(new VrcIrq(_console, this));
 
 		_prgMode = GetPowerOnByte() & 0x01;
 		_prgReg0 = GetPowerOnByte() & 0x1F;
@@ -323,6 +323,9 @@ public:
 	char Description[10000] = {};
 
 	RecordMovieFrom RecordFrom = RecordMovieFrom::StartWithoutSaveData;
+
+	//Number of seconds between each save state keyframe embedded in the movie (0 = no keyframes)
+	uint32_t KeyframeInterval = 10;
 };
 
 enum class GameSystem
@@ -25,6 +25,8 @@ protected:
 
 	void InitMapper() override
 	{
+		//The flash memory writes directly to the PRG ROM
+		UnsharePrgRom();
 		_flash.reset(new FlashSST39SF040(_prgRom, _prgSize));
 		SelectPRGPage(0, 0);
 		SelectPRGPage(1, -1);
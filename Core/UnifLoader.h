@@ -2,7 +2,7 @@
 #include "stdafx.h"
 #include <unordered_map>
 #include "../Utilities/CRC32.h"
-#include "../Utilities/md5.h"
+#include "../Utilities/HashUtilities.h"
 #include "../Utilities/HexUtilities.h"
 #include "RomData.h"
 #include "GameDatabase.h"
@@ -160,11 +160,11 @@ public:
 		return UnifBoards::UnknownBoard;
 	}
 
-	void LoadRom(RomData &romData, vector<uint8_t>& romFile)
+	void LoadRom(RomData &romData, uint8_t* romFile, size_t romSize)
 	{
 		//Skip header, version & null bytes, start reading at first chunk
-		uint8_t* data = romFile.data() + 32;
-		uint8_t* endOfFile = romFile.data() + romFile.size();
+		uint8_t* data = romFile + 32;
+		uint8_t* endOfFile = romFile + romSize;
 
 		while(ReadChunk(data, endOfFile, romData)) {
 			//Read all chunks
@@ -184,8 +184,9 @@ public:
 
 			romData.Info.Format = RomFormat::Unif;
 			romData.Info.Hash.PrgCrc32 = CRC32::GetCRC(romData.PrgRom.data(), romData.PrgRom.size());
-			romData.Info.Hash.PrgChrCrc32 = CRC32::GetCRC(fullRom.data(), fullRom.size());
-			romData.Info.Hash.PrgChrMd5 = GetMd5Sum(fullRom.data(), fullRom.size());
+			HashValues hashes = HashUtilities::GetHashes(fullRom, HashType::Crc32Hash | HashType::Md5Hash);
+			romData.Info.Hash.PrgChrCrc32 = hashes.Crc32;
+			romData.Info.Hash.PrgChrMd5 = hashes.Md5;
 
 			Log("PRG+CHR CRC32: 0x" + HexUtilities::ToHex(romData.Info.Hash.PrgChrCrc32));
 			Log("[UNIF] Board Name: " + _mapperName);
@@ -61,6 +61,18 @@ protected:
 		}
 	}
 
+	void RunExpansionAudio() override
+	{
+		_audioChannels[0]->Run();
+		_audioChannels[1]->Run();
+	}
+
+	void ClockExpansionAudio() override
+	{
+		_audioChannels[0]->Clock();
+		_audioChannels[1]->Clock();
+	}
+
 	void ProcessCpuClock() override
 	{
 		if(_irqEnabled) {
@@ -75,9 +87,6 @@ protected:
 				}
 			}
 		}
-
-		_audioChannels[0]->Clock();
-		_audioChannels[1]->Clock();
 	}
 
 	void UpdateWorkRamState()
@@ -50,7 +50,7 @@ protected:
 
 	void SetOutput(int16_t output)
 	{
-		_console->GetApu()->AddExpansionAudioDelta(AudioChannel::VRC7, (output - _prevOutput) * 3);
+		AddAudioDelta(AudioChannel::VRC7, (output - _prevOutput) * 3);
 		_prevOutput = output;
 	}
 
@@ -75,6 +75,7 @@ public:
 
 	uint8_t ReadRegister()
 	{
+		Run();
 		uint8_t result = 0;
 		if(_bufferFull) {
 			result |= 0x80;
@@ -87,6 +88,7 @@ public:
 
 	void WriteRegister(uint16_t addr, uint8_t value)
 	{
+		Run();
 		switch(addr & 0x03) {
 			case 0:
 				//Writing any value will silence the corresponding sound channel
@@ -84,7 +84,7 @@ class VRC2_4 : public BaseMapper
 
 		void InitMapper() override 
 		{
-			_irq.reset(new VrcIrq(_console));
+			_irq.reset(new VrcIrq(_console, this));
 			DetectVariant();
 
 			//PRG mode only exists for VRC4+ (so keep it as 0 at all times for VRC2)
@@ -112,6 +112,8 @@ class VRC2_4 : public BaseMapper
 			if((_useHeuristics && _romInfo.MapperID != 22) || _variant >= VRCVariant::VRC4a) {
 				//Only VRC4 supports IRQs
 				_irq->ProcessCpuClock();
+			} else {
+				SetCpuClockPeriod(0);
 			}
 		}
 
@@ -28,7 +28,7 @@ protected:
 	void InitMapper() override
 	{
 		_audio.reset(new Vrc6Audio(_console));
-		_irq.reset(new VrcIrq(_console));
+		_irq.reset(new VrcIrq(_console, this));
 
 		_irq->Reset();
 		_audio->Reset();
@@ -51,10 +51,19 @@ protected:
 		}
 	}
 
+	void RunExpansionAudio() override
+	{
+		_audio->Run();
+	}
+
+	void ClockExpansionAudio() override
+	{
+		_audio->Clock();
+	}
+
 	void ProcessCpuClock() override
 	{
 		_irq->ProcessCpuClock();
-		_audio->Clock();
 	}
 
 	void SetPpuMapping(uint8_t bank, uint8_t page)
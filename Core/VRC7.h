@@ -24,7 +24,7 @@ protected:
 	void InitMapper() override
 	{
 		_audio.reset(new Vrc7Audio(_console));
-		_irq.reset(new VrcIrq(_console));
+		_irq.reset(new VrcIrq(_console, this));
 
 		_irq->Reset();
 		_controlFlags = 0;
@@ -46,10 +46,19 @@ protected:
 		}
 	}
 
+	void RunExpansionAudio() override
+	{
+		_audio->Run();
+	}
+
+	void ClockExpansionAudio() override
+	{
+		_audio->Clock();
+	}
+
 	void ProcessCpuClock() override
 	{
 		_irq->ProcessCpuClock();
-		_audio->Clock();
 	}
 
 	void UpdateState()
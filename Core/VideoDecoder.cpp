@@ -17,6 +17,7 @@
 #include "RotateFilter.h"
 #include "DebugHud.h"
 #include "NotificationManager.h"
+#include "FrameProfiler.h"
 
 VideoDecoder::VideoDecoder(shared_ptr<Console> console)
 {
@@ -95,6 +96,8 @@ void VideoDecoder::UpdateVideoFilter()
 
 void VideoDecoder::DecodeFrame(bool synchronous)
 {
+	PROFILE_SCOPE(_console->GetFrameProfiler(), DecodeFrame);
+
 	UpdateVideoFilter();
 
 	if(_hdFilterEnabled) {
@@ -159,7 +162,7 @@ uint32_t VideoDecoder::GetFrameCount()
 
 void VideoDecoder::UpdateFrameSync(void *ppuOutputBuffer, HdScreenInfo *hdScreenInfo)
 {
-	if(_settings->IsRunAheadFrame()) {
+	if(_settings->IsRunAheadFrame() || _settings->IsHeadlessMode()) {
 		return;
 	}
 
@@ -180,7 +183,13 @@ void VideoDecoder::UpdateFrameSync(void *ppuOutputBuffer, HdScreenInfo *hdScreen
 
 void VideoDecoder::UpdateFrame(void *ppuOutputBuffer, HdScreenInfo *hdScreenInfo)
 {
-	if(_settings->IsRunAheadFrame()) {
+	if(_settings->IsRunAheadFrame() || _settings->IsHeadlessMode()) {
+		return;
+	}
+
+	if(!_decodeThread) {
+		//No decode thread (e.g frames run on the caller's thread by the benchmark), decode the frame right away
+		UpdateFrameSync(ppuOutputBuffer, hdScreenInfo);
 		return;
 	}
 
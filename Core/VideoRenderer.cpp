@@ -113,10 +113,15 @@ void VideoRenderer::AddRecordingSound(int16_t* soundBuffer, uint32_t sampleCount
 void VideoRenderer::StopRecording()
 {
 	shared_ptr<IVideoRecorder> recorder = _recorder;
+	_recorder.reset();
 	if(recorder) {
+		//Wait for the recorder to finish writing the frames that are still queued
+		recorder->StopRecording();
+
+		VideoRecorderStatistics stats = recorder->GetStatistics();
+		MessageManager::Log("[Video Recorder] " + std::to_string(stats.RecordedFrames) + " frames recorded, " + std::to_string(stats.DroppedFrames) + " dropped (max queue depth: " + std::to_string(stats.MaxQueueDepth) + ")");
 		MessageManager::DisplayMessage("VideoRecorder", "VideoRecorderStopped", recorder->GetOutputFile());
 	}
-	_recorder.reset();
 }
 
 bool VideoRenderer::IsRecording()
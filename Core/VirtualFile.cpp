@@ -2,7 +2,8 @@
 #include <algorithm>
 #include <iterator>
 #include "VirtualFile.h"
-#include "../Utilities/sha1.h"
+#include "../Utilities/HashUtilities.h"
+#include "../Utilities/MappedFile.h"
 #include "../Utilities/ArchiveReader.h"
 #include "../Utilities/StringUtilities.h"
 #include "../Utilities/FolderUtilities.h"
@@ -77,7 +78,7 @@ void VirtualFile::FromStream(std::istream & input, vector<uint8_t>& output)
 
 void VirtualFile::LoadFile()
 {
-	if(_data.size() == 0) {
+	if(_data.size() == 0 && !_mappedFile) {
 		if(!_innerFile.empty()) {
 			shared_ptr<ArchiveReader> reader = ArchiveReader::GetReader(_path);
 			if(reader) {
@@ -91,9 +92,15 @@ void VirtualFile::LoadFile()
 				}
 			}
 		} else {
-			ifstream input(_path, std::ios::in | std::ios::binary);
-			if(input.good()) {
-				FromStream(input, _data);
+			//Map the file rather than reading it - the pages are only loaded when the loaders access them
+			shared_ptr<MappedFile> mappedFile(new MappedFile());
+			if(mappedFile->Open(_path)) {
+				_mappedFile = mappedFile;
+			} else {
+				ifstream input(_path, std::ios::in | std::ios::binary);
+				if(input.good()) {
+					FromStream(input, _data);
+				}
 			}
 		}
 	}
@@ -101,7 +108,7 @@ void VirtualFile::LoadFile()
 
 bool VirtualFile::IsValid()
 {
-	if(_data.size() > 0) {
+	if(_data.size() > 0 || _mappedFile) {
 		return true;
 	}
 
@@ -142,17 +149,27 @@ string VirtualFile::GetFileName()
 }
 
 string VirtualFile::GetSha1Hash()
+{
+	return HashUtilities::GetHashes(GetData(), GetSize(), HashType::Sha1Hash).Sha1;
+}
+
+uint8_t* VirtualFile::GetData()
 {
 	LoadFile();
-	return SHA1::GetHash(_data);
+	return _mappedFile ? _mappedFile->GetData() : _data.data();
 }
 
-bool VirtualFile::ReadFile(vector<uint8_t>& out)
+size_t VirtualFile::GetSize()
 {
 	LoadFile();
-	if(_data.size() > 0) {
-		out.resize(_data.size(), 0);
-		std::copy(_data.begin(), _data.end(), out.begin());
+	return _mappedFile ? _mappedFile->GetSize() : _data.size();
+}
+
+bool VirtualFile::ReadFile(vector<uint8_t>& out)
+{
+	size_t size = GetSize();
+	if(size > 0) {
+		out.assign(GetData(), GetData() + size);
 		return true;
 	}
 	return false;
@@ -160,9 +177,9 @@ bool VirtualFile::ReadFile(vector<uint8_t>& out)
 
 bool VirtualFile::ReadFile(std::stringstream & out)
 {
-	LoadFile();
-	if(_data.size() > 0) {
-		out.write((char*)_data.data(), _data.size());
+	size_t size = GetSize();
+	if(size > 0) {
+		out.write((char*)GetData(), size);
 		return true;
 	}
 	return false;
@@ -173,22 +190,27 @@ bool VirtualFile::ApplyPatch(VirtualFile &patch)
 	//Apply patch file
 	bool result = false;
 	if(IsValid() && patch.IsValid()) {
-		patch.LoadFile();
 		LoadFile();
-		if(patch._data.size() >= 5) {
+		uint8_t* patchData = patch.GetData();
+		if(patch.GetSize() >= 5) {
 			vector<uint8_t> patchedData;
 			std::stringstream ss;
 			patch.ReadFile(ss);
 
-			if(memcmp(patch._data.data(), "PATCH", 5) == 0) {
-				result = IpsPatcher::PatchBuffer(ss, _data, patchedData);
-			} else if(memcmp(patch._data.data(), "UPS1", 4) == 0) {
-				result = UpsPatcher::PatchBuffer(ss, _data, patchedData);
-			} else if(memcmp(patch._data.data(), "BPS1", 4) == 0) {
-				result = BpsPatcher::PatchBuffer(ss, _data, patchedData);
+			//The patchers need a copy of the rom, the patched data then replaces the mapped file
+			vector<uint8_t> romData;
+			ReadFile(romData);
+
+			if(memcmp(patchData, "PATCH", 5) == 0) {
+				result = IpsPatcher::PatchBuffer(ss, romData, patchedData);
+			} else if(memcmp(patchData, "UPS1", 4) == 0) {
+				result = UpsPatcher::PatchBuffer(ss, romData, patchedData);
+			} else if(memcmp(patchData, "BPS1", 4) == 0) {
+				result = BpsPatcher::PatchBuffer(ss, romData, patchedData);
 			}
 			if(result) {
-				_data = patchedData;
+				_data = std::move(patchedData);
+				_mappedFile.reset();
 			}
 		}
 	}
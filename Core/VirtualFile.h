@@ -1,6 +1,7 @@
 #pragma once
 #include "stdafx.h"
 #include <sstream>
+class MappedFile;
 
 class VirtualFile
 {
@@ -9,6 +10,7 @@ private:
 	string _innerFile = "";
 	int32_t _innerFileIndex = -1;
 	vector<uint8_t> _data;
+	shared_ptr<MappedFile> _mappedFile;
 
 	void FromStream(std::istream &input, vector<uint8_t> &output);
 
@@ -31,6 +33,10 @@ public:
 	string GetFileName();
 	string GetSha1Hash();
 
+	//Returns the file's content without copying it (files on the disk are memory-mapped), the data must not be modified
+	uint8_t* GetData();
+	size_t GetSize();
+
 	bool ReadFile(vector<uint8_t> &out);
 	bool ReadFile(std::stringstream &out);
 
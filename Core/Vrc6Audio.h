@@ -15,6 +15,8 @@ private:
 protected:
 	void StreamState(bool saving) override
 	{
+		BaseExpansionAudio::StreamState(saving);
+
 		SnapshotInfo pulse1{ &_pulse1 };
 		SnapshotInfo pulse2{ &_pulse2 };
 		SnapshotInfo saw{ &_saw };
@@ -31,7 +33,7 @@ protected:
 		}
 
 		int32_t outputLevel = _pulse1.GetVolume() + _pulse2.GetVolume() + _saw.GetVolume();
-		_console->GetApu()->AddExpansionAudioDelta(AudioChannel::VRC6, outputLevel - _lastOutput);
+		AddAudioDelta(AudioChannel::VRC6, outputLevel - _lastOutput);
 		_lastOutput = outputLevel;
 	}
 
@@ -43,12 +45,14 @@ public:
 
 	void Reset()
 	{
+		Run();
 		_lastOutput = 0;
 		_haltAudio = false;
 	}
 
 	void WriteRegister(uint16_t addr, uint8_t value)
 	{
+		Run();
 		switch(addr) {
 			case 0x9000: case 0x9001: case 0x9002:
 				_pulse1.WriteReg(addr, value);
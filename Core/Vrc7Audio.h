@@ -7,6 +7,8 @@
 class Vrc7Audio : public BaseExpansionAudio
 {
 private:
+	static constexpr uint32_t BlockSize = 256;
+
 	unique_ptr<Vrc7Opll::OpllEmulator> _opllEmulator;
 	uint8_t _currentReg;
 	int16_t _previousOutput;
@@ -14,19 +16,64 @@ private:
 	bool _muted;
 
 protected:
+	double GetClockPeriod()
+	{
+		return ((double)_console->GetCpu()->GetClockRate(_console->GetModel())) / 49716;
+	}
+
 	void ClockAudio() override
 	{
+		//Per-cycle implementation, only used by the APU's expansion audio reference mode (the samples are normally generated in blocks by RunAudio)
 		if(_clockTimer == 0) {
-			_clockTimer = ((double)_console->GetCpu()->GetClockRate(_console->GetModel())) / 49716;
+			_clockTimer = GetClockPeriod();
 		}
 
 		_clockTimer--;
 		if(_clockTimer <= 0) {
-			int16_t output = _opllEmulator->GetOutput();
-			_console->GetApu()->AddExpansionAudioDelta(AudioChannel::VRC7, _muted ? 0 : (output - _previousOutput));
+			int16_t output;
+			_opllEmulator->GetOutput(&output, 1);
+			AddAudioDelta(AudioChannel::VRC7, _muted ? 0 : (output - _previousOutput));
 			_previousOutput = output;
-			_clockTimer = ((double)_console->GetCpu()->GetClockRate(_console->GetModel())) / 49716;
+			_clockTimer = GetClockPeriod();
+		}
+	}
+
+	void RunAudio(uint32_t cycleCount) override
+	{
+		if(_clockTimer == 0) {
+			_clockTimer = GetClockPeriod();
+		}
+
+		//The timer is decremented on every cycle, a sample is output on the cycle it reaches 0 and the timer is reset to a full period
+		uint32_t cyclesToSample = (uint32_t)std::ceil(_clockTimer);
+		if(cyclesToSample > cycleCount) {
+			_clockTimer -= cycleCount;
+			AdvanceCycle(cycleCount);
+			return;
+		}
+
+		double period = GetClockPeriod();
+		uint32_t samplePeriod = (uint32_t)std::ceil(period);
+		uint32_t sampleCount = (cycleCount - cyclesToSample) / samplePeriod + 1;
+		uint32_t remainingCycles = cycleCount - cyclesToSample - (sampleCount - 1) * samplePeriod;
+
+		AdvanceCycle(cyclesToSample - 1);
+		for(uint32_t i = 0; i < sampleCount; i += Vrc7Audio::BlockSize) {
+			int16_t samples[Vrc7Audio::BlockSize];
+			uint32_t blockSize = std::min(sampleCount - i, Vrc7Audio::BlockSize);
+			_opllEmulator->GetOutput(samples, blockSize);
+
+			for(uint32_t j = 0; j < blockSize; j++) {
+				if(i + j > 0) {
+					AdvanceCycle(samplePeriod);
+				}
+				AddAudioDelta(AudioChannel::VRC7, _muted ? 0 : (samples[j] - _previousOutput));
+				_previousOutput = samples[j];
+			}
 		}
+		AdvanceCycle(remainingCycles + 1);
+
+		_clockTimer = period - remainingCycles;
 	}
 
 	void StreamState(bool saving) override
@@ -49,11 +96,13 @@ public:
 
 	void SetMuteAudio(bool muted)
 	{
+		Run();
 		_muted = muted;
 	}
 
 	void WriteReg(uint16_t addr, uint8_t value)
 	{
+		Run();
 		switch(addr & 0xF030) {
 			case 0x9010:
 				_currentReg = value;
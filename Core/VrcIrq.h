@@ -1,11 +1,13 @@
 #pragma once
 #include "Snapshotable.h"
 #include "CPU.h"
+#include "BaseMapper.h"
 
 class VrcIrq : public Snapshotable
 {
 private:
 	shared_ptr<Console> _console;
+	BaseMapper* _mapper;
 	uint8_t _irqReloadValue;
 	uint8_t _irqCounter;
 	int16_t _irqPrescalerCounter;
@@ -13,6 +15,82 @@ private:
 	bool _irqEnabledAfterAck;
 	bool _irqCycleMode;
 
+	//Runs the prescaler until it clocks the counter (returns true) or until all the cycles have been run
+	bool RunPrescaler(int16_t &prescaler, uint32_t &cycles)
+	{
+		while(cycles > 0) {
+			if(prescaler > 3) {
+				//The counter can't be clocked during the next (prescaler - 1) / 3 cycles
+				uint32_t count = std::min<uint32_t>((prescaler - 1) / 3, cycles);
+				prescaler -= count * 3;
+				cycles -= count;
+			} else {
+				prescaler -= 3;
+				cycles--;
+				if(prescaler <= 0) {
+					prescaler += 341;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void ClockCounter(uint32_t count)
+	{
+		while(count > 0) {
+			uint32_t clocksToIrq = 0x100 - _irqCounter;
+			if(count < clocksToIrq) {
+				_irqCounter += count;
+				return;
+			}
+
+			count -= clocksToIrq;
+			_irqCounter = _irqReloadValue;
+			_console->GetCpu()->SetIrqSource(IRQSource::External);
+		}
+	}
+
+	void Run(uint32_t cycles)
+	{
+		if(!_irqEnabled) {
+			return;
+		}
+
+		if(_irqCycleMode) {
+			//The prescaler also runs in cycle mode (-3 and +341 on every cycle), its value is kept if an ack re-enables the IRQ in scanline mode
+			_irqPrescalerCounter = (int16_t)(uint16_t)((uint16_t)_irqPrescalerCounter + 338 * cycles);
+			ClockCounter(cycles);
+		} else {
+			while(cycles > 0) {
+				if(RunPrescaler(_irqPrescalerCounter, cycles)) {
+					ClockCounter(1);
+				}
+			}
+		}
+	}
+
+	uint32_t GetCyclesUntilIrq()
+	{
+		if(!_irqEnabled) {
+			return 0;
+		}
+
+		uint32_t clocksToIrq = 0x100 - _irqCounter;
+		if(_irqCycleMode) {
+			return clocksToIrq;
+		}
+
+		int16_t prescaler = _irqPrescalerCounter;
+		uint32_t cyclesToIrq = 0;
+		for(uint32_t i = 0; i < clocksToIrq; i++) {
+			uint32_t cycles = UINT32_MAX;
+			RunPrescaler(prescaler, cycles);
+			cyclesToIrq += UINT32_MAX - cycles;
+		}
+		return cyclesToIrq;
+	}
+
 protected:
 	void StreamState(bool saving) override
 	{
@@ -20,9 +98,11 @@ protected:
 	}
 
 public:
-	VrcIrq(shared_ptr<Console> console)
+	VrcIrq(shared_ptr<Console> console, BaseMapper* mapper)
 	{
 		_console = console;
+		_mapper = mapper;
+		Reset();
 	}
 
 	void Reset()
@@ -35,21 +115,11 @@ public:
 		_irqCycleMode = false;
 	}
 
+	//Called by the mapper's ProcessCpuClock: runs the cycles that elapsed since the last call and schedules the next call on the cycle the next IRQ occurs
 	void ProcessCpuClock()
 	{
-		if(_irqEnabled) {
-			_irqPrescalerCounter -= 3;
-
-			if(_irqCycleMode || (_irqPrescalerCounter <= 0 && !_irqCycleMode)) {
-				if(_irqCounter == 0xFF) {
-					_irqCounter = _irqReloadValue;
-					_console->GetCpu()->SetIrqSource(IRQSource::External);
-				} else {
-					_irqCounter++;
-				}
-				_irqPrescalerCounter += 341;
-			}
-		}
+		Run(_mapper->TakePendingCpuClocks());
+		_mapper->SetCpuClockPeriod(GetCyclesUntilIrq());
 	}
 
 	void SetReloadValue(uint8_t value)
@@ -68,6 +138,9 @@ public:
 
 	void SetControlValue(uint8_t value)
 	{
+		//Catch up to the current cycle before the write, and reschedule the next IRQ after it
+		_mapper->ProcessCpuClock();
+
 		_irqEnabledAfterAck = (value & 0x01) == 0x01;
 		_irqEnabled = (value & 0x02) == 0x02;
 		_irqCycleMode = (value & 0x04) == 0x04;
@@ -78,11 +151,14 @@ public:
 		}
 
 		_console->GetCpu()->ClearIrqSource(IRQSource::External);
+		_mapper->ProcessCpuClock();
 	}
 
 	void AcknowledgeIrq()
 	{
+		_mapper->ProcessCpuClock();
 		_irqEnabled = _irqEnabledAfterAck;
 		_console->GetCpu()->ClearIrqSource(IRQSource::External);
+		_mapper->ProcessCpuClock();
 	}
 };
\ No newline at end of file
@@ -14,7 +14,7 @@ protected:
 
 	void InitMapper() override
 	{
-		_irq.reset(new VrcIrq(_console));
+		_irq.reset(new VrcIrq(_console, this));
 
 		memset(_chrRegs, 0, sizeof(_chrRegs));
 
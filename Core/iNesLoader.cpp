@@ -1,16 +1,16 @@
 #include "stdafx.h"
 #include "iNesLoader.h"
 #include "../Utilities/CRC32.h"
-#include "../Utilities/md5.h"
+#include "../Utilities/HashUtilities.h"
 #include "../Utilities/HexUtilities.h"
 #include "GameDatabase.h"
 #include "EmulationSettings.h"
 
-void iNesLoader::LoadRom(RomData& romData, vector<uint8_t>& romFile, NESHeader *preloadedHeader)
+void iNesLoader::LoadRom(RomData& romData, uint8_t* romFile, size_t romSize, NESHeader *preloadedHeader)
 {
 	NESHeader header;
-	uint8_t* buffer = romFile.data();
-	uint32_t dataSize = (uint32_t)romFile.size();
+	uint8_t* buffer = romFile;
+	uint32_t dataSize = (uint32_t)romSize;
 	if(preloadedHeader) {
 		header = *preloadedHeader;
 	} else {
@@ -54,11 +54,12 @@ void iNesLoader::LoadRom(RomData& romData, vector<uint8_t>& romFile, NESHeader *
 		}
 	}
 
-	size_t bytesRead = buffer - romFile.data();
+	size_t bytesRead = buffer - romFile;
 
-	uint32_t romCrc = CRC32::GetCRC(buffer, romFile.size() - bytesRead);
+	HashValues hashes = HashUtilities::GetHashes(buffer, romSize - bytesRead, HashType::Crc32Hash | HashType::Md5Hash);
+	uint32_t romCrc = hashes.Crc32;
 	romData.Info.Hash.PrgChrCrc32 = romCrc;
-	romData.Info.Hash.PrgChrMd5 = GetMd5Sum(buffer, romFile.size() - bytesRead);
+	romData.Info.Hash.PrgChrMd5 = hashes.Md5;
 
 	uint32_t prgSize = 0;
 	uint32_t chrSize = 0;
@@ -8,5 +8,5 @@ class iNesLoader : public BaseLoader
 public:
 	using BaseLoader::BaseLoader;
 
-	void LoadRom(RomData& romData, vector<uint8_t>& romFile, NESHeader *preloadedHeader);
+	void LoadRom(RomData& romData, uint8_t* romFile, size_t romSize, NESHeader *preloadedHeader);
 };
\ No newline at end of file
@@ -12,5 +12,12 @@ namespace Mesen.GUI.Config
 		public UInt16 Port = 8888;
 		public string Password = "";
 		public bool Spectator = false;
+
+		//0 = delay-based netplay, otherwise max number of frames that can be predicted and rolled back
+		[MinMax(0, 15)] public UInt32 RollbackFrames = 0;
+
+		//Used to test netplay over loopback
+		public UInt32 SimulatedLatency = 0;
+		[MinMax(0, 100)] public UInt32 SimulatedPacketLoss = 0;
 	}
 }
@@ -11,5 +11,8 @@ namespace Mesen.GUI.Config
 		public string Name = "Default";
 		public UInt16 Port = 8888;
 		public string Password = "";
+
+		//Number of frames of input buffered before being sent to spectators (higher values reduce the server's network overhead)
+		[MinMax(1, 60)] public UInt32 SpectatorBufferSize = 1;
 	}
 }
@@ -157,6 +157,7 @@ namespace Mesen.GUI.Forms
 			this.mnuNetPlayPlayer5 = new System.Windows.Forms.ToolStripMenuItem();
 			this.toolStripMenuItem3 = new System.Windows.Forms.ToolStripSeparator();
 			this.mnuNetPlaySpectator = new System.Windows.Forms.ToolStripMenuItem();
+			this.mnuNetPlayStatistics = new System.Windows.Forms.ToolStripMenuItem();
 			this.toolStripMenuItem2 = new System.Windows.Forms.ToolStripSeparator();
 			this.mnuFindServer = new System.Windows.Forms.ToolStripMenuItem();
 			this.mnuProfile = new System.Windows.Forms.ToolStripMenuItem();
@@ -1202,6 +1203,7 @@ namespace Mesen.GUI.Forms
             this.mnuStartServer,
             this.mnuConnect,
             this.mnuNetPlaySelectController,
+            this.mnuNetPlayStatistics,
             this.toolStripMenuItem2,
             this.mnuFindServer,
             this.mnuProfile});
@@ -1209,6 +1211,7 @@ namespace Mesen.GUI.Forms
 			this.mnuNetPlay.Name = "mnuNetPlay";
 			this.mnuNetPlay.Size = new System.Drawing.Size(182, 22);
 			this.mnuNetPlay.Text = "Net Play";
+			this.mnuNetPlay.DropDownOpening += new System.EventHandler(this.mnuNetPlay_DropDownOpening);
 			// 
 			// mnuStartServer
 			// 
@@ -1285,6 +1288,14 @@ namespace Mesen.GUI.Forms
 			this.mnuNetPlaySpectator.Text = "Spectator";
 			this.mnuNetPlaySpectator.Click += new System.EventHandler(this.mnuNetPlaySpectator_Click);
 			// 
+			// mnuNetPlayStatistics
+			// 
+			this.mnuNetPlayStatistics.Enabled = false;
+			this.mnuNetPlayStatistics.Name = "mnuNetPlayStatistics";
+			this.mnuNetPlayStatistics.Size = new System.Drawing.Size(177, 22);
+			this.mnuNetPlayStatistics.Text = "Statistics";
+			this.mnuNetPlayStatistics.Visible = false;
+			// 
 			// toolStripMenuItem2
 			// 
 			this.toolStripMenuItem2.Name = "toolStripMenuItem2";
@@ -1927,6 +1938,7 @@ namespace Mesen.GUI.Forms
 		private System.Windows.Forms.ToolStripMenuItem mnuNetPlayPlayer4;
 		private System.Windows.Forms.ToolStripSeparator toolStripMenuItem3;
 		private System.Windows.Forms.ToolStripMenuItem mnuNetPlaySpectator;
+		private System.Windows.Forms.ToolStripMenuItem mnuNetPlayStatistics;
 		private System.Windows.Forms.Panel panelRenderer;
 		private System.Windows.Forms.ToolStripSeparator toolStripMenuItem13;
 		private System.Windows.Forms.ToolStripSeparator toolStripMenuItem14;
@@ -291,7 +291,7 @@ namespace Mesen.GUI.Forms
 			} else {
 				using(frmServerConfig frm = new frmServerConfig()) {
 					if(frm.ShowDialog(sender, this) == System.Windows.Forms.DialogResult.OK) {
-						InteropEmu.StartServer(ConfigManager.Config.ServerInfo.Port, ConfigManager.Config.ServerInfo.Password, ConfigManager.Config.Profile.PlayerName);
+						InteropEmu.StartServer(ConfigManager.Config.ServerInfo.Port, ConfigManager.Config.ServerInfo.Password, ConfigManager.Config.Profile.PlayerName, ConfigManager.Config.ServerInfo.SpectatorBufferSize);
 					}
 				}
 			}
@@ -310,7 +310,10 @@ namespace Mesen.GUI.Forms
 								ConfigManager.Config.ClientConnectionInfo.Port,
 								ConfigManager.Config.ClientConnectionInfo.Password,
 								ConfigManager.Config.Profile.PlayerName,
-								ConfigManager.Config.ClientConnectionInfo.Spectator
+								ConfigManager.Config.ClientConnectionInfo.Spectator,
+								ConfigManager.Config.ClientConnectionInfo.RollbackFrames,
+								ConfigManager.Config.ClientConnectionInfo.SimulatedLatency,
+								ConfigManager.Config.ClientConnectionInfo.SimulatedPacketLoss
 							);
 						});
 					}
@@ -325,6 +328,18 @@ namespace Mesen.GUI.Forms
 			}
 		}
 
+		private void mnuNetPlay_DropDownOpening(object sender, EventArgs e)
+		{
+			//Data sent/received on the wire (including save states) since the server was started or the client connected
+			bool netPlay = InteropEmu.IsServerRunning() || InteropEmu.IsConnected();
+			mnuNetPlayStatistics.Visible = netPlay;
+			if(netPlay) {
+				InteropEmu.NetPlayStatistics stats;
+				InteropEmu.NetPlayGetStatistics(out stats);
+				mnuNetPlayStatistics.Text = ResourceHelper.GetMessage("NetPlayStatistics", stats.BytesSent / 1024, stats.BytesReceived / 1024, stats.StateCount, stats.DeltaStateCount);
+			}
+		}
+
 		private void mnuNetPlayPlayer1_Click(object sender, EventArgs e)
 		{
 			InteropEmu.NetPlaySelectController(0);
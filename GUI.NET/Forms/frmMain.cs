@@ -711,6 +711,12 @@ namespace Mesen.GUI.Forms
 					InitializeNsfMode();
 					break;
 
+				case InteropEmu.ConsoleNotificationType.StateSaved:
+					//Save states are written by a background thread, refresh the slot dates once the file is written
+					UpdateStateMenu(mnuSaveState, true);
+					UpdateStateMenu(mnuLoadState, false);
+					break;
+
 				case InteropEmu.ConsoleNotificationType.DisconnectedFromServer:
 					this.BeginInvoke((MethodInvoker)(() => {
 						ConfigManager.Config.ApplyConfig();
@@ -100,10 +100,10 @@ namespace Mesen.GUI
 		[DllImport(DLLPath)] public static extern void Reset();
 		[DllImport(DLLPath)] public static extern void ResetLagCounter();
 
-		[DllImport(DLLPath)] public static extern void StartServer(UInt16 port, [MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string password, [MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string hostPlayerName);
+		[DllImport(DLLPath)] public static extern void StartServer(UInt16 port, [MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string password, [MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string hostPlayerName, UInt32 spectatorBufferSize);
 		[DllImport(DLLPath)] public static extern void StopServer();
 		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool IsServerRunning();
-		[DllImport(DLLPath)] public static extern void Connect([MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string host, UInt16 port, [MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string password, [MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string playerName, [MarshalAs(UnmanagedType.I1)]bool spectator);
+		[DllImport(DLLPath)] public static extern void Connect([MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string host, UInt16 port, [MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string password, [MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string playerName, [MarshalAs(UnmanagedType.I1)]bool spectator, UInt32 rollbackFrames, UInt32 simulatedLatency, UInt32 simulatedPacketLoss);
 		[DllImport(DLLPath)] public static extern void Disconnect();
 		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool IsConnected();
 
@@ -111,6 +111,7 @@ namespace Mesen.GUI
 		[DllImport(DLLPath)] public static extern void NetPlaySelectController(Int32 controllerPort);
 		[DllImport(DLLPath)] public static extern ControllerType NetPlayGetControllerType(Int32 controllerPort);
 		[DllImport(DLLPath)] public static extern Int32 NetPlayGetControllerPort();
+		[DllImport(DLLPath)] public static extern void NetPlayGetStatistics(out NetPlayStatistics stats);
 
 		[DllImport(DLLPath)] public static extern void TakeScreenshot();
 
@@ -126,6 +127,7 @@ namespace Mesen.GUI
 		[DllImport(DLLPath)] public static extern void MovieStop();
 		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool MoviePlaying();
 		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool MovieRecording();
+		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool MovieSeek(UInt32 frame);
 
 		[DllImport(DLLPath)] public static extern void AviRecord([MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string filename, VideoCodec codec, UInt32 compressionLevel);
 		[DllImport(DLLPath)] public static extern void AviStop();
@@ -191,6 +193,15 @@ namespace Mesen.GUI
 		[DllImport(DLLPath)] public static extern void StopRecordingTapeFile();
 		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool IsRecordingTapeFile();
 
+		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool StartStateChecksumLog([MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string filepath);
+		[DllImport(DLLPath)] public static extern void StopStateChecksumLog();
+		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool IsStateChecksumLogRunning();
+		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool CompareStateChecksumLogs([MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string filepathA, [MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string filepathB, out StateChecksumDiff diff);
+
+		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool StartProfilerTrace([MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(UTF8Marshaler))]string filepath);
+		[DllImport(DLLPath)] public static extern void StopProfilerTrace();
+		[DllImport(DLLPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool IsProfilerTraceRunning();
+
 		[DllImport(DLLPath)] public static extern void SetCheats([MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 1)]InteropCheatInfo[] cheats, UInt32 length);
 
 		[DllImport(DLLPath)] public static extern void SetOsdState([MarshalAs(UnmanagedType.I1)]bool enabled);
@@ -951,7 +962,8 @@ namespace Mesen.GUI
 			BeforeEmulationStop = 19,
 			VsDualSystemStarted = 20,
 			VsDualSystemStopped = 21,
-			GameInitCompleted = 22
+			GameInitCompleted = 22,
+			StateSaved = 23
 		}
 
 		public enum ControllerType
@@ -1100,6 +1112,29 @@ namespace Mesen.GUI
 			public Int32 CrossFeedRatio;
 		}
 
+		public struct NetPlayStatistics
+		{
+			public UInt64 BytesSent;
+			public UInt64 BytesReceived;
+
+			public UInt32 StateCount;
+			public UInt32 DeltaStateCount;
+			public UInt64 StateBytes;
+			public UInt32 LastStateSize;
+			public UInt32 LastStateCompressedSize;
+
+			public double JoinTime;
+		}
+
+		public struct StateChecksumDiff
+		{
+			[MarshalAs(UnmanagedType.I1)] public bool Diverged;
+			public UInt32 Segment;
+			public UInt32 Frame;
+			public UInt32 ComponentMask;
+			public UInt32 ComparedFrames;
+		}
+
 		public struct ScreenSize
 		{
 			public Int32 Width;
@@ -2160,7 +2195,7 @@ namespace Mesen.GUI
 		private const int DescriptionMaxSize = 10000;
 		private const int FilenameMaxSize = 2000;
 
-		public RecordMovieOptions(string filename, string author, string description, RecordMovieFrom recordFrom)
+		public RecordMovieOptions(string filename, string author, string description, RecordMovieFrom recordFrom, UInt32 keyframeInterval = 10)
 		{
 			Author = Encoding.UTF8.GetBytes(author);
 			Array.Resize(ref Author, AuthorMaxSize);
@@ -2175,6 +2210,7 @@ namespace Mesen.GUI
 			Filename[FilenameMaxSize-1] = 0;
 
 			RecordFrom = recordFrom;
+			KeyframeInterval = keyframeInterval;
 		}
 
 		[MarshalAs(UnmanagedType.ByValArray, SizeConst = FilenameMaxSize)]
@@ -2187,6 +2223,7 @@ namespace Mesen.GUI
 		public byte[] Description;
 
 		public RecordMovieFrom RecordFrom;
+		public UInt32 KeyframeInterval;
 	}
 	
 	public struct EventViewerDisplayOptions
@@ -32,6 +32,10 @@
 #include "../Core/KeyManager.h"
 #include "../Core/GameDatabase.h"
 #include "../Core/RewindManager.h"
+#include "../Core/StateChecksumLog.h"
+#include "../Core/ControlDeviceState.h"
+#include "../Core/PPU.h"
+#include "../Core/MemoryManager.h"
 #include "../Utilities/SimpleLock.h"
 
 #ifdef _WIN32
@@ -377,6 +381,18 @@ namespace InteropEmu {
 			}
 		}
 
+		//Headless mode (bulk simulation): frames are run on the caller's thread, instead of calling Run()
+		DllExport bool __stdcall HeadlessRunFrames(uint32_t frameCount) { return _console->RunHeadlessFrames(frameCount); }
+		DllExport void __stdcall HeadlessSetInput(uint32_t port, uint8_t* state, uint32_t stateSize)
+		{
+			ControlDeviceState deviceState;
+			deviceState.State.insert(deviceState.State.end(), state, state + stateSize);
+			_console->SetHeadlessInput((uint8_t)port, deviceState);
+		}
+		//PPU output: 256x240 palette indexes (including the emphasis bits), RAM: the 2 KB of internal RAM
+		DllExport void __stdcall HeadlessGetPpuOutput(uint16_t* buffer) { _console->GetPpu()->DebugCopyOutputBuffer(buffer); }
+		DllExport void __stdcall HeadlessGetInternalRam(uint8_t* buffer) { memcpy(buffer, _console->GetMemoryManager()->GetInternalRAM(), MemoryManager::InternalRAMSize); }
+
 		DllExport void __stdcall Resume(ConsoleId consoleId) { GetConsoleById(consoleId)->GetSettings()->ClearFlags(EmulationFlags::Paused); }
 		DllExport bool __stdcall IsPaused(ConsoleId consoleId) { return GetConsoleById(consoleId)->GetSettings()->CheckFlag(EmulationFlags::Paused); }
 		DllExport void __stdcall Pause(ConsoleId consoleId)
@@ -449,13 +465,16 @@ namespace InteropEmu {
 		DllExport void __stdcall ReloadRom() { _console->ReloadRom(); }
 		DllExport void __stdcall ResetLagCounter() { _console->ResetLagCounter(); }
 
-		DllExport void __stdcall StartServer(uint16_t port, char* password, char* hostPlayerName) { GameServer::StartServer(_console, port, password, hostPlayerName); }
+		DllExport void __stdcall StartServer(uint16_t port, char* password, char* hostPlayerName, uint32_t spectatorBufferSize) { GameServer::StartServer(_console, port, password, hostPlayerName, spectatorBufferSize); }
 		DllExport void __stdcall StopServer() { GameServer::StopServer(); }
 		DllExport bool __stdcall IsServerRunning() { return GameServer::Started(); }
 
-		DllExport void __stdcall Connect(char* host, uint16_t port, char* password, char* playerName, bool spectator)
+		DllExport void __stdcall Connect(char* host, uint16_t port, char* password, char* playerName, bool spectator, uint32_t rollbackFrames, uint32_t simulatedLatency, uint32_t simulatedPacketLoss)
 		{
 			ClientConnectionData connectionData(host, port, password, playerName, spectator);
+			connectionData.RollbackFrames = rollbackFrames;
+			connectionData.SimulatedLatency = simulatedLatency;
+			connectionData.SimulatedPacketLoss = simulatedPacketLoss;
 			GameClient::Connect(_console, connectionData);
 		}
 
@@ -490,6 +509,15 @@ namespace InteropEmu {
 			}
 		}
 
+		DllExport void __stdcall NetPlayGetStatistics(NetPlayStatistics &stats)
+		{
+			if(GameServer::Started()) {
+				stats = GameServer::GetStatistics();
+			} else {
+				stats = GameClient::GetStatistics();
+			}
+		}
+
 		DllExport void __stdcall Release()
 		{
 			ReleaseDualSystemAudioVideo();
@@ -562,6 +590,7 @@ namespace InteropEmu {
 		DllExport void __stdcall MovieStop() { MovieManager::Stop(); }
 		DllExport bool __stdcall MoviePlaying() { return MovieManager::Playing(); }
 		DllExport bool __stdcall MovieRecording() { return MovieManager::Recording(); }
+		DllExport bool __stdcall MovieSeek(uint32_t frame) { return MovieManager::SeekTo(frame); }
 
 		DllExport void __stdcall AviRecord(char* filename, VideoCodec codec, uint32_t compressionLevel) { _console->GetVideoRenderer()->StartRecording(filename, codec, compressionLevel); }
 		DllExport void __stdcall AviStop() { _console->GetVideoRenderer()->StopRecording(); }
@@ -574,7 +603,7 @@ namespace InteropEmu {
 		DllExport int32_t __stdcall RunRecordedTest(char* filename)
 		{
 			_recordedRomTest.reset(new RecordedRomTest(_console));
-			_console->GetNotificationManager()->RegisterNotificationListener(_recordedRomTest);
+			_console->GetNotificationManager()->RegisterNotificationListener(_recordedRomTest, { ConsoleNotificationType::PpuFrameDone, ConsoleNotificationType::MovieEnded });
 			return _recordedRomTest->Run(filename);
 		}
 
@@ -587,21 +616,21 @@ namespace InteropEmu {
 		DllExport void __stdcall RomTestRecord(char* filename, bool reset) 
 		{
 			_recordedRomTest.reset(new RecordedRomTest(_console));
-			_console->GetNotificationManager()->RegisterNotificationListener(_recordedRomTest);
+			_console->GetNotificationManager()->RegisterNotificationListener(_recordedRomTest, { ConsoleNotificationType::PpuFrameDone, ConsoleNotificationType::MovieEnded });
 			_recordedRomTest->Record(filename, reset);
 		}
 
 		DllExport void __stdcall RomTestRecordFromMovie(char* testFilename, char* movieFilename) 
 		{
 			_recordedRomTest.reset(new RecordedRomTest(_console));
-			_console->GetNotificationManager()->RegisterNotificationListener(_recordedRomTest);
+			_console->GetNotificationManager()->RegisterNotificationListener(_recordedRomTest, { ConsoleNotificationType::PpuFrameDone, ConsoleNotificationType::MovieEnded });
 			_recordedRomTest->RecordFromMovie(testFilename, string(movieFilename));
 		}
 
 		DllExport void __stdcall RomTestRecordFromTest(char* newTestFilename, char* existingTestFilename) 
 		{
 			_recordedRomTest.reset(new RecordedRomTest(_console));
-			_console->GetNotificationManager()->RegisterNotificationListener(_recordedRomTest);
+			_console->GetNotificationManager()->RegisterNotificationListener(_recordedRomTest, { ConsoleNotificationType::PpuFrameDone, ConsoleNotificationType::MovieEnded });
 			_recordedRomTest->RecordFromTest(newTestFilename, existingTestFilename);
 		}
 
@@ -682,6 +711,15 @@ namespace InteropEmu {
 		DllExport void __stdcall StopRecordingTapeFile() { _console->StopRecordingTapeFile(); }
 		DllExport bool __stdcall IsRecordingTapeFile() { return _console->IsRecordingTapeFile(); }
 
+		DllExport bool __stdcall StartStateChecksumLog(char *filepath) { return _console->StartStateChecksumLog(filepath); }
+		DllExport void __stdcall StopStateChecksumLog() { _console->StopStateChecksumLog(); }
+		DllExport bool __stdcall IsStateChecksumLogRunning() { return _console->IsStateChecksumLogRunning(); }
+		DllExport bool __stdcall CompareStateChecksumLogs(char *filepathA, char *filepathB, StateChecksumDiff &diff) { return StateChecksumLog::Compare(filepathA, filepathB, diff); }
+
+		DllExport bool __stdcall StartProfilerTrace(char *filepath) { return _console->StartProfilerTrace(filepath); }
+		DllExport void __stdcall StopProfilerTrace() { _console->StopProfilerTrace(); }
+		DllExport bool __stdcall IsProfilerTraceRunning() { return _console->IsProfilerTraceRunning(); }
+
 		DllExport bool __stdcall IsKeyboardMode() { return _settings->IsKeyboardMode(); }
 
 		DllExport ConsoleFeatures __stdcall GetAvailableFeatures() { return _console->GetAvailableFeatures(); }
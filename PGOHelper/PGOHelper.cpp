@@ -2,6 +2,7 @@
 #include <string>
 #include <algorithm>
 #include <unordered_set>
+#include <sstream>
 #if __has_include(<filesystem>)
 	#include <filesystem>
 	namespace fs = std::filesystem;
@@ -38,13 +39,35 @@ vector<string> GetFilesInFolder(string rootFolder, std::unordered_set<string> ex
 
 int main(int argc, char* argv[])
 {
+	//Usage: pgohelper [romFolder] [-frames <count>] [-modes <mode1,mode2,...>] [-output <file.json>]
+	//       pgohelper -genroms <folder> (writes the test roms for the mapperirq mode)
 	string romFolder = "../PGOGames";
-	if(argc >= 2) {
-		romFolder = argv[1];
+	string outputFile;
+	uint32_t frameCount = 600;
+	vector<string> modes;
+
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if(arg == "-frames" && i + 1 < argc) {
+			frameCount = (uint32_t)std::stoul(argv[++i]);
+		} else if(arg == "-modes" && i + 1 < argc) {
+			std::stringstream modeList(argv[++i]);
+			string mode;
+			while(std::getline(modeList, mode, ',')) {
+				modes.push_back(mode);
+			}
+		} else if(arg == "-output" && i + 1 < argc) {
+			outputFile = argv[++i];
+		} else if(arg == "-genroms" && i + 1 < argc) {
+			PgoGenerateMapperTestRoms(argv[++i]);
+			return 0;
+		} else {
+			romFolder = arg;
+		}
 	}
 
 	vector<string> testRoms = GetFilesInFolder(romFolder, { {".nes"} });
-	PgoRunTest(testRoms, true);
+	std::sort(testRoms.begin(), testRoms.end());
+	PgoRunBenchmark(testRoms, modes, frameCount, outputFile);
 	return 0;
 }
-
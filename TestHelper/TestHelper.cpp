@@ -24,6 +24,19 @@
 #include "../Core/MessageManager.h"
 #include "../Core/ControlManager.h"
 #include "../Core/EmulationSettings.h"
+#include "../Core/GameConnection.h"
+#include "../Core/HandShakeMessage.h"
+#include "../Core/ServerInformationMessage.h"
+#include "../Core/SaveStateMessage.h"
+#include "../Core/SaveStateAckMessage.h"
+#include "../Utilities/Socket.h"
+#include "../Utilities/ZmbvCodec.h"
+#include "../Utilities/HashUtilities.h"
+#include "../Utilities/CRC32.h"
+#include "../Utilities/sha1.h"
+#include "../Utilities/md5.h"
+#include "../Core/PPU.h"
+#include "../Core/StateChecksumLog.h"
 
 using namespace std;
 
@@ -38,6 +51,11 @@ extern "C" {
 	int __stdcall RunRecordedTest(char* filename);
 	void __stdcall Run();
 	void __stdcall Stop();
+	void __stdcall LoadROM(char* filename, char* patchFile);
+	void __stdcall Reset();
+	void __stdcall StartServer(uint16_t port, char* password, char* hostPlayerName, uint32_t spectatorBufferSize);
+	bool __stdcall IsServerRunning();
+	void __stdcall NetPlayGetStatistics(NetPlayStatistics &stats);
 	INotificationListener* __stdcall RegisterNotificationCallback(int32_t consoleId, NotificationListenerCallback callback);
 }
 
@@ -74,9 +92,9 @@ void __stdcall OnNotificationReceived(int type, void* parameter)
 void RunTest()
 {
 	while(true) {
-		lock.Acquire();
+		::lock.Acquire();
 		size_t index = testIndex++;
-		lock.Release();
+		::lock.Release();
 
 		if(index < testFilenames.size()) {
 			string filepath = testFilenames[index];
@@ -97,9 +115,9 @@ void RunTest()
 				#endif
 			}
 
-			lock.Acquire();
+			::lock.Acquire();
 			std::cout << std::to_string(index) << ") " << filename << std::endl;
-			lock.Release();
+			::lock.Release();
 
 			int failedFrames = std::system(command.c_str());
 			#ifdef __GNUC__
@@ -108,11 +126,11 @@ void RunTest()
 
 			if(failedFrames != 0) {
 				//Test failed
-				lock.Acquire();
+				::lock.Acquire();
 				failedTests.push_back(filename);
 				failedTestErrorCode.push_back(failedFrames);
 				std::cout << "  ****  " << std::to_string(index) << ") " << filename << " failed (" << failedFrames << ")" << std::endl;
-				lock.Release();
+				::lock.Release();
 			}
 		} else {
 			break;
@@ -120,6 +138,444 @@ void RunTest()
 	}
 }
 
+//Minimal netplay client used by the load test - connects as a spectator and counts the input it receives, without emulating anything
+class LoadTestConnection : public GameConnection
+{
+private:
+	string _playerName;
+
+	void ProcessMessage(NetMessage* message) override
+	{
+		switch(message->GetType()) {
+			case MessageType::ServerInformation: {
+				HandShakeMessage handshake(_playerName, HandShakeMessage::GetPasswordHash("", ((ServerInformationMessage*)message)->GetHashSalt()), true);
+				SendNetMessage(handshake);
+				break;
+			}
+
+			case MessageType::SaveState: {
+				//Acknowledge the state like a real client would, so the server sends deltas afterwards
+				StateCount++;
+				SaveStateAckMessage ack(((SaveStateMessage*)message)->GetStateId());
+				SendNetMessage(ack);
+				break;
+			}
+
+			case MessageType::MovieData:
+				InputCount++;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+public:
+	uint32_t StateCount = 0;
+	uint32_t InputCount = 0;
+
+	LoadTestConnection(shared_ptr<Socket> socket, string playerName) : GameConnection(nullptr, socket)
+	{
+		_playerName = playerName;
+	}
+};
+
+int RunNetPlayLoadTest(char* romFilename, string mesenFolder, int clientCount, int duration)
+{
+	const uint16_t port = 8889;
+
+	InitDll();
+	SetFlags(0x8000000000000000); //EmulationFlags::ConsoleMode
+	InitializeEmu(mesenFolder.c_str(), nullptr, nullptr, true, true, true);
+	SetControllerType(0, ControllerType::StandardController);
+	SetControllerType(1, ControllerType::StandardController);
+	LoadROM(romFilename, (char*)"");
+	StartServer(port, (char*)"", (char*)"Host", 1);
+	runThread = new std::thread(RunEmu);
+
+	while(!IsServerRunning()) {
+		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(10));
+	}
+
+	vector<shared_ptr<LoadTestConnection>> clients;
+	for(int i = 0; i < clientCount; i++) {
+		shared_ptr<Socket> socket(new Socket());
+		if(socket->Connect("127.0.0.1", port)) {
+			clients.push_back(shared_ptr<LoadTestConnection>(new LoadTestConnection(socket, "Spectator " + std::to_string(i + 1))));
+		}
+	}
+	std::cout << "Connected " << clients.size() << "/" << clientCount << " spectators" << std::endl;
+
+	timer.Reset();
+	vector<Socket*> sockets;
+	vector<LoadTestConnection*> activeClients;
+	vector<bool> readable;
+	while(timer.GetElapsedMS() < duration * 1000) {
+		sockets.clear();
+		activeClients.clear();
+		for(shared_ptr<LoadTestConnection> &client : clients) {
+			if(!client->ConnectionError()) {
+				sockets.push_back(client->GetSocket());
+				activeClients.push_back(client.get());
+			}
+		}
+
+		if(sockets.empty()) {
+			break;
+		}
+
+		Socket::Poll(sockets, readable, 50);
+		for(size_t i = 0; i < activeClients.size(); i++) {
+			if(readable[i]) {
+				activeClients[i]->ProcessMessages();
+			}
+		}
+	}
+
+	NetPlayStatistics serverStats;
+	NetPlayGetStatistics(serverStats);
+
+	Stop();
+	runThread->join();
+	delete runThread;
+	runThread = nullptr;
+
+	int failedCount = clientCount - (int)clients.size();
+	uint32_t minInput = clients.empty() ? 0 : UINT32_MAX;
+	uint32_t maxInput = 0;
+	uint64_t totalInput = 0;
+	for(shared_ptr<LoadTestConnection> &client : clients) {
+		if(client->ConnectionError() || client->StateCount == 0 || client->InputCount == 0) {
+			failedCount++;
+		}
+		minInput = std::min(minInput, client->InputCount);
+		maxInput = std::max(maxInput, client->InputCount);
+		totalInput += client->InputCount;
+	}
+	clients.clear();
+
+	double elapsed = std::max(duration, 1);
+	std::cout << "Input messages per spectator: min " << minInput << ", max " << maxInput << ", total " << totalInput << std::endl;
+	std::cout << "Server sent " << (serverStats.BytesSent / 1024) << " KB (" << (int)(serverStats.BytesSent / 1024 / elapsed) << " KB/s), received " << (serverStats.BytesReceived / 1024) << " KB" << std::endl;
+	std::cout << "States sent: " << serverStats.StateCount << " (" << serverStats.DeltaStateCount << " deltas, " << (serverStats.StateBytes / 1024) << " KB)" << std::endl;
+	std::cout << failedCount << " spectators failed." << std::endl;
+
+	return failedCount;
+}
+
+//Netplay client used by the join test - records when it receives its first state, and only acknowledges the states when deltas are enabled
+//(the server can only send a delta against a state the client acknowledged)
+class JoinTestConnection : public GameConnection
+{
+private:
+	string _playerName;
+	bool _sendAcks;
+	Timer _joinTimer;
+
+	void ProcessMessage(NetMessage* message) override
+	{
+		switch(message->GetType()) {
+			case MessageType::ServerInformation: {
+				HandShakeMessage handshake(_playerName, HandShakeMessage::GetPasswordHash("", ((ServerInformationMessage*)message)->GetHashSalt()), true);
+				SendNetMessage(handshake);
+				break;
+			}
+
+			case MessageType::SaveState: {
+				SaveStateMessage* state = (SaveStateMessage*)message;
+				RecordStateTransfer(*state);
+				if(StateCount++ == 0) {
+					JoinTime = _joinTimer.GetElapsedMS();
+				}
+				if(_sendAcks) {
+					SaveStateAckMessage ack(state->GetStateId());
+					SendNetMessage(ack);
+				}
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+
+public:
+	uint32_t StateCount = 0;
+	double JoinTime = 0;
+
+	JoinTestConnection(shared_ptr<Socket> socket, string playerName, bool sendAcks) : GameConnection(nullptr, socket)
+	{
+		_playerName = playerName;
+		_sendAcks = sendAcks;
+	}
+};
+
+//Processes the clients' messages until each of them has received [stateCount] states (or until the timeout)
+bool WaitForStates(vector<shared_ptr<JoinTestConnection>> &clients, uint32_t stateCount, double timeout)
+{
+	Timer waitTimer;
+	vector<Socket*> sockets;
+	vector<JoinTestConnection*> pendingClients;
+	vector<bool> readable;
+	while(waitTimer.GetElapsedMS() < timeout) {
+		sockets.clear();
+		pendingClients.clear();
+		for(shared_ptr<JoinTestConnection> &client : clients) {
+			if(!client->ConnectionError() && client->StateCount < stateCount) {
+				sockets.push_back(client->GetSocket());
+				pendingClients.push_back(client.get());
+			}
+		}
+
+		if(sockets.empty()) {
+			break;
+		}
+
+		Socket::Poll(sockets, readable, 50);
+		for(size_t i = 0; i < pendingClients.size(); i++) {
+			if(readable[i]) {
+				pendingClients[i]->ProcessMessages();
+			}
+		}
+	}
+
+	for(shared_ptr<JoinTestConnection> &client : clients) {
+		if(client->StateCount < stateCount) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//Join test: [clientCount] local clients join the game at the same time, then the game is reset [resyncCount] times (the server sends a state to every client on each reset)
+//Runs twice, with and without delta states, and reports the join time & the amount of data the server sent
+int RunNetPlayJoinTest(char* romFilename, string mesenFolder, int clientCount, int resyncCount)
+{
+	const uint16_t port = 8890;
+
+	InitDll();
+	SetFlags(0x8000000000000000); //EmulationFlags::ConsoleMode
+	InitializeEmu(mesenFolder.c_str(), nullptr, nullptr, true, true, true);
+	SetControllerType(0, ControllerType::StandardController);
+	SetControllerType(1, ControllerType::StandardController);
+	LoadROM(romFilename, (char*)"");
+	StartServer(port, (char*)"", (char*)"Host", 1);
+	runThread = new std::thread(RunEmu);
+
+	while(!IsServerRunning()) {
+		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(10));
+	}
+
+	int failedCount = 0;
+	for(bool deltas : { true, false }) {
+		vector<shared_ptr<JoinTestConnection>> clients;
+		for(int i = 0; i < clientCount; i++) {
+			shared_ptr<Socket> socket(new Socket());
+			if(socket->Connect("127.0.0.1", port)) {
+				clients.push_back(shared_ptr<JoinTestConnection>(new JoinTestConnection(socket, "Client " + std::to_string(i + 1), deltas)));
+			}
+		}
+
+		bool joined = WaitForStates(clients, 1, 10000);
+		bool resynced = joined;
+		for(int i = 0; i < resyncCount && resynced; i++) {
+			Reset();
+			resynced = WaitForStates(clients, i + 2, 5000);
+		}
+
+		int joinedCount = 0;
+		double totalJoinTime = 0;
+		double maxJoinTime = 0;
+		NetPlayStatistics total = {};
+		for(shared_ptr<JoinTestConnection> &client : clients) {
+			if(client->StateCount > 0) {
+				joinedCount++;
+				totalJoinTime += client->JoinTime;
+				maxJoinTime = std::max(maxJoinTime, client->JoinTime);
+			}
+
+			//Everything the clients received was sent by the server
+			NetPlayStatistics stats = client->GetStatistics();
+			total.BytesSent += stats.BytesReceived;
+			total.StateCount += stats.StateCount;
+			total.DeltaStateCount += stats.DeltaStateCount;
+			total.StateBytes += stats.StateBytes;
+		}
+
+		std::cout << (deltas ? "With" : "Without") << " delta states: " << joinedCount << "/" << clientCount << " clients joined" << (resynced ? "" : " (timed out)") << std::endl;
+		std::cout << "  Join time: avg " << (joinedCount == 0 ? 0 : (int)(totalJoinTime / joinedCount)) << " ms, max " << (int)maxJoinTime << " ms" << std::endl;
+		std::cout << "  Server sent " << (total.BytesSent / 1024) << " KB, states: " << total.StateCount << " (" << total.DeltaStateCount << " deltas, " << (total.StateBytes / 1024) << " KB)" << std::endl;
+
+		if(!resynced || joinedCount != clientCount) {
+			failedCount++;
+		}
+	}
+
+	Stop();
+	runThread->join();
+	delete runThread;
+	runThread = nullptr;
+
+	return failedCount;
+}
+
+//Draws frame [frameNumber] of a canned NES-like sequence (scrolling background, static status bar & moving sprites), scaled by [scale]
+void DrawBenchmarkFrame(uint32_t* frame, int frameNumber, int scale)
+{
+	const uint32_t palette[8] = { 0x5C94FC, 0x00A800, 0x88D800, 0xC84C0C, 0xFCBCB0, 0x000000, 0xFCFCFC, 0xD82800 };
+	int width = 256 * scale;
+	for(int y = 0; y < 240; y++) {
+		for(int x = 0; x < 256; x++) {
+			uint32_t color;
+			if(y < 32) {
+				//Status bar, only the timer changes
+				color = (y >= 12 && y < 20 && x >= 200 && x < 224 && ((x / 8 + frameNumber / 60) & 1)) ? palette[6] : palette[5];
+			} else {
+				int scrollX = x + frameNumber;
+				int tile = (scrollX / 16) * 31 + (y / 16) * 17;
+				color = (y < 176 && (tile % 7) != 0) ? palette[0] : palette[1 + ((tile + (scrollX & 0x0F) / 4 + (y & 0x0F) / 4) % 3)];
+			}
+
+			for(int i = 0; i < 8; i++) {
+				int spriteX = (i * 37 + frameNumber * (i + 1)) % 240;
+				int spriteY = 40 + (i * 23 + frameNumber * (8 - i) / 2) % 180;
+				if(x >= spriteX && x < spriteX + 16 && y >= spriteY && y < spriteY + 16 && ((x - spriteX) ^ (y - spriteY)) & 0x04) {
+					color = palette[3 + (i % 5)];
+				}
+			}
+
+			for(int sy = 0; sy < scale; sy++) {
+				for(int sx = 0; sx < scale; sx++) {
+					frame[(y * scale + sy) * width + x * scale + sx] = color;
+				}
+			}
+		}
+	}
+}
+
+int RunZmbvBenchmark(int scale)
+{
+	//Encodes a canned 10-second (600 frames) sequence with the ZMBV codec and reports the encoding speed
+	const int frameCount = 600;
+	int width = 256 * scale;
+	int height = 240 * scale;
+	vector<uint32_t> frame(width * height);
+
+	ZmbvCodec codec;
+	codec.SetupCompress(width, height, 6);
+
+	double prepareTime = 0;
+	double compressTime = 0;
+	uint64_t totalSize = 0;
+	for(int i = 0; i < frameCount; i++) {
+		DrawBenchmarkFrame(frame.data(), i, scale);
+
+		Timer frameTimer;
+		codec.PrepareFrame(0, i % 120 == 0, (uint8_t*)frame.data());
+		prepareTime += frameTimer.GetElapsedMS();
+
+		frameTimer.Reset();
+		uint8_t* compressedData = nullptr;
+		int size = codec.CompressPreparedFrame(0, &compressedData);
+		compressTime += frameTimer.GetElapsedMS();
+		if(size < 0) {
+			std::cout << "Encoding failed" << std::endl;
+			return 1;
+		}
+		totalSize += size;
+	}
+
+	std::cout << "ZMBV " << width << "x" << height << ", " << frameCount << " frames, " << (totalSize / 1024) << " KB" << std::endl;
+	std::cout << "Motion search: " << (int)(frameCount * 1000 / prepareTime) << " fps" << std::endl;
+	std::cout << "Compression: " << (int)(frameCount * 1000 / compressTime) << " fps" << std::endl;
+	std::cout << "Total: " << (int)(frameCount * 1000 / (prepareTime + compressTime)) << " fps" << std::endl;
+	return 0;
+}
+
+int RunHashBenchmark(char* romFilename)
+{
+	//Hashing speed for a large rom (8 MB multicart-sized buffer by default) and for the per-frame MD5 used by recorded tests
+	vector<uint8_t> romData;
+	if(romFilename) {
+		ifstream romFile(romFilename, std::ios::in | std::ios::binary);
+		romData.assign(std::istreambuf_iterator<char>(romFile), std::istreambuf_iterator<char>());
+	} else {
+		romData.resize(8 * 1024 * 1024);
+		for(size_t i = 0; i < romData.size(); i++) {
+			romData[i] = (uint8_t)((i * 2654435761u) >> 13);
+		}
+	}
+
+	if(romData.empty()) {
+		std::cout << "Could not read " << romFilename << std::endl;
+		return 1;
+	}
+
+	const int iterations = 10;
+	double sizeMb = romData.size() * iterations / 1024.0 / 1024.0;
+	auto printSpeed = [&](string name, double elapsedMs) {
+		std::cout << name << ": " << (int)(sizeMb * 1000 / elapsedMs) << " MB/s" << std::endl;
+	};
+
+	Timer benchTimer;
+	for(int i = 0; i < iterations; i++) {
+		CRC32::GetCRC(romData.data(), romData.size());
+	}
+	printSpeed("CRC32", benchTimer.GetElapsedMS());
+
+	benchTimer.Reset();
+	for(int i = 0; i < iterations; i++) {
+		SHA1::GetHash(romData);
+	}
+	printSpeed("SHA1", benchTimer.GetElapsedMS());
+
+	benchTimer.Reset();
+	for(int i = 0; i < iterations; i++) {
+		GetMd5Sum(romData.data(), romData.size());
+	}
+	printSpeed("MD5", benchTimer.GetElapsedMS());
+
+	benchTimer.Reset();
+	for(int i = 0; i < iterations; i++) {
+		HashUtilities::GetHashes(romData, HashType::Crc32Hash | HashType::Sha1Hash | HashType::Md5Hash);
+	}
+	printSpeed("CRC32+SHA1+MD5 (single pass)", benchTimer.GetElapsedMS());
+
+	const int frameCount = 600;
+	vector<uint16_t> frameBuffer(PPU::PixelCount);
+	uint8_t md5Hash[16];
+	benchTimer.Reset();
+	for(int i = 0; i < frameCount; i++) {
+		frameBuffer[i * 97 % PPU::PixelCount] = (uint16_t)i;
+		GetMd5Sum(md5Hash, frameBuffer.data(), PPU::PixelCount * sizeof(uint16_t));
+	}
+	std::cout << "Frame MD5: " << (int)(frameCount * 1000 / benchTimer.GetElapsedMS()) << " frames/s" << std::endl;
+	return 0;
+}
+
+int RunChecksumDiff(char* logA, char* logB)
+{
+	//Compares 2 state checksum logs (e.g from 2 netplay peers) and reports the first frame where they diverge
+	StateChecksumDiff diff;
+	if(!StateChecksumLog::Compare(logA, logB, diff)) {
+		std::cout << "Could not read the checksum logs (missing file, invalid format or different console types)" << std::endl;
+		return 2;
+	}
+
+	if(diff.Diverged) {
+		std::cout << "Diverged at frame " << diff.Frame;
+		if(diff.Segment > 0) {
+			std::cout << " (after reset #" << diff.Segment << ")";
+		}
+		std::cout << ": " << StateChecksumLog::GetComponentNames(diff.ComponentMask) << std::endl;
+		std::cout << diff.ComparedFrames << " frames compared" << std::endl;
+		return 1;
+	}
+
+	std::cout << "No divergence, " << diff.ComparedFrames << " frames compared" << std::endl;
+	return 0;
+}
+
 #ifdef __GNUC__
 	void handler(int sig) {
 		void *array[20];
@@ -142,6 +598,33 @@ int main(int argc, char* argv[])
 		signal(SIGSEGV, handler);		
 	#endif
 
+	if(argc >= 3 && strcmp(argv[1], "/netplayload") == 0) {
+		//Load test: 100 (by default) local spectators connected to a single server for 30 seconds
+		int clientCount = argc >= 4 ? atoi(argv[3]) : 100;
+		int duration = argc >= 5 ? atoi(argv[4]) : 30;
+		return RunNetPlayLoadTest(argv[2], mesenFolder, clientCount, duration);
+	}
+
+	if(argc >= 3 && strcmp(argv[1], "/netplayjoin") == 0) {
+		//Join test: 8 (by default) local clients joining a game, followed by 10 resyncs - with and without delta states
+		int clientCount = argc >= 4 ? std::max(1, atoi(argv[3])) : 8;
+		int resyncCount = argc >= 5 ? atoi(argv[4]) : 10;
+		return RunNetPlayJoinTest(argv[2], mesenFolder, clientCount, resyncCount);
+	}
+
+	if(argc >= 2 && strcmp(argv[1], "/hashbench") == 0) {
+		return RunHashBenchmark(argc >= 3 ? argv[2] : nullptr);
+	}
+
+	if(argc >= 4 && strcmp(argv[1], "/checksumdiff") == 0) {
+		return RunChecksumDiff(argv[2], argv[3]);
+	}
+
+	if(argc >= 2 && strcmp(argv[1], "/zmbvbench") == 0) {
+		//Video encoding benchmark, at 4x scale by default
+		return RunZmbvBenchmark(argc >= 3 ? std::max(1, atoi(argv[2])) : 4);
+	}
+
 	if(argc >= 3 && strcmp(argv[1], "/auto") == 0) {
 		string romFolder = argv[2];
 		testFilenames = FolderUtilities::GetFilesInFolder(romFolder, { ".nes" }, true);
@@ -5,11 +5,15 @@ AviRecorder::AviRecorder(VideoCodec codec, uint32_t compressionLevel)
 {
 	_recording = false;
 	_stopFlag = false;
-	_frameBuffer = nullptr;
+	_encoderDone = false;
 	_frameBufferLength = 0;
+	_poolSize = 0;
 	_sampleRate = 0;
 	_codec = codec;
 	_compressionLevel = compressionLevel;
+	_recordedFrames = 0;
+	_droppedFrames = 0;
+	_maxQueueDepth = 0;
 }
 
 AviRecorder::~AviRecorder()
@@ -18,10 +22,11 @@ AviRecorder::~AviRecorder()
 		StopRecording();
 	}
 
-	if(_frameBuffer) {
-		delete[] _frameBuffer;
-		_frameBuffer = nullptr;
+	for(uint8_t* buffer : _buffers) {
+		delete[] buffer;
 	}
+	_buffers.clear();
+	_freeBuffers.clear();
 }
 
 bool AviRecorder::StartRecording(string filename, uint32_t width, uint32_t height, uint32_t bpp, uint32_t audioSampleRate, double fps)
@@ -33,7 +38,7 @@ bool AviRecorder::StartRecording(string filename, uint32_t width, uint32_t heigh
 		_height = height;
 		_fps = fps;
 		_frameBufferLength = height * width * bpp;
-		_frameBuffer = new uint8_t[_frameBufferLength];
+		_poolSize = std::max(MinPoolSize, std::min(MaxPoolSize, MaxPoolMemory / std::max<uint32_t>(_frameBufferLength, 1)));
 
 		_aviWriter.reset(new AviWriter());
 		if(!_aviWriter->StartWrite(filename, _codec, width, height, bpp, (uint32_t)(_fps * 1000000), audioSampleRate, _compressionLevel)) {
@@ -41,17 +46,10 @@ bool AviRecorder::StartRecording(string filename, uint32_t width, uint32_t heigh
 			return false;
 		}
 
-		_aviWriterThread = std::thread([=]() {
-			while(!_stopFlag) {
-				_waitFrame.Wait();
-				if(_stopFlag) {
-					break;
-				}
-
-				auto lock = _lock.AcquireSafe();
-				_aviWriter->AddFrame(_frameBuffer);
-			}
-		});
+		_stopFlag = false;
+		_encoderDone = false;
+		_encoderThread = std::thread([=]() { EncodeFrames(); });
+		_writerThread = std::thread([=]() { WriteFrames(); });
 
 		_recording = true;
 	}
@@ -63,23 +61,154 @@ void AviRecorder::StopRecording()
 	if(_recording) {
 		_recording = false;
 
+		//Both threads exit once all the frames that are still queued have been written
 		_stopFlag = true;
 		_waitFrame.Signal();
-		_aviWriterThread.join();
+		_encoderThread.join();
+		_writerThread.join();
 
 		_aviWriter->EndWrite();
 		_aviWriter.reset();
 	}
 }
 
+uint8_t* AviRecorder::AcquireBuffer()
+{
+	auto lock = _queueLock.AcquireSafe();
+	if(!_freeBuffers.empty()) {
+		uint8_t* buffer = _freeBuffers.back();
+		_freeBuffers.pop_back();
+		return buffer;
+	} else if(_buffers.size() < _poolSize) {
+		//Buffers are only allocated when needed, most recordings only ever use a few of them
+		uint8_t* buffer = new uint8_t[_frameBufferLength];
+		_buffers.push_back(buffer);
+		return buffer;
+	}
+	return nullptr;
+}
+
+void AviRecorder::ReleaseBuffer(uint8_t* buffer)
+{
+	auto lock = _queueLock.AcquireSafe();
+	_freeBuffers.push_back(buffer);
+}
+
+uint32_t AviRecorder::GetPreparedFrameCount()
+{
+	auto lock = _preparedLock.AcquireSafe();
+	return (uint32_t)_preparedFrames.size();
+}
+
+void AviRecorder::EncodeFrames()
+{
+	int slot = 0;
+	while(true) {
+		bool stopping = _stopFlag;
+		bool hasFrame = false;
+		QueuedFrame frame;
+		{
+			auto lock = _queueLock.AcquireSafe();
+			if(!_frameQueue.empty()) {
+				frame = std::move(_frameQueue.front());
+				_frameQueue.pop_front();
+				hasFrame = true;
+			}
+		}
+
+		if(!hasFrame) {
+			if(stopping) {
+				break;
+			}
+			_waitFrame.Wait();
+			continue;
+		}
+
+		//Wait for the writer thread to be done with the frame that last used this slot
+		while(GetPreparedFrameCount() >= BaseCodec::SlotCount) {
+			_waitSlot.Wait();
+		}
+
+		_aviWriter->PrepareFrame(slot, frame.FrameData);
+		{
+			auto lock = _preparedLock.AcquireSafe();
+			_preparedFrames.push_back({ slot, std::move(frame) });
+		}
+		_waitPrepared.Signal();
+
+		slot = (slot + 1) % BaseCodec::SlotCount;
+	}
+
+	_encoderDone = true;
+	_waitPrepared.Signal();
+}
+
+void AviRecorder::WriteFrames()
+{
+	while(true) {
+		bool encoderDone = _encoderDone;
+		bool hasFrame = false;
+		int slot = 0;
+		vector<int16_t> audio;
+		{
+			auto lock = _preparedLock.AcquireSafe();
+			if(!_preparedFrames.empty()) {
+				slot = _preparedFrames.front().first;
+				audio = std::move(_preparedFrames.front().second.Audio);
+				hasFrame = true;
+			}
+		}
+
+		if(!hasFrame) {
+			if(encoderDone) {
+				break;
+			}
+			_waitPrepared.Wait();
+			continue;
+		}
+
+		if(!audio.empty()) {
+			_aviWriter->AddSound(audio.data(), (uint32_t)audio.size() / 2);
+		}
+		_aviWriter->WritePreparedFrame(slot);
+		_recordedFrames++;
+
+		//The frame's slot and buffer can only be reused once the frame has been written
+		uint8_t* frameData;
+		{
+			auto lock = _preparedLock.AcquireSafe();
+			frameData = _preparedFrames.front().second.FrameData;
+			_preparedFrames.pop_front();
+		}
+		_waitSlot.Signal();
+		ReleaseBuffer(frameData);
+	}
+}
+
 void AviRecorder::AddFrame(void* frameBuffer, uint32_t width, uint32_t height, double fps)
 {
 	if(_recording) {
 		if(_width != width || _height != height || _fps != fps) {
 			StopRecording();
 		} else {
-			auto lock = _lock.AcquireSafe();
-			memcpy(_frameBuffer, frameBuffer, _frameBufferLength);
+			uint8_t* buffer = AcquireBuffer();
+			if(!buffer) {
+				//All buffers are waiting to be encoded - the audio is kept and will be added along with the next frame
+				_droppedFrames++;
+				return;
+			}
+
+			memcpy(buffer, frameBuffer, _frameBufferLength);
+
+			{
+				auto lock = _queueLock.AcquireSafe();
+				QueuedFrame frame;
+				frame.FrameData = buffer;
+				frame.Audio = std::move(_pendingAudio);
+				_pendingAudio.clear();
+				_frameQueue.push_back(std::move(frame));
+				_maxQueueDepth = std::max(_maxQueueDepth, (uint32_t)(_buffers.size() - _freeBuffers.size()));
+			}
 			_waitFrame.Signal();
 		}
 	}
@@ -89,10 +218,10 @@ void AviRecorder::AddSound(int16_t* soundBuffer, uint32_t sampleCount, uint32_t
 {
 	if(_recording) {
 		if(_sampleRate != sampleRate) {
-			auto lock = _lock.AcquireSafe();
 			StopRecording();
 		} else {
-			_aviWriter->AddSound(soundBuffer, sampleCount);
+			auto lock = _queueLock.AcquireSafe();
+			_pendingAudio.insert(_pendingAudio.end(), soundBuffer, soundBuffer + sampleCount * 2);
 		}
 	}
 }
@@ -105,4 +234,15 @@ bool AviRecorder::IsRecording()
 string AviRecorder::GetOutputFile()
 {
 	return _outputFile;
+}
+
+VideoRecorderStatistics AviRecorder::GetStatistics()
+{
+	auto lock = _queueLock.AcquireSafe();
+	VideoRecorderStatistics stats = {};
+	stats.RecordedFrames = _recordedFrames;
+	stats.DroppedFrames = _droppedFrames;
+	stats.QueueDepth = (uint32_t)(_buffers.size() - _freeBuffers.size());
+	stats.MaxQueueDepth = _maxQueueDepth;
+	return stats;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "stdafx.h"
 #include <thread>
+#include <deque>
 #include "AutoResetEvent.h"
 #include "AviWriter.h"
 #include "SimpleLock.h"
@@ -11,17 +12,45 @@ class Console;
 class AviRecorder : public IVideoRecorder
 {
 private:
-	std::thread _aviWriterThread;
+	//Frames are copied into a pool of recycled buffers and queued, so a slow encode never stalls the renderer
+	//Frames are only dropped when the whole pool is in use (the encoder is too slow for too long)
+	static constexpr uint32_t MaxPoolMemory = 128 * 1024 * 1024;
+	static constexpr uint32_t MinPoolSize = 8;
+	static constexpr uint32_t MaxPoolSize = 300;
+
+	struct QueuedFrame
+	{
+		uint8_t* FrameData = nullptr;
+
+		//Audio received since the previous frame
+		vector<int16_t> Audio;
+	};
+
+	//Encoding is split in 2 threads: the encoder thread prepares each frame (ZMBV: motion search), while the writer thread
+	//compresses the previous frame and writes it to the file
+	std::thread _encoderThread;
+	std::thread _writerThread;
 	
 	unique_ptr<AviWriter> _aviWriter;
 
 	string _outputFile;
-	SimpleLock _lock;
+
+	SimpleLock _queueLock;
 	AutoResetEvent _waitFrame;
+	std::deque<QueuedFrame> _frameQueue;
+	vector<uint8_t*> _buffers;
+	vector<uint8_t*> _freeBuffers;
+	vector<int16_t> _pendingAudio;
+	uint32_t _poolSize;
 
-	atomic<bool> _stopFlag;	
+	SimpleLock _preparedLock;
+	AutoResetEvent _waitPrepared;
+	AutoResetEvent _waitSlot;
+	std::deque<std::pair<int, QueuedFrame>> _preparedFrames;
+
+	atomic<bool> _stopFlag;
+	atomic<bool> _encoderDone;
 	bool _recording;
-	uint8_t* _frameBuffer;
 	uint32_t _frameBufferLength;
 	uint32_t _sampleRate;
 
@@ -32,6 +61,17 @@ private:
 	VideoCodec _codec;
 	uint32_t _compressionLevel;
 
+	atomic<uint32_t> _recordedFrames;
+	atomic<uint32_t> _droppedFrames;
+	uint32_t _maxQueueDepth;
+
+	uint8_t* AcquireBuffer();
+	void ReleaseBuffer(uint8_t* buffer);
+	uint32_t GetPreparedFrameCount();
+
+	void EncodeFrames();
+	void WriteFrames();
+
 public:
 	AviRecorder(VideoCodec codec, uint32_t compressionLevel);
 	virtual ~AviRecorder();
@@ -44,4 +84,5 @@ public:
 
 	bool IsRecording() override;
 	string GetOutputFile() override;
+	VideoRecorderStatistics GetStatistics() override;
 };
\ No newline at end of file
@@ -234,15 +234,34 @@ void AviWriter::EndWrite()
 }
 
 void AviWriter::AddFrame(uint8_t *frameData)
+{
+	PrepareFrame(0, frameData);
+	WritePreparedFrame(0);
+}
+
+void AviWriter::PrepareFrame(int slot, uint8_t *frameData)
 {
 	if(!_file) {
 		return;
 	}
 
-	bool isKeyFrame = (_frames % 120 == 0) ? 1 : 0;
+	bool isKeyFrame = (_preparedFrames % 120 == 0) ? 1 : 0;
+	_preparedFrames++;
+
+	_keyFrames[slot] = isKeyFrame;
+	_codec->PrepareFrame(slot, isKeyFrame, frameData);
+}
+
+void AviWriter::WritePreparedFrame(int slot)
+{
+	if(!_file) {
+		return;
+	}
+
+	bool isKeyFrame = _keyFrames[slot];
 
 	uint8_t* compressedData = nullptr;
-	int written = _codec->CompressFrame(isKeyFrame, frameData, &compressedData);
+	int written = _codec->CompressPreparedFrame(slot, &compressedData);
 	if(written < 0) {
 		return;
 	}
@@ -268,6 +287,20 @@ void AviWriter::AddSound(int16_t *data, uint32_t sampleCount)
 	}
 
 	auto lock = _audioLock.AcquireSafe();
-	memcpy(_audiobuf+_audioPos/2, data, sampleCount * 4);
-	_audioPos += sampleCount * 4;
+	uint32_t byteCount = sampleCount * 4;
+	uint8_t* source = (uint8_t*)data;
+	while(byteCount > 0) {
+		if(_audioPos >= sizeof(_audiobuf)) {
+			//Buffer is full (e.g several frames' worth of audio was queued by the recorder), write it right away
+			WriteAviChunk("01wb", _audioPos, _audiobuf, 0);
+			_audiowritten += _audioPos;
+			_audioPos = 0;
+		}
+
+		uint32_t length = std::min<uint32_t>(byteCount, sizeof(_audiobuf) - _audioPos);
+		memcpy((uint8_t*)_audiobuf + _audioPos, source, length);
+		_audioPos += length;
+		source += length;
+		byteCount -= length;
+	}
 }
\ No newline at end of file
@@ -31,6 +31,8 @@ private:
 	uint32_t _audiowritten = 0;
 
 	uint32_t _frames = 0;
+	uint32_t _preparedFrames = 0;
+	bool _keyFrames[BaseCodec::SlotCount] = {};
 	uint32_t _width = 0;
 	uint32_t _height = 0;
 	uint32_t _bpp = 0;
@@ -50,6 +52,11 @@ private:
 
 public:
 	void AddFrame(uint8_t* frameData);
+
+	//AddFrame split in 2 steps, see BaseCodec::PrepareFrame
+	void PrepareFrame(int slot, uint8_t* frameData);
+	void WritePreparedFrame(int slot);
+
 	void AddSound(int16_t * data, uint32_t sampleCount);
 
 	bool StartWrite(string filename, VideoCodec codec, uint32_t width, uint32_t height, uint32_t bpp, uint32_t fps, uint32_t audioSampleRate, uint32_t compressionLevel);
@@ -3,10 +3,34 @@
 
 class BaseCodec
 {
+private:
+	struct PreparedFrame
+	{
+		bool IsKeyFrame = false;
+		uint8_t* FrameData = nullptr;
+	};
+
+	PreparedFrame _preparedFrames[2];
+
 public:
+	//Frames can be encoded in 2 steps, which lets the recorder prepare a frame (e.g motion search) while the previous one is being compressed
+	//Slots are used in turn - the frame data given to PrepareFrame must remain valid until CompressPreparedFrame is called for the same slot
+	static constexpr int SlotCount = 2;
+
 	virtual bool SetupCompress(int width, int height, uint32_t compressionLevel) = 0;
 	virtual int CompressFrame(bool isKeyFrame, uint8_t *frameData, uint8_t** compressedData) = 0;
 	virtual const char* GetFourCC() = 0;
 
+	virtual void PrepareFrame(int slot, bool isKeyFrame, uint8_t *frameData)
+	{
+		_preparedFrames[slot].IsKeyFrame = isKeyFrame;
+		_preparedFrames[slot].FrameData = frameData;
+	}
+
+	virtual int CompressPreparedFrame(int slot, uint8_t** compressedData)
+	{
+		return CompressFrame(_preparedFrames[slot].IsKeyFrame, _preparedFrames[slot].FrameData, compressedData);
+	}
+
 	virtual ~BaseCodec() { }
 };
\ No newline at end of file
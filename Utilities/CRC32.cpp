@@ -4,6 +4,7 @@
 #include "stdafx.h"
 
 #include "CRC32.h"
+#include "CpuFeatures.h"
 
 const size_t MaxSlice = 16;
 extern const uint32_t Crc32Lookup[MaxSlice][256];
@@ -33,9 +34,92 @@ extern const uint32_t Crc32Lookup[MaxSlice][256];
 #define __BYTE_ORDER __LITTLE_ENDIAN
 #endif
 
+#ifdef HAS_X86_INTRINSICS
+//Folds 64 bytes at a time with carry-less multiplications, based on:
+//"Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" (Intel, V. Gopal et al., 2009)
+//[length] must be a multiple of 16 and at least 64. [crc] is the inverted CRC value (same as in crc32_16bytes)
+CPU_TARGET("pclmul,sse4.1")
+static uint32_t crc32_pclmul(const uint8_t* buffer, size_t length, uint32_t crc)
+{
+	//Bit-reflected constants for the CRC32 polynomial (x^(4*128+32) mod P, x^(4*128-32) mod P, etc.) and Barrett reduction constants
+	const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+	const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+	const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+	const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+
+	__m128i x1 = _mm_loadu_si128((const __m128i*)(buffer + 0x00));
+	__m128i x2 = _mm_loadu_si128((const __m128i*)(buffer + 0x10));
+	__m128i x3 = _mm_loadu_si128((const __m128i*)(buffer + 0x20));
+	__m128i x4 = _mm_loadu_si128((const __m128i*)(buffer + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+	buffer += 64;
+	length -= 64;
+
+	//Fold 4x128 bits in parallel
+	while(length >= 64) {
+		__m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+		__m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+		__m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+		__m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(buffer + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(buffer + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(buffer + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(buffer + 0x30)));
+		buffer += 64;
+		length -= 64;
+	}
+
+	//Fold the 4 values into a single 128-bit value, then fold the remaining 16-byte blocks into it
+	__m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5);
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5);
+
+	while(length >= 16) {
+		x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), _mm_loadu_si128((const __m128i*)buffer)), x5);
+		buffer += 16;
+		length -= 16;
+	}
+
+	//Fold 128 bits to 64 bits
+	const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5k0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	//Barrett reduction to 32 bits
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), poly, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+#endif
+
 uint32_t CRC32::GetCRC(uint8_t *buffer, std::streamoff length)
 {
-	return crc32_16bytes(buffer, length, 0);
+	return UpdateCRC(0, buffer, (size_t)length);
+}
+
+uint32_t CRC32::UpdateCRC(uint32_t previousCrc32, const uint8_t *buffer, size_t length)
+{
+#ifdef HAS_X86_INTRINSICS
+	if(length >= 64 && CpuFeatures::HasPclmul()) {
+		size_t blockLength = length & ~(size_t)0x0F;
+		previousCrc32 = ~crc32_pclmul(buffer, blockLength, ~previousCrc32);
+		buffer += blockLength;
+		length -= blockLength;
+	}
+#endif
+	return crc32_16bytes(buffer, length, previousCrc32);
 }
 
 uint32_t CRC32::GetCRC(string filename)
@@ -53,7 +137,7 @@ uint32_t CRC32::GetCRC(string filename)
 		file.read((char*)buffer, fileSize);
 		file.close();
 
-		crc = crc32_16bytes(buffer, fileSize, 0);
+		crc = UpdateCRC(0, buffer, (size_t)fileSize);
 
 		delete[] buffer;
 	}
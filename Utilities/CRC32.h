@@ -8,5 +8,8 @@ private:
 
 public:
 	static uint32_t GetCRC(uint8_t *buffer, std::streamoff length);
+
+	//Continues the calculation of a CRC over several buffers (start with previousCrc32 = 0)
+	static uint32_t UpdateCRC(uint32_t previousCrc32, const uint8_t *buffer, size_t length);
 	static uint32_t GetCRC(string filename);
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+#include "stdafx.h"
+
+//Runtime detection of the x86 instruction set extensions used by the hashing code
+//Functions that use these extensions must be marked with CPU_TARGET (needed by GCC/Clang, which only enable them for those functions)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define HAS_X86_INTRINSICS
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define CPU_TARGET(x)
+	#else
+		#include <cpuid.h>
+		#define CPU_TARGET(x) __attribute__((target(x)))
+	#endif
+	#include <immintrin.h>
+#endif
+
+class CpuFeatures
+{
+private:
+#ifdef HAS_X86_INTRINSICS
+	static void GetCpuId(uint32_t leaf, uint32_t regs[4])
+	{
+		#ifdef _MSC_VER
+			int values[4];
+			__cpuid(values, 0);
+			if((uint32_t)values[0] < leaf) {
+				values[0] = values[1] = values[2] = values[3] = 0;
+			} else {
+				__cpuidex(values, (int)leaf, 0);
+			}
+			for(int i = 0; i < 4; i++) {
+				regs[i] = (uint32_t)values[i];
+			}
+		#else
+			regs[0] = regs[1] = regs[2] = regs[3] = 0;
+			if(__get_cpuid_max(0, nullptr) >= leaf) {
+				__cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+			}
+		#endif
+	}
+#endif
+
+public:
+	//PCLMULQDQ + SSE4.1 (CRC32)
+	static bool HasPclmul()
+	{
+	#ifdef HAS_X86_INTRINSICS
+		static const bool supported = []() {
+			uint32_t regs[4];
+			GetCpuId(1, regs);
+			return (regs[2] & (1 << 1)) && (regs[2] & (1 << 19));
+		}();
+		return supported;
+	#else
+		return false;
+	#endif
+	}
+
+	//SHA extensions + SSSE3/SSE4.1 (SHA1)
+	static bool HasSha()
+	{
+	#ifdef HAS_X86_INTRINSICS
+		static const bool supported = []() {
+			uint32_t regs[4];
+			GetCpuId(1, regs);
+			bool sse = (regs[2] & (1 << 9)) && (regs[2] & (1 << 19));
+			GetCpuId(7, regs);
+			return sse && (regs[1] & (1 << 29));
+		}();
+		return supported;
+	#else
+		return false;
+	#endif
+	}
+};
@@ -190,6 +190,25 @@ vector<string> FolderUtilities::GetFilesInFolder(string rootFolder, std::unorder
 	return files;
 }
 
+bool FolderUtilities::GetFileInfo(string filepath, int64_t &modifiedTime, uint64_t &size)
+{
+	std::error_code errorCode;
+	fs::path path = fs::u8path(filepath);
+	fs::file_time_type writeTime = fs::last_write_time(path, errorCode);
+	if(errorCode) {
+		return false;
+	}
+	uintmax_t fileSize = fs::file_size(path, errorCode);
+	if(errorCode) {
+		return false;
+	}
+
+	//Only used to detect changes, the value's unit/epoch depends on the platform
+	modifiedTime = (int64_t)writeTime.time_since_epoch().count();
+	size = (uint64_t)fileSize;
+	return true;
+}
+
 string FolderUtilities::GetFilename(string filepath, bool includeExtension)
 {
 	fs::path filename = fs::u8path(filepath).filename();
@@ -237,6 +256,11 @@ vector<string> FolderUtilities::GetFilesInFolder(string rootFolder, std::unorder
 	return vector<string>();
 }
 
+bool FolderUtilities::GetFileInfo(string filepath, int64_t &modifiedTime, uint64_t &size)
+{
+	return false;
+}
+
 string FolderUtilities::GetFilename(string filepath, bool includeExtension)
 {
 	size_t index = filepath.find_last_of(PATHSEPARATOR);
@@ -31,6 +31,8 @@ public:
 	static vector<string> GetFolders(string rootFolder);
 	static vector<string> GetFilesInFolder(string rootFolder, std::unordered_set<string> extensions, bool recursive);
 
+	static bool GetFileInfo(string filepath, int64_t &modifiedTime, uint64_t &size);
+
 	static string GetFilename(string filepath, bool includeExtension);
 	static string GetFolderName(string filepath);
 
@@ -5,35 +5,119 @@
 GifRecorder::GifRecorder()
 {
 	_gif.reset(new GifWriter());
+	_recording = false;
+	_stopFlag = false;
+	_recordedFrames = 0;
+	_droppedFrames = 0;
 }
 
 GifRecorder::~GifRecorder()
 {
 	StopRecording();
+
+	for(uint8_t* buffer : _buffers) {
+		delete[] buffer;
+	}
 }
 
 bool GifRecorder::StartRecording(string filename, uint32_t width, uint32_t height, uint32_t bpp, uint32_t audioSampleRate, double fps)
 {
 	_outputFile = filename;
-	_recording = GifBegin(_gif.get(), filename.c_str(), width, height, 2, 8, false);
+	_width = width;
+	_height = height;
+	_frameBufferLength = width * height * 4;
+	_poolSize = std::max(MinPoolSize, std::min(MaxPoolSize, MaxPoolMemory / std::max<uint32_t>(_frameBufferLength, 1)));
 	_frameCounter = 0;
+
+	_recording = GifBegin(_gif.get(), filename.c_str(), width, height, 2, 8, false);
+	if(_recording) {
+		_stopFlag = false;
+		_encoderThread = std::thread([=]() { EncodeFrames(); });
+	}
 	return _recording;
 }
 
 void GifRecorder::StopRecording()
 {
 	if(_recording) {
+		_recording = false;
+
+		//Encode the frames that are still queued before closing the file
+		_stopFlag = true;
+		_waitFrame.Signal();
+		_encoderThread.join();
+
 		GifEnd(_gif.get());
 	}
 }
 
+uint8_t* GifRecorder::AcquireBuffer()
+{
+	auto lock = _queueLock.AcquireSafe();
+	if(!_freeBuffers.empty()) {
+		uint8_t* buffer = _freeBuffers.back();
+		_freeBuffers.pop_back();
+		return buffer;
+	} else if(_buffers.size() < _poolSize) {
+		uint8_t* buffer = new uint8_t[_frameBufferLength];
+		_buffers.push_back(buffer);
+		return buffer;
+	}
+	return nullptr;
+}
+
+void GifRecorder::EncodeFrames()
+{
+	while(true) {
+		bool stopping = _stopFlag;
+		uint8_t* frame = nullptr;
+		{
+			auto lock = _queueLock.AcquireSafe();
+			if(!_frameQueue.empty()) {
+				frame = _frameQueue.front();
+				_frameQueue.pop_front();
+			}
+		}
+
+		if(!frame) {
+			if(stopping) {
+				break;
+			}
+			_waitFrame.Wait();
+			continue;
+		}
+
+		GifWriteFrame(_gif.get(), frame, _width, _height, 2, 8, false);
+		_recordedFrames++;
+
+		auto lock = _queueLock.AcquireSafe();
+		_freeBuffers.push_back(frame);
+	}
+}
+
 void GifRecorder::AddFrame(void* frameBuffer, uint32_t width, uint32_t height, double fps)
 {
+	if(!_recording || width != _width || height != _height) {
+		return;
+	}
+
 	_frameCounter++;
 	
 	if(fps < 55 || (_frameCounter % 6) != 0) {
 		//At 60 FPS, skip 1 of every 6 frames (max FPS for GIFs is 50fps)
-		GifWriteFrame(_gif.get(), (uint8_t*)frameBuffer, width, height, 2, 8, false);
+		uint8_t* buffer = AcquireBuffer();
+		if(!buffer) {
+			_droppedFrames++;
+			return;
+		}
+
+		memcpy(buffer, frameBuffer, _frameBufferLength);
+		{
+			auto lock = _queueLock.AcquireSafe();
+			_frameQueue.push_back(buffer);
+			_maxQueueDepth = std::max(_maxQueueDepth, (uint32_t)(_buffers.size() - _freeBuffers.size()));
+		}
+		_waitFrame.Signal();
 	}
 }
 
@@ -49,4 +133,15 @@ bool GifRecorder::IsRecording()
 string GifRecorder::GetOutputFile()
 {
 	return _outputFile;
+}
+
+VideoRecorderStatistics GifRecorder::GetStatistics()
+{
+	auto lock = _queueLock.AcquireSafe();
+	VideoRecorderStatistics stats = {};
+	stats.RecordedFrames = _recordedFrames;
+	stats.DroppedFrames = _droppedFrames;
+	stats.QueueDepth = (uint32_t)(_buffers.size() - _freeBuffers.size());
+	stats.MaxQueueDepth = _maxQueueDepth;
+	return stats;
 }
\ No newline at end of file
@@ -1,17 +1,45 @@
 #pragma once
 #include "stdafx.h"
+#include <thread>
+#include <deque>
 #include "../Utilities/IVideoRecorder.h"
+#include "../Utilities/AutoResetEvent.h"
+#include "../Utilities/SimpleLock.h"
 
 struct GifWriter;
 
 class GifRecorder : public IVideoRecorder
 {
 private:
+	//Frames are copied into a pool of recycled buffers and encoded by a separate thread
+	static constexpr uint32_t MaxPoolMemory = 64 * 1024 * 1024;
+	static constexpr uint32_t MinPoolSize = 4;
+	static constexpr uint32_t MaxPoolSize = 120;
+
 	std::unique_ptr<GifWriter> _gif;
-	bool _recording = false;
+	atomic<bool> _recording;
 	uint32_t _frameCounter = 0;
 	string _outputFile;
 
+	std::thread _encoderThread;
+	atomic<bool> _stopFlag;
+	SimpleLock _queueLock;
+	AutoResetEvent _waitFrame;
+	std::deque<uint8_t*> _frameQueue;
+	vector<uint8_t*> _buffers;
+	vector<uint8_t*> _freeBuffers;
+	uint32_t _poolSize = 0;
+	uint32_t _frameBufferLength = 0;
+	uint32_t _width = 0;
+	uint32_t _height = 0;
+
+	atomic<uint32_t> _recordedFrames;
+	atomic<uint32_t> _droppedFrames;
+	uint32_t _maxQueueDepth = 0;
+
+	uint8_t* AcquireBuffer();
+	void EncodeFrames();
+
 public:
 	GifRecorder();
 	~GifRecorder();
@@ -22,4 +50,5 @@ public:
 	void AddSound(int16_t* soundBuffer, uint32_t sampleCount, uint32_t sampleRate) override;
 	bool IsRecording() override;
 	string GetOutputFile() override;
+	VideoRecorderStatistics GetStatistics() override;
 };
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "stdafx.h"
+#include <thread>
+#include "HashUtilities.h"
+#include "CRC32.h"
+#include "sha1.h"
+#include "md5.h"
+#include "HexUtilities.h"
+
+HashValues HashUtilities::GetHashes(vector<uint8_t> &data, int hashTypes)
+{
+	return GetHashes(data.data(), data.size(), hashTypes);
+}
+
+HashValues HashUtilities::GetHashes(const uint8_t* data, size_t size, int hashTypes)
+{
+	bool crc32 = (hashTypes & HashType::Crc32Hash) != 0;
+	bool sha1 = (hashTypes & HashType::Sha1Hash) != 0;
+	bool md5 = (hashTypes & HashType::Md5Hash) != 0;
+
+	uint32_t crc = 0;
+	SHA1 sha1Checksum;
+	MD5_CTX md5Context;
+	MD5_Init(&md5Context);
+
+	auto updateCrc = [&](const uint8_t* buffer, size_t length) { crc = CRC32::UpdateCRC(crc, buffer, length); };
+	auto updateSha1 = [&](const uint8_t* buffer, size_t length) { sha1Checksum.update(buffer, length); };
+	auto updateMd5 = [&](const uint8_t* buffer, size_t length) { MD5_Update(&md5Context, buffer, (unsigned long)length); };
+
+	if(size >= ParallelThreshold && (crc32 + sha1 + md5) > 1) {
+		//Large files (e.g multicarts): the hashes are independent, calculate them at the same time on separate threads
+		vector<std::thread> threads;
+		if(crc32) {
+			threads.push_back(std::thread([&]() { updateCrc(data, size); }));
+		}
+		if(md5) {
+			threads.push_back(std::thread([&]() { updateMd5(data, size); }));
+		}
+		if(sha1) {
+			updateSha1(data, size);
+		}
+		for(std::thread &thread : threads) {
+			thread.join();
+		}
+	} else {
+		for(size_t offset = 0; offset < size; offset += ChunkSize) {
+			size_t length = std::min(ChunkSize, size - offset);
+			if(crc32) {
+				updateCrc(data + offset, length);
+			}
+			if(sha1) {
+				updateSha1(data + offset, length);
+			}
+			if(md5) {
+				updateMd5(data + offset, length);
+			}
+		}
+	}
+
+	HashValues result;
+	result.Crc32 = crc;
+	if(sha1) {
+		result.Sha1 = sha1Checksum.final();
+	}
+	if(md5) {
+		vector<uint8_t> md5Hash(16);
+		MD5_Final(md5Hash.data(), &md5Context);
+		result.Md5 = HexUtilities::ToHex(md5Hash);
+	}
+	return result;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "stdafx.h"
+
+enum HashType
+{
+	Crc32Hash = 1,
+	Sha1Hash = 2,
+	Md5Hash = 4
+};
+
+struct HashValues
+{
+	uint32_t Crc32 = 0;
+	string Sha1;
+	string Md5;
+};
+
+class HashUtilities
+{
+private:
+	//Buffers larger than this are hashed by one thread per hash type, smaller ones are processed in chunks that stay in the cache
+	static constexpr size_t ParallelThreshold = 4 * 1024 * 1024;
+	static constexpr size_t ChunkSize = 64 * 1024;
+
+public:
+	//Computes all the requested hashes (combination of HashType values) while reading the data only once
+	static HashValues GetHashes(const uint8_t* data, size_t size, int hashTypes);
+	static HashValues GetHashes(vector<uint8_t> &data, int hashTypes);
+};
@@ -1,6 +1,14 @@
 #pragma once
 #include "stdafx.h"
 
+struct VideoRecorderStatistics
+{
+	uint32_t RecordedFrames;
+	uint32_t DroppedFrames;
+	uint32_t QueueDepth;
+	uint32_t MaxQueueDepth;
+};
+
 class IVideoRecorder
 {
 public:
@@ -12,4 +20,5 @@ public:
 
 	virtual bool IsRecording() = 0;
 	virtual string GetOutputFile() = 0;
+	virtual VideoRecorderStatistics GetStatistics() { return {}; }
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "stdafx.h"
+#include "MappedFile.h"
+#include "UTF8Util.h"
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+	#define HAS_MMAP
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(string filepath)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileW(utf8::utf8::decode(filepath).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(fileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0 || (uint64_t)fileSize.QuadPart > SIZE_MAX) {
+		//Empty files can't be mapped
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	if(mappingHandle == nullptr) {
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	void* data = MapViewOfFile(mappingHandle, FILE_MAP_COPY, 0, 0, 0);
+	if(data == nullptr) {
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	_fileHandle = fileHandle;
+	_mappingHandle = mappingHandle;
+	_data = (uint8_t*)data;
+	_size = (size_t)fileSize.QuadPart;
+#elif defined(HAS_MMAP)
+	int fd = open(filepath.c_str(), O_RDONLY);
+	if(fd < 0) {
+		return false;
+	}
+
+	struct stat fileInfo;
+	if(fstat(fd, &fileInfo) != 0 || !S_ISREG(fileInfo.st_mode) || fileInfo.st_size == 0) {
+		//Empty files can't be mapped
+		close(fd);
+		return false;
+	}
+
+	void* data = mmap(nullptr, (size_t)fileInfo.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+	//The mapping stays valid once the file descriptor is closed
+	close(fd);
+	if(data == MAP_FAILED) {
+		return false;
+	}
+
+	_data = (uint8_t*)data;
+	_size = (size_t)fileInfo.st_size;
+#else
+	//Not supported on this platform, VirtualFile reads the file instead
+	return false;
+#endif
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if(!_data) {
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(_data);
+	CloseHandle((HANDLE)_mappingHandle);
+	CloseHandle((HANDLE)_fileHandle);
+	_mappingHandle = nullptr;
+	_fileHandle = nullptr;
+#elif defined(HAS_MMAP)
+	munmap(_data, _size);
+#endif
+
+	_data = nullptr;
+	_size = 0;
+}
+
+uint8_t* MappedFile::GetData()
+{
+	return _data;
+}
+
+size_t MappedFile::GetSize()
+{
+	return _size;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "stdafx.h"
+
+//Maps a file in memory (copy-on-write: writes only change the process' copy of the pages that are modified, the file itself is never modified)
+//The file's pages are only read from the disk when they are accessed, and are shared with the OS' file cache
+class MappedFile
+{
+private:
+	uint8_t* _data = nullptr;
+	size_t _size = 0;
+
+#ifdef _WIN32
+	void* _fileHandle = nullptr;
+	void* _mappingHandle = nullptr;
+#endif
+
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(string filepath);
+	void Close();
+
+	uint8_t* GetData();
+	size_t GetSize();
+};
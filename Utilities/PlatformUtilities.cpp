@@ -3,6 +3,9 @@
 
 #if !defined(LIBRETRO) && defined(_WIN32)
 #include <Windows.h>
+#include <Psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
 #endif
 
 bool PlatformUtilities::_highResTimerEnabled = false;
@@ -42,4 +45,22 @@ void PlatformUtilities::RestoreTimerResolution()
 		_highResTimerEnabled = false;
 	}
 	#endif
-}
\ No newline at end of file
+}
+
+uint64_t PlatformUtilities::GetMemoryUsage()
+{
+	#if !defined(LIBRETRO) && defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if(K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.WorkingSetSize;
+	}
+	#elif defined(__linux__)
+	//The second value of statm is the resident set size, in pages
+	ifstream statm("/proc/self/statm");
+	uint64_t size = 0, resident = 0;
+	if(statm >> size >> resident) {
+		return resident * (uint64_t)sysconf(_SC_PAGESIZE);
+	}
+	#endif
+	return 0;
+}
@@ -12,4 +12,7 @@ public:
 
 	static void EnableHighResolutionTimer();
 	static void RestoreTimerResolution();
+
+	//Returns the amount of physical memory used by the process, in bytes (0 if not supported on this platform)
+	static uint64_t GetMemoryUsage();
 };
\ No newline at end of file
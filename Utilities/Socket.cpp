@@ -13,9 +13,13 @@ using namespace std;
 	#include <winsock2.h>
 	#include <Ws2tcpip.h>
 	#include <Windows.h>
+
+	#define poll WSAPoll
 #else
 	#include <sys/types.h>
 	#include <sys/socket.h>
+	#include <sys/uio.h>
+	#include <poll.h>
 	#include <sys/ioctl.h>
 	#include <netinet/in.h>
 	#include <arpa/inet.h>
@@ -37,6 +41,7 @@ using namespace std;
 #endif
 
 #define BUFFER_SIZE 200000
+#define MAX_GATHER_BUFFERS 64
 
 Socket::Socket()
 {
@@ -121,6 +126,9 @@ void Socket::Close()
 	std::cout << "Socket closed." << std::endl;
 	shutdown(_socket, SD_SEND);
 	closesocket(_socket);
+
+	//The descriptor can be reused by the OS as soon as it is closed - make sure the destructor doesn't close it a second time
+	_socket = INVALID_SOCKET;
 	SetConnectionErrorFlag();
 }
 
@@ -272,6 +280,71 @@ void Socket::SendBuffer()
 	_bufferPosition = 0;
 }
 
+int Socket::GatherSend(vector<SocketBuffer> &buffers)
+{
+	int retryCount = 15;
+	int totalSent = 0;
+	size_t index = 0;
+	int offset = 0;
+
+	while(true) {
+		//Skip the buffers that were fully sent (partial sends are resumed at the right offset)
+		while(index < buffers.size() && offset >= buffers[index].Length) {
+			offset -= buffers[index].Length;
+			index++;
+		}
+		if(index >= buffers.size()) {
+			break;
+		}
+
+		int count = (int)std::min<size_t>(buffers.size() - index, MAX_GATHER_BUFFERS);
+
+		#ifdef _WIN32
+			WSABUF wsaBuffers[MAX_GATHER_BUFFERS];
+			for(int i = 0; i < count; i++) {
+				SocketBuffer &buffer = buffers[index + i];
+				wsaBuffers[i].buf = (char*)buffer.Data + (i == 0 ? offset : 0);
+				wsaBuffers[i].len = buffer.Length - (i == 0 ? offset : 0);
+			}
+			DWORD bytesSent = 0;
+			int returnVal = WSASend(_socket, wsaBuffers, count, &bytesSent, 0, nullptr, nullptr) == 0 ? (int)bytesSent : SOCKET_ERROR;
+		#else
+			iovec vectors[MAX_GATHER_BUFFERS];
+			for(int i = 0; i < count; i++) {
+				SocketBuffer &buffer = buffers[index + i];
+				vectors[i].iov_base = (char*)buffer.Data + (i == 0 ? offset : 0);
+				vectors[i].iov_len = buffer.Length - (i == 0 ? offset : 0);
+			}
+			msghdr message = {};
+			message.msg_iov = vectors;
+			message.msg_iovlen = count;
+			int returnVal = (int)sendmsg(_socket, &message, 0);
+		#endif
+
+		if(returnVal > 0) {
+			totalSent += returnVal;
+			offset += returnVal;
+		} else {
+			int nError = returnVal == SOCKET_ERROR ? WSAGetLastError() : 0;
+			if(nError != 0 && !WouldBlock(nError)) {
+				SetConnectionErrorFlag();
+				break;
+			}
+
+			retryCount--;
+			if(retryCount == 0) {
+				//Connection seems dead, close it.
+				std::cout << "Unable to send data, closing socket." << std::endl;
+				Close();
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(10));
+		}
+	}
+
+	return totalSent;
+}
+
 int Socket::Recv(char *buf, int len, int flags)
 {
 	int returnVal = recv(_socket, buf, len, flags);
@@ -291,6 +364,34 @@ int Socket::Recv(char *buf, int len, int flags)
 	return returnVal;
 }
 
+int Socket::Poll(vector<Socket*> &sockets, vector<bool> &readable, int timeout)
+{
+	vector<pollfd> fds(sockets.size());
+	for(size_t i = 0; i < sockets.size(); i++) {
+		fds[i].fd = sockets[i]->_socket;
+		fds[i].events = POLLIN;
+		fds[i].revents = 0;
+	}
+
+	readable.assign(sockets.size(), false);
+	int returnVal = poll(fds.data(), (unsigned long)fds.size(), timeout);
+	if(returnVal == SOCKET_ERROR) {
+		//Avoid busy looping if poll fails for any reason
+		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(timeout));
+		return 0;
+	}
+
+	int readyCount = 0;
+	for(size_t i = 0; i < sockets.size(); i++) {
+		//Errors/hang ups are reported as readable, the next Recv() call will flag the socket as closed
+		if(fds[i].revents & (POLLIN | POLLERR | POLLHUP | POLLNVAL)) {
+			readable[i] = true;
+			readyCount++;
+		}
+	}
+	return readyCount;
+}
+
 #else
 
 //Libretro port does not need sockets.
@@ -360,8 +461,19 @@ void Socket::SendBuffer()
 {
 }
 
+int Socket::GatherSend(vector<SocketBuffer> &buffers)
+{
+	return 0;
+}
+
 int Socket::Recv(char *buf, int len, int flags)
 {
 	return 0;
 }
+
+int Socket::Poll(vector<Socket*> &sockets, vector<bool> &readable, int timeout)
+{
+	readable.assign(sockets.size(), false);
+	return 0;
+}
 #endif
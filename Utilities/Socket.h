@@ -2,6 +2,12 @@
 
 #include "stdafx.h"
 
+struct SocketBuffer
+{
+	const char* Data;
+	int Length;
+};
+
 class Socket
 {
 private:
@@ -36,5 +42,12 @@ public:
 	int Send(char *buf, int len, int flags);
 	void BufferedSend(char *buf, int len);
 	void SendBuffer();
+
+	//Sends all the buffers with as few system calls as possible (sendmsg/WSASend), without copying them into the send buffer first
+	int GatherSend(vector<SocketBuffer> &buffers);
 	int Recv(char *buf, int len, int flags);
+
+	//Blocks until at least one of the sockets can be read from (or has a pending connection/error), or until the timeout (ms) expires
+	//readable[i] is set to true for each socket that is ready, returns the number of ready sockets
+	static int Poll(vector<Socket*> &sockets, vector<bool> &readable, int timeout);
 };
@@ -24,10 +24,20 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <thread>
 
 #include "miniz.h"
 #include "ZmbvCodec.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define ZMBV_SSE2
+	#include <emmintrin.h>
+#endif
+
+#ifdef __AVX2__
+	#include <immintrin.h>
+#endif
+
 #define DBZV_VERSION_HIGH 0
 #define DBZV_VERSION_LOW 1
 
@@ -35,6 +45,7 @@
 #define COMPRESSION_ZLIB 1
 
 #define MAX_VECTOR	16
+#define SEARCH_RANGE	10
 
 #define Mask_KeyFrame			0x01
 #define	Mask_DeltaPalette		0x02
@@ -77,9 +88,13 @@ bool ZmbvCodec::SetupBuffers(zmbv_format_t _format, int blockwidth, int blockhei
 
 	buf1 = new unsigned char[bufsize];
 	buf2 = new unsigned char[bufsize];
-	work = new unsigned char[bufsize];
+	for(int i = 0; i < BaseCodec::SlotCount; i++) {
+		slots[i].work = new unsigned char[bufsize];
+		memset(slots[i].work, 0, bufsize);
+	}
+	work = slots[0].work;
 
-	int xblocks = (width/blockwidth);
+	xblocks = (width/blockwidth);
 	int xleft = width % blockwidth;
 	if (xleft) xblocks++;
 	int yblocks = (height/blockheight);
@@ -114,13 +129,14 @@ bool ZmbvCodec::SetupBuffers(zmbv_format_t _format, int blockwidth, int blockhei
 
 	memset(buf1,0,bufsize);
 	memset(buf2,0,bufsize);
-	memset(work,0,bufsize);
 	oldframe=buf1;
 	newframe=buf2;
 	format = _format;
 
 	_bufSize = NeededSize(width, height, format);
-	_buf = new uint8_t[_bufSize];
+	for(int i = 0; i < BaseCodec::SlotCount; i++) {
+		slots[i].buf = new uint8_t[_bufSize];
+	}
 
 	return true;
 }
@@ -130,7 +146,7 @@ void ZmbvCodec::CreateVectorTable(void) {
 	VectorCount=1;
 
 	VectorTable[0].x=VectorTable[0].y=0;
-	for (s=1;s<=10;s++) {
+	for (s=1;s<=SEARCH_RANGE;s++) {
 		for (y=0-s;y<=0+s;y++) for (x=0-s;x<=0+s;x++) {
 			if (abs(x)==s || abs(y)==s) {
 				VectorTable[VectorCount].x=x;
@@ -173,6 +189,112 @@ INLINE int ZmbvCodec::CompareBlock(int vx,int vy,FrameBlock * block) {
 	return ret;
 }
 
+template<class P>
+INLINE void ZmbvCodec::PossibleBlockRow(int vy,FrameBlock * block,int * changes) {
+	//Result of PossibleBlock for all horizontal vectors (-10 to +10) for the given vertical vector
+	for (int vx=-SEARCH_RANGE;vx<=SEARCH_RANGE;vx++) {
+		changes[vx+SEARCH_RANGE]=PossibleBlock<P>(vx, vy, block);
+	}
+}
+
+#ifdef ZMBV_SSE2
+static INLINE int SumLanes(__m128i sum)
+{
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+static INLINE __m128i LoadRgb(const int32_t* p, __m128i mask)
+{
+	return _mm_and_si128(_mm_loadu_si128((const __m128i*)p), mask);
+}
+
+//32bpp versions of PossibleBlockRow/CompareBlock - they return the same values as the generic versions (number of pixels with a different RGB value),
+//but compare 4 (SSE2) or 8 (AVX2) pixels at once
+template<>
+INLINE void ZmbvCodec::PossibleBlockRow<int32_t>(int vy,FrameBlock * block,int * changes) {
+	//Each sampled pixel of the new block is compared against the 24 pixels around it in the old frame (x-10 to x+13),
+	//which checks all horizontal vectors at once. Each lane counts the identical pixels for one vector.
+	int32_t same[24];
+	int32_t * pold=((int32_t*)oldframe)+block->start+(vy*pitch)-SEARCH_RANGE;
+	int32_t * pnew=((int32_t*)newframe)+block->start;
+	int samples=((block->dx+3)/4)*((block->dy+3)/4);
+#ifdef __AVX2__
+	const __m256i mask256 = _mm256_set1_epi32(0x00ffffff);
+	__m256i sum[3] = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+	for (int y=0;y<block->dy;y+=4) {
+		for (int x=0;x<block->dx;x+=4) {
+			__m256i n=_mm256_set1_epi32(pnew[y*pitch+x] & 0x00ffffff);
+			for (int i=0;i<3;i++) {
+				__m256i o=_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(pold+y*pitch+x+i*8)), mask256);
+				sum[i]=_mm256_sub_epi32(sum[i], _mm256_cmpeq_epi32(o, n));
+			}
+		}
+	}
+	for (int i=0;i<3;i++) {
+		_mm256_storeu_si256((__m256i*)&same[i*8], sum[i]);
+	}
+#else
+	const __m128i mask = _mm_set1_epi32(0x00ffffff);
+	__m128i sum[6] = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+	for (int y=0;y<block->dy;y+=4) {
+		for (int x=0;x<block->dx;x+=4) {
+			__m128i n=_mm_set1_epi32(pnew[y*pitch+x] & 0x00ffffff);
+			for (int i=0;i<6;i++) {
+				sum[i]=_mm_sub_epi32(sum[i], _mm_cmpeq_epi32(LoadRgb(pold+y*pitch+x+i*4, mask), n));
+			}
+		}
+	}
+	for (int i=0;i<6;i++) {
+		_mm_storeu_si128((__m128i*)&same[i*4], sum[i]);
+	}
+#endif
+	for (int vx=0;vx<=SEARCH_RANGE*2;vx++) {
+		changes[vx]=samples-same[vx];
+	}
+}
+
+template<>
+INLINE int ZmbvCodec::CompareBlock<int32_t>(int vx,int vy,FrameBlock * block) {
+	int ret=0;
+	int compared=0;
+	int32_t * pold=((int32_t*)oldframe)+block->start+(vy*pitch)+vx;
+	int32_t * pnew=((int32_t*)newframe)+block->start;
+#ifdef __AVX2__
+	const __m256i mask256 = _mm256_set1_epi32(0x00ffffff);
+	__m256i same256 = _mm256_setzero_si256();
+#endif
+	const __m128i mask = _mm_set1_epi32(0x00ffffff);
+	__m128i same = _mm_setzero_si128();
+	for (int y=0;y<block->dy;y++) {
+		int x=0;
+#ifdef __AVX2__
+		for (;x+8<=block->dx;x+=8) {
+			__m256i a=_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(pold+x)), mask256);
+			__m256i b=_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(pnew+x)), mask256);
+			same256=_mm256_sub_epi32(same256, _mm256_cmpeq_epi32(a, b));
+			compared+=8;
+		}
+#endif
+		for (;x+4<=block->dx;x+=4) {
+			same=_mm_sub_epi32(same, _mm_cmpeq_epi32(LoadRgb(pold+x, mask), LoadRgb(pnew+x, mask)));
+			compared+=4;
+		}
+		for (;x<block->dx;x++) {
+			int test=0-((pold[x]-pnew[x])&0x00ffffff);
+			ret-=(test>>31);
+		}
+		pold+=pitch;
+		pnew+=pitch;
+	}
+#ifdef __AVX2__
+	same=_mm_add_epi32(same, _mm_add_epi32(_mm256_castsi256_si128(same256), _mm256_extracti128_si256(same256, 1)));
+#endif
+	return ret + compared - SumLanes(same);
+}
+#endif
+
 template<class P>
 INLINE void ZmbvCodec::AddXorBlock(int vx,int vy,FrameBlock * block) {
 	P * pold=((P*)oldframe)+block->start+(vy*pitch)+vx;
@@ -187,36 +309,76 @@ INLINE void ZmbvCodec::AddXorBlock(int vx,int vy,FrameBlock * block) {
 	}
 }
 
+template<class P>
+void ZmbvCodec::FindBlockVectors(int firstRow, int rowStep) {
+	//Motion search for every [rowStep]th row of blocks, starting at [firstRow]
+	//Only reads the old & new frames and only writes to its own blocks, so several rows can be processed in parallel
+	int yblocks = blockcount / xblocks;
+	//PossibleBlock results, calculated one vertical vector at a time as the search needs them
+	int possibleChanges[SEARCH_RANGE*2+1][SEARCH_RANGE*2+1];
+	for (int row=firstRow;row<yblocks;row+=rowStep) {
+		for (int b=row*xblocks;b<(row+1)*xblocks;b++) {
+			FrameBlock * block=&blocks[b];
+			int bestvx = 0;
+			int bestvy = 0;
+			int bestchange=CompareBlock<P>(0,0, block);
+			int possibles=64;
+			uint32_t rowsDone=0;
+			for (int v=0;v<VectorCount && possibles;v++) {
+				if (bestchange<4) break;
+				int vx = VectorTable[v].x;
+				int vy = VectorTable[v].y;
+				int * possibleRow = possibleChanges[vy+SEARCH_RANGE];
+				if (!(rowsDone & (1 << (vy+SEARCH_RANGE)))) {
+					PossibleBlockRow<P>(vy, block, possibleRow);
+					rowsDone |= 1 << (vy+SEARCH_RANGE);
+				}
+				if (possibleRow[vx+SEARCH_RANGE] < 4) {
+					possibles--;
+					int testchange=CompareBlock<P>(vx,vy, block);
+					if (testchange<bestchange) {
+						bestchange=testchange;
+						bestvx = vx;
+						bestvy = vy;
+					}
+				}
+			}
+			block->vx = bestvx;
+			block->vy = bestvy;
+			block->change = bestchange;
+		}
+	}
+}
+
 template<class P>
 void ZmbvCodec::AddXorFrame(void) {
+	//Rows are interleaved between the threads, to keep the load balanced when only part of the screen changes
+	//Small frames are not worth the cost of starting the threads
+	int yblocks = blockcount / xblocks;
+	int searchThreads = std::min(threadCount, yblocks / 4);
+	if (searchThreads > 1) {
+		vector<std::thread> threads;
+		for (int i=1;i<searchThreads;i++) {
+			threads.push_back(std::thread(&ZmbvCodec::FindBlockVectors<P>, this, i, searchThreads));
+		}
+		FindBlockVectors<P>(0, searchThreads);
+		for (std::thread &thread : threads) {
+			thread.join();
+		}
+	} else {
+		FindBlockVectors<P>(0, 1);
+	}
+
 	signed char * vectors=(signed char*)&work[workUsed];
 	/* Align the following xor data on 4 byte boundary*/
 	workUsed=(workUsed + blockcount*2 +3) & ~3;
 	for (int b=0;b<blockcount;b++) {
 		FrameBlock * block=&blocks[b];
-		int bestvx = 0;
-		int bestvy = 0;
-		int bestchange=CompareBlock<P>(0,0, block);
-		int possibles=64;
-		for (int v=0;v<VectorCount && possibles;v++) {
-			if (bestchange<4) break;
-			int vx = VectorTable[v].x;
-			int vy = VectorTable[v].y;
-			if (PossibleBlock<P>(vx, vy, block) < 4) {
-				possibles--;
-				int testchange=CompareBlock<P>(vx,vy, block);
-				if (testchange<bestchange) {
-					bestchange=testchange;
-					bestvx = vx;
-					bestvy = vy;
-				}
-			}
-		}
-		vectors[b*2+0]=(bestvx << 1);
-		vectors[b*2+1]=(bestvy << 1);
-		if (bestchange) {
+		vectors[b*2+0]=(block->vx << 1);
+		vectors[b*2+1]=(block->vy << 1);
+		if (block->change) {
 			vectors[b*2+0]|=1;
-			AddXorBlock<P>(bestvx, bestvy, block);
+			AddXorBlock<P>(block->vx, block->vy, block);
 		}
 	}
 }
@@ -226,13 +388,14 @@ bool ZmbvCodec::SetupCompress( int _width, int _height, uint32_t compressionLeve
 	height = _height;
 	pitch = _width + 2*MAX_VECTOR;
 	format = ZMBV_FORMAT_NONE;
+	threadCount = std::max(1, std::min(8, (int)std::thread::hardware_concurrency()));
 	if (deflateInit (&zstream, compressionLevel) != Z_OK)
 		return false;
 
 	return true;
 }
 
-bool ZmbvCodec::PrepareCompressFrame(int flags, zmbv_format_t _format, char * pal)
+bool ZmbvCodec::PrepareCompressFrame(int slot, int flags, zmbv_format_t _format, char * pal)
 {
 	int i;
 	unsigned char *firstByte;
@@ -247,10 +410,13 @@ bool ZmbvCodec::PrepareCompressFrame(int flags, zmbv_format_t _format, char * pa
 	newframe = oldframe;
 	oldframe = copyFrame;
 
+	work = slots[slot].work;
+	slots[slot].isKeyFrame = (flags & 1) != 0;
+
 	compressInfo.linesDone = 0;
 	compressInfo.writeSize = _bufSize;
 	compressInfo.writeDone = 1;
-	compressInfo.writeBuf = (unsigned char *)_buf;
+	compressInfo.writeBuf = (unsigned char *)slots[slot].buf;
 	/* Set a pointer to the first byte which will contain info about this frame */
 	firstByte = compressInfo.writeBuf;
 	*firstByte = 0;
@@ -280,8 +446,6 @@ bool ZmbvCodec::PrepareCompressFrame(int flags, zmbv_format_t _format, char * pa
 				work[workUsed++] = palette[i*4+2];
 			}
 		}
-		/* Restart deflate */
-		deflateReset(&zstream);
 	} else {
 		if (palsize && pal && memcmp(pal, palette, palsize * 4)) {
 			*firstByte |= Mask_DeltaPalette;
@@ -309,10 +473,9 @@ void ZmbvCodec::CompressLines(int lineCount, void *lineData[])
 	}
 }
 
-int ZmbvCodec::FinishCompressFrame(uint8_t** compressedData)
+void ZmbvCodec::AddFrameData(int slot)
 {
-	unsigned char firstByte = *compressInfo.writeBuf;
-	if (firstByte & Mask_KeyFrame) {
+	if (slots[slot].isKeyFrame) {
 		int i;
 		/* Add the full frame data */
 		unsigned char * readFrame = newframe + pixelsize*(MAX_VECTOR+MAX_VECTOR*pitch);	
@@ -338,20 +501,32 @@ int ZmbvCodec::FinishCompressFrame(uint8_t** compressedData)
 				break;
 		}
 	}
+	slots[slot].workUsed = workUsed;
+	slots[slot].writeDone = compressInfo.writeDone;
+}
+
+int ZmbvCodec::FinishCompressFrame(int slot, uint8_t** compressedData)
+{
+	EncodeSlot &encodeSlot = slots[slot];
+	if (encodeSlot.isKeyFrame) {
+		/* Restart deflate */
+		deflateReset(&zstream);
+	}
+
 	/* Create the actual frame with compression */
-	zstream.next_in = (Bytef *)work;
-	zstream.avail_in = workUsed;
+	zstream.next_in = (Bytef *)encodeSlot.work;
+	zstream.avail_in = encodeSlot.workUsed;
 	zstream.total_in = 0;
 
-	zstream.next_out = (Bytef *)(compressInfo.writeBuf + compressInfo.writeDone);
-	zstream.avail_out = compressInfo.writeSize - compressInfo.writeDone;
+	zstream.next_out = (Bytef *)(encodeSlot.buf + encodeSlot.writeDone);
+	zstream.avail_out = _bufSize - encodeSlot.writeDone;
 	zstream.total_out = 0;
 	
 	deflate(&zstream, Z_SYNC_FLUSH);
 
-	*compressedData = _buf;
+	*compressedData = encodeSlot.buf;
 
-	return compressInfo.writeDone + zstream.total_out;
+	return encodeSlot.writeDone + zstream.total_out;
 }
 
 void ZmbvCodec::FreeBuffers()
@@ -368,14 +543,17 @@ void ZmbvCodec::FreeBuffers()
 		delete[] buf2;
 		buf2= nullptr;
 	}
-	if (work) {
-		delete[] work;
-		work= nullptr;
-	}
-	if(_buf) {
-		delete[] _buf;
-		_buf = nullptr;
+	for(int i = 0; i < BaseCodec::SlotCount; i++) {
+		if(slots[i].work) {
+			delete[] slots[i].work;
+			slots[i].work = nullptr;
+		}
+		if(slots[i].buf) {
+			delete[] slots[i].buf;
+			slots[i].buf = nullptr;
+		}
 	}
+	work = nullptr;
 }
 
 ZmbvCodec::ZmbvCodec() 
@@ -390,8 +568,17 @@ ZmbvCodec::ZmbvCodec()
 
 int ZmbvCodec::CompressFrame(bool isKeyFrame, uint8_t *frameData, uint8_t** compressedData)
 {
-	if(!PrepareCompressFrame(isKeyFrame ? 1 : 0, ZMBV_FORMAT_32BPP, nullptr)) {
-		return -1;
+	PrepareFrame(0, isKeyFrame, frameData);
+	return CompressPreparedFrame(0, compressedData);
+}
+
+void ZmbvCodec::PrepareFrame(int slot, bool isKeyFrame, uint8_t *frameData)
+{
+	//Copies the frame and builds the xor/motion vector data - this only uses the slot's buffers and the last 2 frames,
+	//so it can run while the previous frame is being compressed by CompressPreparedFrame
+	if(!PrepareCompressFrame(slot, isKeyFrame ? 1 : 0, ZMBV_FORMAT_32BPP, nullptr)) {
+		slots[slot].workUsed = -1;
+		return;
 	}
 
 	for(int i = 0; i < height; i++) {
@@ -399,7 +586,15 @@ int ZmbvCodec::CompressFrame(bool isKeyFrame, uint8_t *frameData, uint8_t** comp
 		CompressLines(1, &rowPointer);
 	}
 
-	return FinishCompressFrame(compressedData);
+	AddFrameData(slot);
+}
+
+int ZmbvCodec::CompressPreparedFrame(int slot, uint8_t** compressedData)
+{
+	if(slots[slot].workUsed < 0) {
+		return -1;
+	}
+	return FinishCompressFrame(slot, compressedData);
 }
 
 const char* ZmbvCodec::GetFourCC()
@@ -48,6 +48,10 @@ private:
 	struct FrameBlock {
 		int start = 0;
 		int dx = 0,dy = 0;
+
+		//Result of the motion search for the current frame
+		int vx = 0, vy = 0;
+		int change = 0;
 	};
 	struct CodecVector {
 		int x = 0,y = 0;
@@ -68,6 +72,15 @@ private:
 		unsigned char	*writeBuf = nullptr;
 	} compressInfo;
 
+	//Work & output buffers for each slot (a frame can be prepared while the previous one is being compressed)
+	struct EncodeSlot {
+		unsigned char *work = nullptr;
+		int workUsed = 0;
+		uint8_t *buf = nullptr;
+		int writeDone = 0;
+		bool isKeyFrame = false;
+	} slots[BaseCodec::SlotCount];
+
 	CodecVector VectorTable[512] = {};
 	int VectorCount = 0;
 
@@ -76,8 +89,12 @@ private:
 	int bufsize = 0;
 
 	int blockcount = 0; 
+	int xblocks = 0;
 	FrameBlock * blocks = nullptr;
 
+	//Number of threads used for the motion search (each thread processes a band of block rows)
+	int threadCount = 1;
+
 	int workUsed = 0, workPos = 0;
 
 	int palsize = 0;
@@ -86,7 +103,6 @@ private:
 	zmbv_format_t format = zmbv_format_t::ZMBV_FORMAT_NONE;
 	int pixelsize = 0;
 
-	uint8_t* _buf = nullptr;
 	uint32_t _bufSize = 0;
 
 	z_stream zstream = {};
@@ -97,19 +113,24 @@ private:
 	bool SetupBuffers(zmbv_format_t format, int blockwidth, int blockheight);
 
 	template<class P> void AddXorFrame(void);
+	template<class P> void FindBlockVectors(int firstRow, int rowStep);
 	template<class P> INLINE int PossibleBlock(int vx,int vy,FrameBlock * block);
+	template<class P> INLINE void PossibleBlockRow(int vy,FrameBlock * block,int * changes);
 	template<class P> INLINE int CompareBlock(int vx,int vy,FrameBlock * block);
 	template<class P> INLINE void AddXorBlock(int vx,int vy,FrameBlock * block);
 
 	int NeededSize(int _width, int _height, zmbv_format_t _format);
 
 	void CompressLines(int lineCount, void *lineData[]);
-	bool PrepareCompressFrame(int flags, zmbv_format_t _format, char * pal);
-	int FinishCompressFrame(uint8_t** compressedData);
+	bool PrepareCompressFrame(int slot, int flags, zmbv_format_t _format, char * pal);
+	void AddFrameData(int slot);
+	int FinishCompressFrame(int slot, uint8_t** compressedData);
 
 public:
 	ZmbvCodec();
 	bool SetupCompress(int _width, int _height, uint32_t compressionLevel) override;
 	int CompressFrame(bool isKeyFrame, uint8_t *frameData, uint8_t** compressedData) override;
+	void PrepareFrame(int slot, bool isKeyFrame, uint8_t *frameData) override;
+	int CompressPreparedFrame(int slot, uint8_t** compressedData) override;
 	const char* GetFourCC() override;
 };
@@ -16,9 +16,8 @@
 //
 // Only RGBA8 is currently supported as an input format. (The alpha is ignored.)
 //
-// If capturing a buffer with a bottom-left origin (such as OpenGL), define GIF_FLIP_VERT
-// to automatically flip the buffer data when writing the image (the buffer itself is
-// unchanged.
+// Mesen: only the rectangle that changed since the last frame is written, and palette
+// generation/quantization are split across multiple threads. (GIF_FLIP_VERT is not supported)
 //
 // USAGE:
 // Create a GifWriter struct. Pass it to GifBegin() to initialize and write the header.
@@ -32,6 +31,8 @@
 #include <stdio.h>   // for FILE*
 #include <string.h>  // for memcpy and bzero
 #include <stdint.h>  // for integer typedefs
+#include <thread>    // for parallel palette generation/quantization
+#include <vector>
 
 // Define these macros to hook into a custom memory allocator.
 // TEMP_MALLOC and TEMP_FREE will only be called in stack fashion - frees in the reverse order of mallocs
@@ -204,7 +205,8 @@ void GifPartitionByMedian(uint8_t* image, int left, int right, int com, int need
 }
 
 // Builds a palette by creating a balanced k-d tree of all pixels in the image
-void GifSplitPalette(uint8_t* image, int numPixels, int firstElt, int lastElt, int splitElt, int splitDist, int treeNode, bool buildForDither, GifPalette* pal)
+// The first [parallelLevels] levels of the tree are built in parallel (both halves use separate parts of the image and palette)
+void GifSplitPalette(uint8_t* image, int numPixels, int firstElt, int lastElt, int splitElt, int splitDist, int treeNode, bool buildForDither, GifPalette* pal, int parallelLevels = 0)
 {
     if(lastElt <= firstElt || numPixels == 0)
         return;
@@ -315,8 +317,19 @@ void GifSplitPalette(uint8_t* image, int numPixels, int firstElt, int lastElt, i
     pal->treeSplitElt[treeNode] = (uint8_t)splitCom;
     pal->treeSplit[treeNode] = image[subPixelsA*4+splitCom];
 
-    GifSplitPalette(image,              subPixelsA, firstElt, splitElt, splitElt-splitDist, splitDist/2, treeNode*2,   buildForDither, pal);
-    GifSplitPalette(image+subPixelsA*4, subPixelsB, splitElt, lastElt,  splitElt+splitDist, splitDist/2, treeNode*2+1, buildForDither, pal);
+    if(parallelLevels > 0 && subPixelsA > 0 && subPixelsB > 0)
+    {
+        std::thread worker([=]() {
+            GifSplitPalette(image, subPixelsA, firstElt, splitElt, splitElt-splitDist, splitDist/2, treeNode*2, buildForDither, pal, parallelLevels-1);
+        });
+        GifSplitPalette(image+subPixelsA*4, subPixelsB, splitElt, lastElt, splitElt+splitDist, splitDist/2, treeNode*2+1, buildForDither, pal, parallelLevels-1);
+        worker.join();
+    }
+    else
+    {
+        GifSplitPalette(image,              subPixelsA, firstElt, splitElt, splitElt-splitDist, splitDist/2, treeNode*2,   buildForDither, pal);
+        GifSplitPalette(image+subPixelsA*4, subPixelsB, splitElt, lastElt,  splitElt+splitDist, splitDist/2, treeNode*2+1, buildForDither, pal);
+    }
 }
 
 // Finds all pixels that have changed from the previous image and
@@ -349,7 +362,7 @@ int GifPickChangedPixels( const uint8_t* lastFrame, uint8_t* frame, int numPixel
 
 // Creates a palette by placing all the image pixels in a k-d tree and then averaging the blocks at the bottom.
 // This is known as the "modified median split" technique
-void GifMakePalette( const uint8_t* lastFrame, const uint8_t* nextFrame, uint32_t width, uint32_t height, int bitDepth, bool buildForDither, GifPalette* pPal )
+void GifMakePalette( const uint8_t* lastFrame, const uint8_t* nextFrame, uint32_t width, uint32_t height, int bitDepth, bool buildForDither, GifPalette* pPal, int parallelLevels = 0 )
 {
     pPal->bitDepth = bitDepth;
 
@@ -367,7 +380,7 @@ void GifMakePalette( const uint8_t* lastFrame, const uint8_t* nextFrame, uint32_
     const int splitElt = lastElt/2;
     const int splitDist = splitElt/2;
 
-    GifSplitPalette(destroyableImage, numPixels, 1, lastElt, splitElt, splitDist, 1, buildForDither, pPal);
+    GifSplitPalette(destroyableImage, numPixels, 1, lastElt, splitElt, splitDist, 1, buildForDither, pPal, parallelLevels);
 
     GIF_TEMP_FREE(destroyableImage);
 
@@ -526,6 +539,63 @@ void GifThresholdImage( const uint8_t* lastFrame, const uint8_t* nextFrame, uint
     }
 }
 
+// Thresholds rows [top, bottom) of the image, split into bands processed by separate threads
+void GifThresholdImageParallel( const uint8_t* lastFrame, const uint8_t* nextFrame, uint8_t* outFrame, uint32_t width, uint32_t top, uint32_t bottom, GifPalette* pPal, int threadCount )
+{
+    uint32_t rowCount = bottom - top;
+    uint32_t bandCount = (uint32_t)GifIMax(1, GifIMin(threadCount, (int)(rowCount / 16)));
+    uint32_t rowsPerBand = (rowCount + bandCount - 1) / bandCount;
+
+    std::vector<std::thread> workers;
+    for(uint32_t band = 0; band < bandCount; band++)
+    {
+        uint32_t start = top + band * rowsPerBand;
+        uint32_t end = (uint32_t)GifIMin((int)bottom, (int)(start + rowsPerBand));
+        if(start >= end)
+            break;
+
+        size_t offset = (size_t)start * width * 4;
+        const uint8_t* bandLastFrame = lastFrame ? lastFrame + offset : NULL;
+        if(band == bandCount - 1)
+            GifThresholdImage(bandLastFrame, nextFrame + offset, outFrame + offset, width, end - start, pPal);
+        else
+            workers.emplace_back(GifThresholdImage, bandLastFrame, nextFrame + offset, outFrame + offset, width, end - start, pPal);
+    }
+
+    for(std::thread& worker : workers)
+        worker.join();
+}
+
+// Finds the smallest rectangle that contains all the pixels that changed since the last frame
+// Returns false if the frame is identical to the last one
+bool GifGetChangedArea( const uint8_t* lastFrame, const uint8_t* nextFrame, uint32_t width, uint32_t height, uint32_t& left, uint32_t& top, uint32_t& right, uint32_t& bottom )
+{
+    left = width;
+    top = height;
+    right = 0;
+    bottom = 0;
+
+    for(uint32_t yy=0; yy<height; ++yy)
+    {
+        const uint8_t* lastRow = lastFrame + (size_t)yy * width * 4;
+        const uint8_t* nextRow = nextFrame + (size_t)yy * width * 4;
+        for(uint32_t xx=0; xx<width; ++xx)
+        {
+            if(lastRow[xx*4+0] != nextRow[xx*4+0] ||
+               lastRow[xx*4+1] != nextRow[xx*4+1] ||
+               lastRow[xx*4+2] != nextRow[xx*4+2])
+            {
+                if(xx < left) left = xx;
+                if(xx >= right) right = xx + 1;
+                if(yy < top) top = yy;
+                bottom = yy + 1;
+            }
+        }
+    }
+
+    return right > left;
+}
+
 // Simple structure to write out the LZW-compressed portion of the image
 // one bit at a time
 struct GifBitStatus
@@ -607,7 +677,8 @@ void GifWritePalette( const GifPalette* pPal, FILE* f )
 }
 
 // write the image header, LZW-compress and write out the image
-void GifWriteLzwImage(FILE* f, uint8_t* image, uint32_t left, uint32_t top,  uint32_t width, uint32_t height, uint32_t delay, GifPalette* pPal)
+// (left, top, width, height) is the area of the image (of size imageWidth * any height) to write
+void GifWriteLzwImage(FILE* f, uint8_t* image, uint32_t imageWidth, uint32_t left, uint32_t top,  uint32_t width, uint32_t height, uint32_t delay, GifPalette* pPal)
 {
     // graphics control extension
     fputc(0x21, f);
@@ -660,13 +731,8 @@ void GifWriteLzwImage(FILE* f, uint8_t* image, uint32_t left, uint32_t top,  uin
     {
         for(uint32_t xx=0; xx<width; ++xx)
         {
-    #ifdef GIF_FLIP_VERT
-            // bottom-left origin image (such as an OpenGL capture)
-            uint8_t nextValue = image[((height-1-yy)*width+xx)*4+3];
-    #else
             // top-left origin
-            uint8_t nextValue = image[(yy*width+xx)*4+3];
-    #endif
+            uint8_t nextValue = image[((top+yy)*imageWidth+left+xx)*4+3];
 
             // "loser mode" - no compression, every single code is followed immediately by a clear
             //WriteCode( f, stat, nextValue, codeSize );
@@ -730,6 +796,8 @@ struct GifWriter
     FILE* f;
     uint8_t* oldImage;
     bool firstFrame;
+    int threadCount;
+    int parallelLevels;
 };
 
 // Creates a gif file.
@@ -748,6 +816,10 @@ bool GifBegin( GifWriter* writer, const char* filename, uint32_t width, uint32_t
 
     writer->firstFrame = true;
 
+    // Use up to 8 threads for quantization, and build the first levels of the palette tree in parallel
+    writer->threadCount = GifIMax(1, GifIMin(8, (int)std::thread::hardware_concurrency()));
+    writer->parallelLevels = writer->threadCount >= 4 ? 2 : (writer->threadCount >= 2 ? 1 : 0);
+
     // allocate
     writer->oldImage = (uint8_t*)GIF_MALLOC(width*height*4);
 
@@ -803,15 +875,28 @@ bool GifWriteFrame( GifWriter* writer, const uint8_t* image, uint32_t width, uin
     const uint8_t* oldImage = writer->firstFrame? NULL : writer->oldImage;
     writer->firstFrame = false;
 
+    // Pixels that did not change are transparent, so only the area around the changed pixels needs
+    // to be quantized and written - the rest of the previous frame is left in place
+    uint32_t left = 0, top = 0, right = width, bottom = height;
+    if(oldImage && !dither)
+    {
+        if(!GifGetChangedArea(oldImage, image, width, height, left, top, right, bottom))
+        {
+            // nothing changed, write a single transparent pixel to keep the frame's timing
+            left = top = 0;
+            right = bottom = 1;
+        }
+    }
+
     GifPalette pal;
-    GifMakePalette((dither? NULL : oldImage), image, width, height, bitDepth, dither, &pal);
+    GifMakePalette((dither? NULL : oldImage), image, width, height, bitDepth, dither, &pal, writer->parallelLevels);
 
     if(dither)
         GifDitherImage(oldImage, image, writer->oldImage, width, height, &pal);
     else
-        GifThresholdImage(oldImage, image, writer->oldImage, width, height, &pal);
+        GifThresholdImageParallel(oldImage, image, writer->oldImage, width, top, bottom, &pal, writer->threadCount);
 
-    GifWriteLzwImage(writer->f, writer->oldImage, 0, 0, width, height, delay, &pal);
+    GifWriteLzwImage(writer->f, writer->oldImage, width, left, top, right - left, bottom - top, delay, &pal);
 
     return true;
 }
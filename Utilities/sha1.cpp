@@ -19,9 +19,11 @@
 
 #include "stdafx.h"
 #include "sha1.h"
+#include "CpuFeatures.h"
 #include <sstream>
 #include <iomanip>
 #include <fstream>
+#include <algorithm>
 
 
 static const size_t BLOCK_INTS = 16;  /* number of 32bit integers per SHA1 block */
@@ -205,6 +207,66 @@ static void transform(uint32_t digest[], uint32_t block[BLOCK_INTS], uint64_t &t
 }
 
 
+#ifdef HAS_X86_INTRINSICS
+/*
+ * Hash [blockCount] 512-bit blocks using the SHA extensions (each sha1rnds4 instruction performs 4 rounds)
+ */
+
+#define SHANI_ROUNDS(k, func) \
+	if(k >= 4) { \
+		/* w[k&3] contains W[k-4], replace it by W[k] */ \
+		w[k & 3] = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(w[k & 3], w[(k + 1) & 3]), w[(k + 2) & 3]), w[(k + 3) & 3]); \
+	} \
+	e = _mm_sha1nexte_epu32(prev, w[k & 3]); \
+	prev = abcd; \
+	abcd = _mm_sha1rnds4_epu32(abcd, e, func);
+
+CPU_TARGET("sha,ssse3,sse4.1")
+static void transform_shani(uint32_t digest[], const uint8_t *data, size_t blockCount)
+{
+	const __m128i byteSwap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+	__m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)digest), 0x1B);
+	__m128i e0 = _mm_set_epi32((int)digest[4], 0, 0, 0);
+
+	for(; blockCount > 0; blockCount--, data += BLOCK_BYTES) {
+		__m128i abcdSave = abcd;
+		__m128i e0Save = e0;
+
+		__m128i w[4];
+		for(int i = 0; i < 4; i++) {
+			w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 16)), byteSwap);
+		}
+
+		__m128i e = _mm_add_epi32(e0, w[0]);
+		__m128i prev = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e, 0);
+		SHANI_ROUNDS(1, 0) SHANI_ROUNDS(2, 0) SHANI_ROUNDS(3, 0) SHANI_ROUNDS(4, 0)
+		SHANI_ROUNDS(5, 1) SHANI_ROUNDS(6, 1) SHANI_ROUNDS(7, 1) SHANI_ROUNDS(8, 1) SHANI_ROUNDS(9, 1)
+		SHANI_ROUNDS(10, 2) SHANI_ROUNDS(11, 2) SHANI_ROUNDS(12, 2) SHANI_ROUNDS(13, 2) SHANI_ROUNDS(14, 2)
+		SHANI_ROUNDS(15, 3) SHANI_ROUNDS(16, 3) SHANI_ROUNDS(17, 3) SHANI_ROUNDS(18, 3) SHANI_ROUNDS(19, 3)
+
+		e0 = _mm_sha1nexte_epu32(prev, e0Save);
+		abcd = _mm_add_epi32(abcd, abcdSave);
+	}
+
+	_mm_storeu_si128((__m128i*)digest, _mm_shuffle_epi32(abcd, 0x1B));
+	digest[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+#endif
+
+
+static void data_to_block(const uint8_t *data, uint32_t block[BLOCK_INTS])
+{
+	/* Convert the byte buffer to a uint32_t array (MSB) */
+	for(size_t i = 0; i < BLOCK_INTS; i++) {
+		block[i] = data[4 * i + 3]
+			| data[4 * i + 2] << 8
+			| data[4 * i + 1] << 16
+			| (uint32_t)data[4 * i + 0] << 24;
+	}
+}
+
+
 static void buffer_to_block(const std::string &buffer, uint32_t block[BLOCK_INTS])
 {
 	/* Convert the std::string (byte buffer) to a uint32_t array (MSB) */
@@ -249,6 +311,45 @@ void SHA1::update(std::istream &is)
 }
 
 
+void SHA1::update(const uint8_t *data, size_t length)
+{
+	/* Same as update(istream), but reads the blocks directly from memory */
+	uint32_t block[BLOCK_INTS];
+
+	if(!buffer.empty()) {
+		size_t count = std::min(length, BLOCK_BYTES - buffer.size());
+		buffer.append((const char*)data, count);
+		data += count;
+		length -= count;
+		if(buffer.size() != BLOCK_BYTES) {
+			return;
+		}
+		buffer_to_block(buffer, block);
+		transform(digest, block, transforms);
+		buffer.clear();
+	}
+
+	size_t blockCount = length / BLOCK_BYTES;
+#ifdef HAS_X86_INTRINSICS
+	if(blockCount > 0 && CpuFeatures::HasSha()) {
+		transform_shani(digest, data, blockCount);
+		transforms += blockCount;
+		data += blockCount * BLOCK_BYTES;
+		length -= blockCount * BLOCK_BYTES;
+		blockCount = 0;
+	}
+#endif
+	for(; blockCount > 0; blockCount--) {
+		data_to_block(data, block);
+		transform(digest, block, transforms);
+		data += BLOCK_BYTES;
+		length -= BLOCK_BYTES;
+	}
+
+	buffer.append((const char*)data, length);
+}
+
+
 /*
  * Add padding and return the message digest.
  */
@@ -295,11 +396,8 @@ std::string SHA1::final()
 
 std::string SHA1::GetHash(vector<uint8_t> &data)
 {
-	std::stringstream ss;
-	ss.write((char*)data.data(), data.size());
-	
 	SHA1 checksum;
-	checksum.update(ss);
+	checksum.update(data.data(), data.size());
 	return checksum.final();
 }
 
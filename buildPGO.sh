@@ -6,6 +6,8 @@
 #
 # Rom files must be copied to the PGOHelper/PGOGames folder beforehand - all *.nes files in that folder will be executed as part of the profiling process.
 # Using a variety of roms is recommended (e.g different mappers, etc.)
+# Each rom is run for a fixed number of frames in every benchmark mode (core, debugger, HD pack, run-ahead, video filters) - the results are printed as JSON.
+# The same benchmark can be run on a regular build to compare performance between builds: ./pgohelper [romFolder] [-frames N] [-modes core,filter:ntsc,...] [-output results.json]
 #
 # You can run this script via make:
 #   For clang, run "make pgo" 